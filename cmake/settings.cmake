@@ -83,6 +83,16 @@ if(Ant_MARCH)
     set(CMAKE_CXX_FLAGS_RELEASE "${CMAKE_CXX_FLAGS_RELEASE} -march=native")
 endif()
 
+# VLOG statements above this level are removed at compile time,
+# keep the per-event debug output (levels 7..9) only in debug builds by default
+if(CMAKE_BUILD_TYPE STREQUAL "Debug")
+  set(_default_max_vlog_level 9)
+else()
+  set(_default_max_vlog_level 6)
+endif()
+set(Ant_MAX_VLOG_LEVEL ${_default_max_vlog_level} CACHE STRING "Maximum verbosity level of VLOG compiled in (0..9)")
+add_definitions(-DANT_MAX_VLOG_LEVEL=${Ant_MAX_VLOG_LEVEL})
+
 string(TOUPPER ${CMAKE_BUILD_TYPE} BUILD_TYPE)
 set(DEFAULT_COMPILE_FLAGS ${CMAKE_CXX_FLAGS_${BUILD_TYPE}})
 
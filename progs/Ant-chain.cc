@@ -4,29 +4,50 @@
   *
   *        Creates a TChain in the output file for each TTree found in the first input file
   *        and uses AddFile() to add each input file to each TChain.
+  *        Optionally, histograms are drawn from one of the chains, or Plotter classes are run
+  *        over the chains, in parallel processes (each reading a part of the files)
+  *        and merged into the output file.
   */
 
 //Ant
 #include "base/Logger.h"
 #include "tclap/CmdLine.h"
+#include "tclap/ValuesConstraintExtra.h"
 #include "base/WrapTFile.h"
 #include "base/std_ext/string.h"
 #include "base/std_ext/system.h"
 #include "base/std_ext/memory.h"
+#include "base/BinSettings.h"
+#include "base/OptionsList.h"
+#include "base/std_ext/misc.h"
+#include "analysis/physics/Plotter.h"
+#include "expconfig/ExpConfig.h"
 #include "tree/TAntHeader.h"
+#include "root-addons/analysis_codes/TreeTools.h"
+#include "root-addons/analysis_codes/hadd.h"
 
 //ROOT
 #include "TDirectory.h"
 #include "TChain.h"
 #include "TTree.h"
+#include "TFile.h"
+#include "TCut.h"
 
 //stl
 #include <string>
 #include <list>
 #include <functional>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <set>
+
+#include <unistd.h>
+#include <sys/wait.h>
 
 using namespace std;
 using namespace ant;
+using namespace ant::analysis;
 
 template<typename T>
 string get_path(T* dir) {
@@ -66,6 +87,186 @@ struct FileInfo_t {
 
 };
 
+struct DrawSpec_t {
+    std::string Name;
+    std::string Formula;
+    std::vector<BinSettings> Bins;
+    std::string Cut;
+
+    // parses "name;formula;bins[;bins...][;cut]", with bins like "(100,[0:1000])" for each dimension of the formula
+    explicit DrawSpec_t(const string& spec) {
+        const auto parts = std_ext::tokenize_string(spec, ";");
+        if(parts.size()<3)
+            throw runtime_error("Expected at least name;formula;bins in '" + spec + "'");
+        Name = parts[0];
+        Formula = parts[1];
+        const auto ndim = TreeDrawer::SplitFormula(Formula).size();
+        if(ndim<1 || ndim>3 || parts.size()<2+ndim)
+            throw runtime_error(std_ext::formatter() << "Expected 1 to 3 dimensions and bins for each of them in '" << spec << "'");
+        for(auto i=2u;i<2+ndim;i++) {
+            istringstream ss(parts[i]);
+            BinSettings bins(0);
+            if(!(ss >> bins) || bins.Bins()==0)
+                throw runtime_error("Cannot parse bins '" + parts[i] + "' in '" + spec + "'");
+            Bins.emplace_back(bins);
+        }
+        // the cut might contain ; as well
+        Cut = std_ext::concatenate_string(vector<string>(parts.begin()+2+ndim, parts.end()), ";");
+    }
+
+    void AddTo(TreeDrawer& drawer) const {
+        const TCut cut(Cut.c_str());
+        if(Bins.size()==1)
+            drawer.Add(Formula, cut, Formula, "", Bins[0], Name);
+        else if(Bins.size()==2)
+            drawer.Add(Formula, cut, "", "", Bins[0], Bins[1], Name);
+        else
+            drawer.Add(Formula, cut, Bins[0], Bins[1], Bins[2], Name);
+    }
+};
+
+// draws the histograms into the current directory
+long long draw(TTree* tree, const vector<DrawSpec_t>& specs, unsigned threads) {
+    TreeDrawer drawer(tree);
+    for(const auto& spec : specs)
+        spec.AddTo(drawer);
+    return drawer.Run(threads);
+}
+
+// runs the plotters over the given files, like Ant-plot, and returns the number of processed entries
+// the plotters read the chains from a temporary file, which looks like the output of Ant-chain
+long long plot(const vector<string>& files, const set<string>& treenames, const TAntHeader* header,
+               const vector<string>& plotternames, const vector<string>& options,
+               const string& chainfilename) {
+    // plotters create their histograms in the current directory
+    TDirectory* outdir = gDirectory;
+    {
+        TFile chainfile(chainfilename.c_str(), "RECREATE");
+        for(const auto& name : treenames) {
+            TChain chain(name.c_str());
+            for(const auto& file : files)
+                chain.AddFile(file.c_str());
+            chainfile.WriteTObject(addressof(chain));
+        }
+        if(header)
+            chainfile.WriteTObject(header);
+    }
+    std_ext::execute_on_destroy remove_chainfile([&chainfilename] () {
+        remove(chainfilename.c_str());
+    });
+    WrapTFileInput input(chainfilename);
+    outdir->cd();
+
+    auto popts = make_shared<OptionsList>();
+    for(const auto& opt : options)
+        popts->SetOption(opt);
+
+    vector<unique_ptr<Plotter>> plotters;
+    vector<long long> nEntries;
+    for(const auto& name : plotternames) {
+        plotters.emplace_back(PlotterRegistry::Create(name, input, popts));
+        nEntries.push_back(plotters.back()->GetNumEntries());
+    }
+
+    const auto unused_popts = popts->GetUnused();
+    if(!unused_popts.empty())
+        throw runtime_error("Plotter options not recognized: " +
+                            std_ext::concatenate_string(vector<string>(unused_popts.begin(), unused_popts.end()), ", "));
+
+    const auto maxEntries = nEntries.empty() ? 0 : *max_element(nEntries.begin(), nEntries.end());
+    for(long long entry=0;entry<maxEntries;entry++) {
+        for(auto i=0u;i<plotters.size();i++)
+            if(entry<nEntries[i])
+                plotters[i]->ProcessEntry(entry);
+    }
+
+    for(auto& plotter : plotters)
+        plotter->Finish();
+    outdir->cd();
+    return maxEntries;
+}
+
+string part_filename(const string& outputfile, unsigned part) {
+    return std_ext::formatter() << outputfile << "_part" << part << ".root";
+}
+
+string chain_filename(const string& outputfile, unsigned part) {
+    return std_ext::formatter() << outputfile << "_chain" << part << ".root";
+}
+
+// job run by each worker on its part of the files, creating its output in the current directory,
+// returns the number of entries read
+using job_t = function<long long(unsigned part, const vector<string>& files)>;
+
+// forks workers each running the job on a part of the files,
+// and merges their outputs into the current directory
+bool run_parallel(const vector<string>& files, unsigned nWorkers, const string& outputfile, const job_t& job) {
+
+    nWorkers = std::min<unsigned>(nWorkers, files.size());
+
+    vector<pid_t> workers;
+    for(unsigned part=0;part<nWorkers;part++) {
+        const pid_t pid = fork();
+        if(pid < 0) {
+            LOG(ERROR) << "Cannot start worker process for part " << part << ": " << strerror(errno);
+            break;
+        }
+        if(pid == 0) {
+            // worker: files are distributed round-robin
+            int status = EXIT_SUCCESS;
+            try {
+                vector<string> partfiles;
+                for(auto i=part;i<files.size();i+=nWorkers)
+                    partfiles.emplace_back(files[i]);
+                TFile partfile(part_filename(outputfile, part).c_str(), "RECREATE");
+                const auto entries = job(part, partfiles);
+                partfile.Write();
+                LOG(INFO) << "Part " << part << " read " << entries << " entries";
+            }
+            catch(const exception& e) {
+                LOG(ERROR) << "Part " << part << " failed: " << e.what();
+                status = EXIT_FAILURE;
+            }
+            // do not run any cleanup of the parent, in particular not writing its output file
+            _exit(status);
+        }
+        workers.push_back(pid);
+    }
+
+    bool success = workers.size() == nWorkers;
+    for(unsigned part=0;part<workers.size();part++) {
+        int status = 0;
+        while(waitpid(workers[part], addressof(status), 0) < 0 && errno == EINTR);
+        if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            LOG(ERROR) << "Worker process for part " << part << " failed";
+            success = false;
+        }
+    }
+
+    if(success) {
+        TDirectory* target = gDirectory;
+        hadd::sources_t sources;
+        for(unsigned part=0;part<nWorkers;part++) {
+            auto file = std_ext::make_unique<TFile>(part_filename(outputfile, part).c_str(), "READ");
+            if(file->IsZombie()) {
+                LOG(ERROR) << "Cannot open output of part " << part << ": " << file->GetName();
+                success = false;
+                break;
+            }
+            sources.emplace_back(move(file));
+        }
+        if(success) {
+            unsigned nPaths = 0;
+            hadd::MergeRecursive(*target, sources, nPaths);
+        }
+        target->cd();
+    }
+
+    for(unsigned part=0;part<workers.size();part++)
+        remove(part_filename(outputfile, part).c_str());
+
+    return success;
+}
 
 int main(int argc, char** argv) {
     SetupLogger();
@@ -74,7 +275,15 @@ int main(int argc, char** argv) {
     auto cmd_verbose = cmd.add<TCLAP::ValueArg<int>>("v","verbose","Verbosity level (0..9)", false, 0,"level");
     auto cmd_output     = cmd.add<TCLAP::ValueArg<string>>("o","output","Output file",true,"","filename");
     auto cmd_writemacro = cmd.add<TCLAP::SwitchArg>("","writemacro","Write a template macro file for opening",false);
-    auto cmd_proofworkers  = cmd.add<TCLAP::ValueArg<unsigned>>("","proofworkers","Macro: Specify number of workers for PROOF, =0 disables it.",false,8,"n");
+    auto cmd_imt  = cmd.add<TCLAP::ValueArg<unsigned>>("","imt","Macro/Draw: Enable implicit multi-threading of ROOT with given number of threads, =0 disables it.",false,0,"n");
+    auto cmd_draw = cmd.add<TCLAP::MultiArg<string>>("d","draw","Draw histogram from chain: name;formula;bins[;bins...][;cut], with bins like (100,[0:1000])",false,"spec");
+    auto cmd_drawtree = cmd.add<TCLAP::ValueArg<string>>("","drawtree","Draw: Name of the chain to draw from, can be omitted if only one chain is created",false,"","name");
+    TCLAP::ValuesConstraintExtra<decltype(analysis::PlotterRegistry::GetList())> allowedPlotters(analysis::PlotterRegistry::GetList());
+    auto cmd_plotters = cmd.add<TCLAP::MultiArg<string>>("p","Plotter","Plotter classes to run over the chains, as Ant-plot does",false,&allowedPlotters);
+    auto cmd_options = cmd.add<TCLAP::MultiArg<string>>("O","options","Plotter: Options for all plotter classes, key=value",false,"");
+    TCLAP::ValuesConstraintExtra<decltype(ExpConfig::Setup::GetNames())> allowedsetupnames(ExpConfig::Setup::GetNames());
+    auto cmd_setup  = cmd.add<TCLAP::ValueArg<string>>("s","setup","Plotter: Choose setup manually by name, otherwise taken from AntHeader",false,"", &allowedsetupnames);
+    auto cmd_workers = cmd.add<TCLAP::ValueArg<unsigned>>("j","workers","Draw/Plotter: Number of parallel processes, each reading a part of the files",false,1,"n");
     auto cmd_includetreeevents  = cmd.add<TCLAP::SwitchArg>("","includetreeevents","Include the ubiquitious treeEvents",false);
     auto cmd_checkentries = cmd.add<TCLAP::SwitchArg>("","checkentries","Check the total entries of tree (might be slow)",false);
     // unlabeled multi arg must be the last element added, and interprets everything as a input file
@@ -125,9 +334,11 @@ int main(int argc, char** argv) {
         gDirectory->Add(fileInfo.AntHeader);
     }
 
+    vector<string> absFiles;
     for(const auto& file : inputs) {
+        absFiles.emplace_back(std_ext::system::absolutePath(file));
+        const auto& absFile = absFiles.back();
         for(auto chain : chains) {
-            const auto absFile = std_ext::system::absolutePath(file);
             const auto res = chain->AddFile(absFile.c_str());
             if(res != 1) {
                 LOG(WARNING) << "Problem with " << chain->GetName() << " and file " << file << " (" << res << ")";
@@ -143,8 +354,8 @@ int main(int argc, char** argv) {
         macrofile->open(macrofilename);
         *macrofile << "{" << endl;
         *macrofile << "TFile* myfile = TFile::Open(\"" << outfilename << "\");" << endl;
-        if(cmd_proofworkers->getValue()>0)
-            *macrofile << "TProof::Open(\"workers=" << cmd_proofworkers->getValue() << "\");" << endl;
+        if(cmd_imt->getValue()>0)
+            *macrofile << "ROOT::EnableImplicitMT(" << cmd_imt->getValue() << ");" << endl;
     }
 
     unsigned n = 0;
@@ -159,9 +370,6 @@ int main(int argc, char** argv) {
                 chainname += to_string(n);
             *macrofile << "TChain* " << chainname << " = myfile->GetKey(\""
                        << chain->GetName() <<  "\")->ReadObj();" << endl;
-            if(cmd_proofworkers->getValue()>0)
-                *macrofile << chainname << "->SetProof();" << endl;
-
         }
         n++;
     }
@@ -174,5 +382,100 @@ int main(int argc, char** argv) {
 
     LOG(INFO) << "Created " << n << " chains with " << inputs.size() << " files";
 
+    if(cmd_draw->isSet()) {
+        TChain* drawchain = nullptr;
+        if(cmd_drawtree->isSet()) {
+            for(auto chain : chains)
+                if(chain->GetName() == cmd_drawtree->getValue())
+                    drawchain = chain;
+        }
+        else if(chains.size() == 1) {
+            drawchain = chains.front();
+        }
+        if(!drawchain) {
+            LOG(ERROR) << "Please specify one of the created chains to draw from with " << cmd_drawtree->longID();
+            return EXIT_FAILURE;
+        }
+
+        vector<DrawSpec_t> specs;
+        try {
+            for(const auto& spec : cmd_draw->getValue())
+                specs.emplace_back(spec);
+        }
+        catch(const exception& e) {
+            LOG(ERROR) << "Cannot parse draw option: " << e.what();
+            return EXIT_FAILURE;
+        }
+
+        // histograms end up in the output file
+        outfile.cd();
+        if(cmd_workers->getValue()>1) {
+            const string treename = drawchain->GetName();
+            LOG(INFO) << "Drawing " << specs.size() << " histograms from chain " << treename << " in parallel processes";
+            const auto job = [&treename, &specs] (unsigned, const vector<string>& files) {
+                TChain chain(treename.c_str());
+                for(const auto& file : files)
+                    chain.AddFile(file.c_str());
+                return draw(addressof(chain), specs, 0);
+            };
+            if(!run_parallel(absFiles, cmd_workers->getValue(), outfilename, job))
+                return EXIT_FAILURE;
+        }
+        else {
+            try {
+                const auto entries = draw(drawchain, specs, cmd_imt->getValue());
+                LOG(INFO) << "Read " << entries << " entries";
+            }
+            catch(const exception& e) {
+                LOG(ERROR) << "Drawing failed: " << e.what();
+                return EXIT_FAILURE;
+            }
+        }
+        LOG(INFO) << "Drew " << specs.size() << " histograms into " << outfilename;
+    }
+
+    if(cmd_plotters->isSet()) {
+        // plotters might need the setup
+        if(cmd_setup->isSet()) {
+            ExpConfig::Setup::SetByName(cmd_setup->getValue());
+            LOG(INFO) << "Commandline override setup name to '" << cmd_setup->getValue() << "'";
+        }
+        else if(fileInfo.AntHeader && !fileInfo.AntHeader->SetupName.empty()) {
+            ExpConfig::Setup::SetByName(fileInfo.AntHeader->SetupName);
+            LOG(INFO) << "Setup name set to '" << fileInfo.AntHeader->SetupName << "' from input file";
+        }
+
+        set<string> treenames;
+        for(auto chain : chains)
+            treenames.insert(chain->GetName());
+        const auto& plotternames = cmd_plotters->getValue();
+        const auto& options = cmd_options->getValue();
+        const auto header = fileInfo.AntHeader;
+
+        // histograms end up in the output file
+        outfile.cd();
+        if(cmd_workers->getValue()>1) {
+            LOG(INFO) << "Running " << plotternames.size() << " plotters in parallel processes";
+            const auto job = [&] (unsigned part, const vector<string>& files) {
+                return plot(files, treenames, header, plotternames, options,
+                            chain_filename(outfilename, part));
+            };
+            if(!run_parallel(absFiles, cmd_workers->getValue(), outfilename, job))
+                return EXIT_FAILURE;
+        }
+        else {
+            try {
+                const auto entries = plot(absFiles, treenames, header, plotternames, options,
+                                          chain_filename(outfilename, 0));
+                LOG(INFO) << "Read " << entries << " entries";
+            }
+            catch(const exception& e) {
+                LOG(ERROR) << "Plotting failed: " << e.what();
+                return EXIT_FAILURE;
+            }
+        }
+        LOG(INFO) << "Ran " << plotternames.size() << " plotters into " << outfilename;
+    }
+
     return EXIT_SUCCESS;
 }
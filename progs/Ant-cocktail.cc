@@ -2,6 +2,7 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <chrono>
 
 
 #include "mc/pluto/PlutoGenerator.h"
@@ -107,7 +108,11 @@ int main( int argc, char** argv )
                           cmd_flatEbeam->getValue() ? "1.0" : "1.0 / x",
                           selector);
 
+        const auto start = chrono::steady_clock::now();
         auto nErrors = cocktail.Sample(cmd_numEvents->getValue());
+        const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        LOG(INFO) << "Generated " << cmd_numEvents->getValue() << " events with "
+                  << cmd_numEvents->getValue()/elapsed.count() << " events/s";
 
         if(nErrors>0)
             LOG(WARNING) << "Events with error: " <<  nErrors;
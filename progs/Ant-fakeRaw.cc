@@ -152,13 +152,11 @@ int main(int argc, char** argv) {
                     continue;
                 }
                 // handle multihits
-                auto nHits = readhit.RawData.size()/sizeof(uint16_t);
-                for(unsigned i=0;i<nHits;i++) {
-                    auto ptr = reinterpret_cast<const uint16_t*>(readhit.RawData.data())+i;
+                for(const uint16_t rawVal : readhit.RawData) {
                     eventbuffer.emplace_back();
                     auto acquhit = reinterpret_cast<acqu::AcquBlock_t*>(addressof(eventbuffer.back()));
                     acquhit->id = rawchannel.RawChannel;
-                    acquhit->adc = *ptr;
+                    acquhit->adc = rawVal;
                 }
             }
 
@@ -17,6 +17,8 @@
 #include <list>
 #include <string>
 #include <map>
+#include <vector>
+#include <algorithm>
 
 using namespace std;
 using namespace ant;
@@ -88,6 +90,8 @@ int main( int argc, char **argv )
    TCLAP::CmdLine cmd("Ant-hadd - Merge ROOT objects in files", ' ', "0.1");
    auto cmd_verbose = cmd.add<TCLAP::ValueArg<int>>("v","verbose","Verbosity level (0..9)", false, 0,"int");
    auto cmd_nativemode = cmd.add<TCLAP::MultiSwitchArg>("","native","Run native TFileMerger, is slow on large trees",false);
+   auto cmd_maxopen = cmd.add<TCLAP::ValueArg<unsigned>>("n","maxopen","Open at most that many input files at once, merge in groups via temporary files",false,0,"files");
+   auto cmd_workers = cmd.add<TCLAP::ValueArg<unsigned>>("j","workers","Number of processes merging the groups in parallel",false,1,"workers");
    auto cmd_filenames  = cmd.add<TCLAP::UnlabeledMultiArg<string>>("files","ROOT files, first one is output",true,"ROOT files");
    cmd.parse(argc, argv);
    if(cmd_verbose->isSet()) {
@@ -119,10 +123,6 @@ int main( int argc, char **argv )
    }
 
    auto outputfile = std_ext::make_unique<TFile>(outputfilename.c_str(), "RECREATE");
-   hadd::sources_t sources;
-   for(const auto& filename : filenames) {
-       sources.emplace_back(std_ext::make_unique<TFile>(filename.c_str(), "READ"));
-   }
 
    // progress updates only when running interactively
    if(std_ext::system::isInteractive())
@@ -134,7 +134,25 @@ int main( int argc, char **argv )
        nPaths = 0;
    });
 
-   hadd::MergeRecursive(*outputfile, sources, nPaths);
+   if(cmd_maxopen->isSet() || cmd_workers->getValue() > 1) {
+       // without an explicit limit, merge in as many groups as there are workers
+       const unsigned nWorkers = std::max(cmd_workers->getValue(), 1u);
+       const unsigned maxOpen = cmd_maxopen->isSet() ?
+                                    cmd_maxopen->getValue() :
+                                    std::max<unsigned>((filenames.size() + nWorkers - 1)/nWorkers, 2);
+       if(maxOpen < 2) {
+           LOG(ERROR) << "Need to open at least two files at once";
+           exit(EXIT_FAILURE);
+       }
+       hadd::MergeFiles(*outputfile, vector<string>(filenames.begin(), filenames.end()), nPaths, maxOpen, nWorkers);
+   }
+   else {
+       hadd::sources_t sources;
+       for(const auto& filename : filenames) {
+           sources.emplace_back(std_ext::make_unique<TFile>(filename.c_str(), "READ"));
+       }
+       hadd::MergeRecursive(*outputfile, sources, nPaths);
+   }
 
    LOG(INFO) << "Finished, writing file " << outputfile->GetName();
 
@@ -155,14 +155,9 @@ int main(int argc, char** argv) {
         ADC_index->resize(0);
         ADC_value->resize(0);
         for(const TDetectorReadHit& readhit : recon.DetectorReadHits) {
-            // assume raw data to be 16bit chunks
-            const auto& rawData = readhit.RawData;
-            if(rawData.size() % 2 != 0)
-                continue;
-            for(size_t i=0;i<rawData.size()/2;i++) {
-                const uint16_t* rawVal = reinterpret_cast<const uint16_t*>(addressof(rawData[2*i]));
+            for(const uint16_t rawVal : readhit.RawData) {
                 ADC_index->push_back(readhit.Channel);
-                ADC_value->push_back(*rawVal);
+                ADC_value->push_back(rawVal);
             }
         }
 
@@ -6,6 +6,7 @@
 
 #include "analysis/input/DataReader.h"
 #include "analysis/input/ant/AntReader.h"
+#include "analysis/input/ant/ReconstructCache.h"
 #include "analysis/input/goat/GoatReader.h"
 #include "analysis/input/pluto/PlutoReader.h"
 #include "analysis/utils/ParticleID.h"
@@ -18,12 +19,15 @@
 #include "calibration/DataBase.h"
 
 #include "unpacker/Unpacker.h"
+#include "unpacker/UnpackerAcqu.h"
 #include "unpacker/RawFileReader.h"
 
 #include "reconstruct/Reconstruct.h"
 
 #include "tree/TAntHeader.h"
 
+#include "root-addons/analysis_codes/hadd.h"
+
 #include "base/WrapTFile.h"
 #include "base/Logger.h"
 #include "tclap/CmdLine.h"
@@ -32,14 +36,28 @@
 #include "base/std_ext/system.h"
 #include "base/std_ext/container.h"
 #include "base/GitInfo.h"
+#include "base/Profiler.h"
 
 #include "TRint.h"
 #include "TSystem.h"
 #include "TROOT.h"
+#include "TTree.h"
+#include "TClass.h"
 
 #include <sstream>
 #include <string>
+#include <vector>
 #include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <iostream>
+#include <cerrno>
+#include <new>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/wait.h>
 
 using namespace std;
 using namespace ant;
@@ -47,6 +65,213 @@ using namespace ant;
 volatile bool interrupt = false;
 volatile bool terminated = false;
 
+// count allocations for the profiler (does nothing unless --profile is given),
+// the full set of global operators is replaced so that no variant bypasses the counting
+// or frees memory obtained from another allocator
+static void* counted_malloc(std::size_t size) noexcept {
+    Profiler::CountAllocation();
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(std::size_t size) {
+    if(void* p = counted_malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_malloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_malloc(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+#endif
+
+#ifdef __cpp_aligned_new
+static void* counted_aligned_malloc(std::size_t size, std::align_val_t alignment) noexcept {
+    Profiler::CountAllocation();
+    void* p = nullptr;
+    const auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+    if(posix_memalign(&p, align, size == 0 ? 1 : size) != 0)
+        return nullptr;
+    return p;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if(void* p = counted_aligned_malloc(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_aligned_malloc(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_aligned_malloc(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+#endif
+
+// output file written by the worker process of the given part, see --split
+string split_part_filename(const string& outputfile, unsigned part) {
+    const string ext = ".root";
+    const string suffix = std_ext::formatter() << "_part" << part;
+    if(std_ext::string_ends_with(outputfile, ext))
+        return outputfile.substr(0, outputfile.size()-ext.size()) + suffix + ext;
+    return outputfile + suffix;
+}
+
+bool contains_tree(TDirectory& dir) {
+    TIter nextk(dir.GetListOfKeys());
+    while(auto key = dynamic_cast<TKey*>(nextk())) {
+        auto cl = TClass::GetClass(key->GetClassName());
+        if(cl->InheritsFrom(TTree::Class()))
+            return true;
+        if(cl->InheritsFrom(TDirectory::Class())) {
+            auto subdir = dynamic_cast<TDirectory*>(key->ReadObj());
+            if(subdir && contains_tree(*subdir))
+                return true;
+        }
+    }
+    return false;
+}
+
+// runs this executable once per part with the same arguments,
+// and merges the outputs of the workers like Ant-hadd does
+int run_split(int argc, char** argv, unsigned nParts, const string& outputfile) {
+
+    LOG(INFO) << "Splitting input into " << nParts << " parts processed in parallel";
+
+    vector<pid_t> workers;
+    for(unsigned part=0;part<nParts;part++) {
+        vector<string> args(argv, argv+argc);
+        args.emplace_back("--split_part");
+        args.emplace_back(to_string(part));
+        args.emplace_back("--batch");
+
+        const pid_t pid = fork();
+        if(pid < 0) {
+            LOG(ERROR) << "Cannot start worker process for part " << part << ": " << strerror(errno);
+            break;
+        }
+        if(pid == 0) {
+            vector<char*> c_args;
+            for(auto& arg : args)
+                c_args.push_back(&arg[0]);
+            c_args.push_back(nullptr);
+            execvp(c_args.front(), c_args.data());
+            // only reached if exec failed
+            cerr << "Cannot execute " << c_args.front() << ": " << strerror(errno) << endl;
+            _exit(EXIT_FAILURE);
+        }
+        workers.push_back(pid);
+    }
+
+    bool success = workers.size() == nParts;
+    for(unsigned part=0;part<workers.size();part++) {
+        int status = 0;
+        while(waitpid(workers[part], addressof(status), 0) < 0 && errno == EINTR);
+        if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            LOG(ERROR) << "Worker process for part " << part << " failed";
+            success = false;
+        }
+    }
+
+    if(!success || terminated)
+        return EXIT_FAILURE;
+
+    // merge the parts, trees cannot be merged this way,
+    // so keep the parts then
+    bool keep_parts = false;
+    {
+        hadd::sources_t sources;
+        for(unsigned part=0;part<nParts;part++) {
+            auto file = std_ext::make_unique<TFile>(split_part_filename(outputfile, part).c_str(), "READ");
+            if(file->IsZombie()) {
+                LOG(ERROR) << "Cannot open output of part " << part << ": " << file->GetName();
+                return EXIT_FAILURE;
+            }
+            keep_parts |= contains_tree(*file);
+            sources.emplace_back(move(file));
+        }
+
+        TFile output(outputfile.c_str(), "RECREATE");
+        unsigned nPaths = 0;
+        hadd::MergeRecursive(output, sources, nPaths);
+        output.Write();
+    }
+
+    if(keep_parts) {
+        LOG(WARNING) << "Outputs of the parts contain trees, which are not merged. Keeping "
+                     << split_part_filename(outputfile, 0) << " etc.";
+    }
+    else {
+        for(unsigned part=0;part<nParts;part++)
+            remove(split_part_filename(outputfile, part).c_str());
+    }
+
+    LOG(INFO) << "Merged " << nParts << " parts into " << outputfile;
+    return EXIT_SUCCESS;
+}
+
 
 int main(int argc, char** argv) {
     SetupLogger();
@@ -90,11 +315,36 @@ int main(int argc, char** argv) {
     auto cmd_p_disableParticleID  = cmd.add<TCLAP::SwitchArg>("","p_disableParticleID","Physics: Disable ParticleID",false);
     auto cmd_p_simpleParticleID  = cmd.add<TCLAP::SwitchArg>("","p_simpleParticleID","Physics: Use simple ParticleID (just protons/photons)",false);
 
+    auto cmd_readcache = cmd.add<TCLAP::ValueArg<double>>("","readcache","Input: Size of tree read cache in MB for MC and GoAT input (Geant/Pluto/GoAT)",false,0,"MB");
+    auto cmd_prefetch = cmd.add<TCLAP::SwitchArg>("","prefetch","Input: Asynchronously prefetch tree baskets for MC and GoAT input",false);
+    auto cmd_imt = cmd.add<TCLAP::ValueArg<unsigned>>("","imt","Input: Decompress tree baskets of MC and GoAT input in given number of threads",false,0,"threads");
+    auto cmd_cache = cmd.add<TCLAP::ValueArg<string>>("","cache","Input: Keep reconstructed events of Acqu input in given directory and read them instead if calibration is unchanged",false,"","directory");
+
+    const vector<pair<string, analysis::input::GoatReader::collection_t>> goatCollections{
+        {"DetectorReadHits", analysis::input::GoatReader::collection_t::DetectorReadHits},
+        {"TaggerHits",       analysis::input::GoatReader::collection_t::TaggerHits},
+        {"Trigger",          analysis::input::GoatReader::collection_t::Trigger},
+        {"Candidates",       analysis::input::GoatReader::collection_t::Candidates},
+    };
+    vector<string> goatCollectionNames;
+    for(const auto& c : goatCollections)
+        goatCollectionNames.push_back(c.first);
+    TCLAP::ValuesConstraintExtra<decltype(goatCollectionNames)> allowedGoatCollections(goatCollectionNames);
+    auto cmd_goatskip = cmd.add<TCLAP::MultiArg<string>>("","goat_skip","Input: Do not read this part of the event from GoAT input",false,&allowedGoatCollections);
+
+    auto cmd_profile = cmd.add<TCLAP::SwitchArg>("","profile","Measure time and allocations per event of each stage, print and write them to output file",false);
+
+    auto cmd_split = cmd.add<TCLAP::ValueArg<unsigned>>("","split","Process the Acqu input file in given number of parallel processes and merge their output",false,0,"n");
+    auto cmd_splitpart = cmd.add<TCLAP::ValueArg<unsigned>>("","split_part","Process only the given part of --split (used by the worker processes)",false,0,"part");
+
 
 
     cmd.parse(argc, argv);
     if(cmd_verbose->isSet()) {
         el::Loggers::setVerboseLevel(cmd_verbose->getValue());
+        LOG_IF(cmd_verbose->getValue() > ANT_MAX_VLOG_LEVEL, WARNING)
+                << "Verbosity levels above " << ANT_MAX_VLOG_LEVEL << " were removed at compile time, "
+                << "reconfigure with -DAnt_MAX_VLOG_LEVEL=9 to enable them";
     }
 
     // progress updates only when running interactively
@@ -113,6 +363,27 @@ int main(int argc, char** argv) {
         }
     }
 
+    // run the workers and merge their output if splitting was requested
+    if(cmd_split->getValue()>1 && !cmd_splitpart->isSet()) {
+        if(!cmd_output->isSet()) {
+            LOG(ERROR) << "Please specify an output file when splitting with " << cmd_split->longID();
+            return EXIT_FAILURE;
+        }
+        return run_split(argc, argv, cmd_split->getValue(), cmd_output->getValue());
+    }
+
+    // otherwise, we might be one of the workers
+    string outputfile = cmd_output->getValue();
+    if(cmd_splitpart->isSet()) {
+        if(cmd_split->getValue()<=cmd_splitpart->getValue()) {
+            LOG(ERROR) << "Part " << cmd_splitpart->getValue() << " not within the " << cmd_split->getValue() << " parts of --split";
+            return EXIT_FAILURE;
+        }
+        UnpackerAcqu::Split.Part = cmd_splitpart->getValue();
+        UnpackerAcqu::Split.NParts = cmd_split->getValue();
+        outputfile = split_part_filename(outputfile, cmd_splitpart->getValue());
+    }
+
     // parse the setup options and tell the registry
     std::shared_ptr<OptionsList> setup_opts = make_shared<OptionsList>();
     if(cmd_setupOptions->isSet()) {
@@ -123,6 +394,11 @@ int main(int argc, char** argv) {
     }
 
 
+    // configure reading of trees before opening any file
+    WrapTFileInput::ReadCache.CacheSize = cmd_readcache->getValue()*(1 << 20);
+    WrapTFileInput::ReadCache.Prefetch = cmd_prefetch->isSet();
+    WrapTFileInput::ReadCache.ImplicitMTThreads = cmd_imt->getValue();
+
     // build the list of ROOT files first
     auto rootfiles = make_shared<WrapTFileInput>();
     for(const auto& inputfile : cmd_input->getValue()) {
@@ -157,6 +433,7 @@ int main(int argc, char** argv) {
 
     // now we can try to open the files with an unpacker
     std::unique_ptr<Unpacker::Module> unpacker = nullptr;
+    string unpacker_inputfile;
     for(const auto& inputfile : cmd_input->getValue()) {
         VLOG(5) << "Unpacker: Looking at file " << inputfile;
         try {
@@ -167,9 +444,14 @@ int main(int argc, char** argv) {
             }
             LOG(INFO) << "Found unpacker for file " << inputfile;
             unpacker = move(unpacker_);
+            unpacker_inputfile = inputfile;
         }
         catch(Unpacker::Exception& e) {
-            VLOG(5) << "Unpacker: " << e.what();
+            // as worker of --split, the file is expected to be unpacked
+            if(cmd_splitpart->isSet())
+                LOG(WARNING) << "Unpacker: " << e.what();
+            else
+                VLOG(5) << "Unpacker: " << e.what();
         }
         catch(RawFileReader::Exception& e) {
             LOG(WARNING) << "RawFileReader: Error opening file " << inputfile << ": " << e.what();
@@ -182,6 +464,11 @@ int main(int argc, char** argv) {
     }
 
 
+    if(cmd_splitpart->isSet() && dynamic_cast<UnpackerAcqu*>(unpacker.get()) == nullptr) {
+        LOG(ERROR) << "Splitting is only supported for a single Acqu input file";
+        return EXIT_FAILURE;
+    }
+
     // we can finally we can create the available input readers
     // for the analysis
 
@@ -198,15 +485,53 @@ int main(int argc, char** argv) {
                 LOG(WARNING) << "Cannot activate reconstruct without setup";
             }
         }
+
+        std::unique_ptr<analysis::input::ReconstructCache> cache;
+        if(cmd_cache->isSet()) {
+            if(!std_ext::system::testopen(cmd_cache->getValue())) {
+                LOG(ERROR) << "Cache directory " << cmd_cache->getValue() << " not accessible";
+                return EXIT_FAILURE;
+            }
+            // calibrations need the reconstruct to run on the unpacked hits,
+            // and split parts cover only some of the raw file
+            if(dynamic_cast<UnpackerAcqu*>(unpacker.get()) == nullptr)
+                LOG(WARNING) << "Reconstruct cache only available for Acqu input, ignoring " << cmd_cache->longID();
+            else if(!reconstruct)
+                LOG(WARNING) << "Reconstruct cache needs reconstruct, ignoring " << cmd_cache->longID();
+            else if(cmd_calibrations->isSet())
+                LOG(WARNING) << "Calibrations need the reconstruct, ignoring " << cmd_cache->longID();
+            else if(cmd_splitpart->isSet())
+                VLOG(5) << "Reconstruct cache not used by split part";
+            else {
+                auto& setup = ExpConfig::Setup::Get();
+                LOG_IF(GitInfo().IsDirty(), WARNING)
+                        << "Git repository has uncommitted changes, which are not detected by the reconstruct cache";
+                cache = std_ext::make_unique<analysis::input::ReconstructCache>(
+                            cmd_cache->getValue(),
+                            unpacker_inputfile,
+                            setup.GetName(),
+                            cmd_setupOptions->getValue(),
+                            setup.GetCalibrationDataManager());
+            }
+        }
+
         readers.push_back(std_ext::make_unique<analysis::input::AntReader>(
                               rootfiles,
                               move(unpacker),
-                              move(reconstruct)
+                              move(reconstruct),
+                              move(cache)
                               )
                           );
     }
     readers.push_back(std_ext::make_unique<analysis::input::PlutoReader>(rootfiles));
-    readers.push_back(std_ext::make_unique<analysis::input::GoatReader>(rootfiles));
+    {
+        auto goatcollections = ~analysis::input::GoatReader::collections_t();
+        for(const auto& c : goatCollections) {
+            if(std_ext::contains(cmd_goatskip->getValue(), c.first))
+                goatcollections.unset(c.second);
+        }
+        readers.push_back(std_ext::make_unique<analysis::input::GoatReader>(rootfiles, goatcollections));
+    }
 
 
     // create the list of enabled calibrations here,
@@ -248,7 +573,7 @@ int main(int argc, char** argv) {
     unique_ptr<WrapTFileOutput> masterFile;
     if(cmd_output->isSet()) {
         // cd into masterFile upon creation
-        masterFile = std_ext::make_unique<WrapTFileOutput>(cmd_output->getValue(), true);
+        masterFile = std_ext::make_unique<WrapTFileOutput>(outputfile, true);
     }
 
     // add the physics/calibrationphysics modules
@@ -364,10 +689,20 @@ int main(int argc, char** argv) {
             :  numeric_limits<long long>::max();
 
 
+    Profiler::Enabled = cmd_profile->isSet();
+
     // this method does the hard work...
     pm.ReadFrom(move(readers), maxevents);
     rootfiles = nullptr; // cleanup opened ROOT files for reading
 
+    if(Profiler::Enabled) {
+        Profiler::Enabled = false;
+        stringstream ss_profile;
+        Profiler::Print(ss_profile);
+        LOG(INFO) << "Profiler results:\n" << ss_profile.str();
+        Profiler::Write();
+    }
+
     TAntHeader* header = new TAntHeader();
     gDirectory->Add(header);
     {
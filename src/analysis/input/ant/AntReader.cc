@@ -1,10 +1,12 @@
 #include "AntReader.h"
+#include "ReconstructCache.h"
 
 #include "tree/TEvent.h"
 #include "tree/TEventData.h"
 
 #include "base/Logger.h"
 #include "base/WrapTTree.h"
+#include "base/Profiler.h"
 #include "input/treeEvents_t.h"
 
 #include "TTree.h"
@@ -31,7 +33,8 @@ struct AntReaderInternal {
 
 struct UnpackerReader : AntReaderInternal {
     UnpackerReader(unique_ptr<Unpacker::Module> unpacker_) :
-        unpacker(move(unpacker_))
+        unpacker(move(unpacker_)),
+        stage(Profiler::GetStage("Unpacker"))
     {
         LOG(INFO) << "Reading events from unpacker";
     }
@@ -39,18 +42,24 @@ struct UnpackerReader : AntReaderInternal {
         return unpacker->PercentDone();
     }
     virtual event_t NextEvent() override {
-        return event_t{unpacker->NextEvent()};
+        Profiler::Scope p(stage);
+        event_t event{unpacker->NextEvent()};
+        event.OutsideSplitRange = !unpacker->InSplitRange();
+        return event;
     }
     virtual bool ProvidesSlowControl() const override {
         return unpacker->ProvidesSlowControl();
     }
 private:
     unique_ptr<Unpacker::Module> unpacker;
+    Profiler::Stage_t& stage;
 }; // UnpackerReader
 
 
 struct TreeReader : AntReaderInternal {
-    TreeReader(const std::shared_ptr<WrapTFileInput>& rootfiles)
+    TreeReader(const std::shared_ptr<WrapTFileInput>& rootfiles_) :
+        rootfiles(rootfiles_),
+        stage(Profiler::GetStage("TreeReader"))
     {
         if(!rootfiles->GetObject("treeEvents", tree.Tree))
             return;
@@ -74,6 +83,7 @@ struct TreeReader : AntReaderInternal {
         if(current_entry==tree.Tree->GetEntries())
             return {};
 
+        Profiler::Scope p(stage);
         tree.Tree->GetEntry(current_entry);
         current_entry++;
         return event_t{move(tree.data())};
@@ -87,27 +97,63 @@ struct TreeReader : AntReaderInternal {
     }
 
 private:
+    // keep the files open as long as the tree is used
+    std::shared_ptr<WrapTFileInput> rootfiles;
     Long64_t current_entry = 0;
 
     treeEvents_t tree;
+    Profiler::Stage_t& stage;
 }; // TreeReader
 
+
+struct CacheReader : TreeReader {
+    CacheReader(const std::shared_ptr<WrapTFileInput>& cachefile, bool providesSlowControl_) :
+        TreeReader(cachefile),
+        providesSlowControl(providesSlowControl_)
+    {
+        LOG(INFO) << "Reading reconstructed events from cache";
+    }
+
+    // same as the unpacker which was replaced
+    virtual bool ProvidesSlowControl() const override {
+        return providesSlowControl;
+    }
+
+private:
+    bool providesSlowControl;
+}; // CacheReader
+
 }}}} // namespace ant::analysis::input::detail
 
 
 AntReader::AntReader(const std::shared_ptr<WrapTFileInput>& rootfiles,
         unique_ptr<Unpacker::Module> unpacker,
-        std::unique_ptr<Reconstruct_traits> reconstruct_
+        std::unique_ptr<Reconstruct_traits> reconstruct_,
+        std::unique_ptr<ReconstructCache> cache_
         ) :
-    reconstruct(move(reconstruct_))
+    reconstruct(move(reconstruct_)),
+    cache(move(cache_))
 {
     // prefer unpacker
     if(unpacker) {
-        reader = std_ext::make_unique<detail::UnpackerReader>(move(unpacker));
-        if(!reconstruct)
-            LOG(WARNING) << "Reconstruct disabled although reading from unpacker. Producing DetectorReadHits only.";
+        if(cache && reconstruct && cache->IsValid()) {
+            // replaces unpacker and reconstruct
+            reader = std_ext::make_unique<detail::CacheReader>(
+                         make_shared<WrapTFileInput>(cache->GetFilename()),
+                         unpacker->ProvidesSlowControl());
+            reconstruct = nullptr;
+            cache = nullptr;
+        }
+        else {
+            reader = std_ext::make_unique<detail::UnpackerReader>(move(unpacker));
+            if(!reconstruct) {
+                LOG(WARNING) << "Reconstruct disabled although reading from unpacker. Producing DetectorReadHits only.";
+                cache = nullptr;
+            }
+        }
     }
     else {
+        cache = nullptr;
         // try root files
         auto treereader = std_ext::make_unique<detail::TreeReader>(rootfiles);
         if(isfinite(treereader->PercentDone()))
@@ -153,12 +199,20 @@ bool AntReader::ReadNextEvent(event_t& event)
                 reconstruct->DoReconstruct(recon);
         }
 
+        if(cache)
+            cache->Write(nextevent);
+
         // pay attention that Geant unpacker might also set MCTrue branch partly
         event = move(nextevent);
 
         return true;
     }
 
+    // only now the cache is complete
+    if(cache) {
+        cache->Finish();
+        cache = nullptr;
+    }
     reader = nullptr;
     return false;
 }
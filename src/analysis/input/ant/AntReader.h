@@ -17,16 +17,27 @@ namespace detail {
 struct AntReaderInternal;
 }
 
+class ReconstructCache;
+
 class AntReader : public DataReader {
 
 protected:
     std::unique_ptr<detail::AntReaderInternal> reader;
     std::unique_ptr<Reconstruct_traits>        reconstruct;
+    std::unique_ptr<ReconstructCache>          cache;
 
 public:
+    /**
+     * @brief AntReader reads from the unpacker (preferred) or the Ant trees in rootfiles
+     * @param rootfiles
+     * @param unpacker
+     * @param reconstruct_ runs on the unpacked events
+     * @param cache_ if valid, replaces unpacker and reconstruct, otherwise filled with the reconstructed events
+     */
     AntReader(const std::shared_ptr<WrapTFileInput>& rootfiles,
               std::unique_ptr<Unpacker::Module> unpacker,
-              std::unique_ptr<Reconstruct_traits> reconstruct_);
+              std::unique_ptr<Reconstruct_traits> reconstruct_,
+              std::unique_ptr<ReconstructCache> cache_ = nullptr);
     virtual ~AntReader();
     AntReader(const AntReader&) = delete;
     AntReader& operator= (const AntReader&) = delete;
@@ -0,0 +1,223 @@
+#include "ReconstructCache.h"
+
+#include "analysis/input/event_t.h"
+#include "calibration/DataManager.h"
+
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
+
+#include "base/WrapTFile.h"
+#include "base/WrapTTree.h"
+#include "base/GitInfo.h"
+#include "base/Logger.h"
+#include "base/std_ext/hash.h"
+#include "base/std_ext/string.h"
+#include "base/std_ext/system.h"
+#include "base/std_ext/memory.h"
+
+#include "TTree.h"
+#include "TNamed.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::input;
+
+namespace {
+
+const string keyName       = "ReconstructCacheKey";
+const string accessLogName = "ReconstructCacheAccessLog";
+
+struct accessLog_t : WrapTTree {
+    ADD_BRANCH_T(std::string,        CalibrationID)
+    ADD_BRANCH_T(TID,                EventID)
+    ADD_BRANCH_T(bool,               Found)
+    ADD_BRANCH_T(long long,          TimeStamp)
+    ADD_BRANCH_T(TID,                FirstID)
+    ADD_BRANCH_T(TID,                LastID)
+    ADD_BRANCH_T(TID,                NextChangePoint)
+    ADD_BRANCH_T(unsigned long long, DataHash)
+};
+
+}
+
+string ReconstructCache::MakeKey(const string& rawfile,
+                                 const string& setupname,
+                                 const vector<string>& setupoptions)
+{
+    // the file is identified by its inode and modification time,
+    // so edits anywhere in the file invalidate the cache
+    struct stat st;
+    if(stat(rawfile.c_str(), &st) != 0)
+        throw runtime_error("Cannot stat raw file "+rawfile+" for cache key");
+    const unsigned long long size = st.st_size;
+
+    ifstream file(rawfile, ios::binary);
+    if(!file)
+        throw runtime_error("Cannot open raw file "+rawfile+" for cache key");
+
+    // hashing the complete file takes as long as unpacking it,
+    // so the content is only checked at the beginning and the end (including the file's end-of-run block)
+    const unsigned long long chunk = 1 << 20;
+    std_ext::fnv1a_t rawhash;
+    vector<char> buffer(chunk);
+    auto add_chunk = [&file, &buffer, &rawhash] (unsigned long long pos) {
+        file.seekg(pos);
+        file.read(buffer.data(), buffer.size());
+        rawhash.Add(buffer.data(), file.gcount());
+        file.clear();
+    };
+    add_chunk(0);
+    if(size > chunk)
+        add_chunk(std::max(chunk, size - chunk));
+
+    // order of options does not matter
+    auto options = setupoptions;
+    sort(options.begin(), options.end());
+
+    std_ext::formatter key;
+    key << "raw=" << rawhash.AsHex() << " size=" << size
+        << " device=" << st.st_dev << " inode=" << st.st_ino
+        << " mtime=" << st.st_mtim.tv_sec << "." << st.st_mtim.tv_nsec
+        << " setup=" << setupname;
+    for(const auto& option : options)
+        key << " option=" << option;
+    key << " git=" << GitInfo().GetDescription()
+        << " version=" << ANT_TEVENT_VERSION;
+    return key;
+}
+
+ReconstructCache::ReconstructCache(const string& cachedir,
+                                   const string& rawfile,
+                                   const string& setupname,
+                                   const vector<string>& setupoptions,
+                                   shared_ptr<calibration::DataManager> calmgr_) :
+    key(MakeKey(rawfile, setupname, setupoptions)),
+    filename(std_ext::formatter() << cachedir << "/ReconstructCache_" << std_ext::fnv1a_t().Add(key).AsHex() << ".root"),
+    tmp_filename(std_ext::formatter() << filename << ".part" << getpid()),
+    calmgr(move(calmgr_))
+{
+    VLOG(5) << "Cache key for " << rawfile << " is '" << key << "'";
+    // needed for writing, the calibration data used by the reconstruct is stored in the cache
+    if(calmgr)
+        calmgr->RecordAccesses(true);
+}
+
+ReconstructCache::~ReconstructCache()
+{
+    if(outputfile) {
+        Close();
+        std::remove(tmp_filename.c_str());
+        LOG(INFO) << "Input not read completely, removed incomplete cache " << tmp_filename;
+    }
+}
+
+bool ReconstructCache::IsValid() const
+{
+    if(!std_ext::system::testopen(filename))
+        return false;
+
+    calibration::DataManager::AccessLog_t log;
+    try {
+        WrapTFileInput input(filename);
+
+        TNamed* stored_key = nullptr;
+        if(!input.GetObject(keyName, stored_key) || key != stored_key->GetTitle()) {
+            LOG(WARNING) << "Cache " << filename << " was written for different input";
+            return false;
+        }
+
+        accessLog_t t;
+        if(!input.GetObject(accessLogName, t.Tree))
+            return false;
+        t.LinkBranches();
+        for(Long64_t entry=0;entry<t.Tree->GetEntries();entry++) {
+            t.Tree->GetEntry(entry);
+            calibration::DataManager::Access_t access;
+            access.CalibrationID   = t.CalibrationID;
+            access.EventID         = t.EventID;
+            access.Found           = t.Found;
+            access.TimeStamp       = t.TimeStamp;
+            access.FirstID         = t.FirstID;
+            access.LastID          = t.LastID;
+            access.NextChangePoint = t.NextChangePoint;
+            access.DataHash        = t.DataHash;
+            log.emplace_back(move(access));
+        }
+    }
+    catch(WrapTFile::Exception& e) {
+        LOG(WARNING) << "Cannot read cache: " << e.what();
+        return false;
+    }
+
+    if(!calmgr)
+        return log.empty();
+    if(!calmgr->ReproducesAccessLog(log)) {
+        LOG(INFO) << "Calibration data changed since writing cache " << filename;
+        return false;
+    }
+    return true;
+}
+
+void ReconstructCache::Write(event_t& event)
+{
+    if(!outputfile) {
+        outputfile = std_ext::make_unique<WrapTFileOutput>(tmp_filename);
+        treeEvents.CreateBranches(outputfile->CreateInside<TTree>("treeEvents", "Ant Reconstruct Cache"));
+        LOG(INFO) << "Writing reconstructed events to cache " << filename;
+    }
+
+    // the complete event is stored, including the DetectorReadHits
+    // (the CB energy sum of TriggerSimulation is built from them, for example)
+    TEvent& tevent = event;
+    treeEvents.data() = move(tevent);
+    treeEvents.Tree->Fill();
+    tevent = move(treeEvents.data());
+}
+
+void ReconstructCache::Close()
+{
+    // the tree is owned by the file
+    treeEvents.Tree = nullptr;
+    outputfile = nullptr;
+}
+
+void ReconstructCache::Finish()
+{
+    if(!outputfile)
+        return;
+
+    {
+        accessLog_t t;
+        t.CreateBranches(outputfile->CreateInside<TTree>(accessLogName.c_str(), "Requests to calibration database"));
+        if(calmgr) {
+            for(const auto& access : calmgr->GetAccessLog()) {
+                t.CalibrationID   = access.CalibrationID;
+                t.EventID         = access.EventID;
+                t.Found           = access.Found;
+                t.TimeStamp       = access.TimeStamp;
+                t.FirstID         = access.FirstID;
+                t.LastID          = access.LastID;
+                t.NextChangePoint = access.NextChangePoint;
+                t.DataHash        = access.DataHash;
+                t.Tree->Fill();
+            }
+        }
+    }
+    TNamed stored_key(keyName.c_str(), key.c_str());
+    outputfile->WriteObject(&stored_key, keyName);
+
+    // only complete caches get the final name
+    Close();
+    if(std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        LOG(WARNING) << "Cannot move cache " << tmp_filename << " to " << filename;
+        std::remove(tmp_filename.c_str());
+        return;
+    }
+    LOG(INFO) << "Cache " << filename << " now available";
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "analysis/input/treeEvents_t.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ant {
+
+class WrapTFileOutput;
+
+namespace calibration {
+class DataManager;
+}
+
+namespace analysis {
+namespace input {
+
+struct event_t;
+
+/**
+ * @brief The ReconstructCache class keeps the reconstructed events of a raw input file
+ *
+ * The cache file in the given directory is named after a key built from the raw file
+ * (its inode, modification time, size and a hash of its first and last MiB), the setup name and options and the git
+ * description of Ant. Which calibration data the reconstruct loads is only known after
+ * processing the file, so each request to the calibration database is stored in the cache file
+ * as well. The cache is only valid as long as the database still answers them with the same data.
+ *
+ * The cache is only made available after the complete raw file has been written.
+ * The events are stored completely, including their DetectorReadHits.
+ */
+class ReconstructCache {
+public:
+    ReconstructCache(const std::string& cachedir,
+                     const std::string& rawfile,
+                     const std::string& setupname,
+                     const std::vector<std::string>& setupoptions,
+                     std::shared_ptr<calibration::DataManager> calmgr);
+    ~ReconstructCache();
+    ReconstructCache(const ReconstructCache&) = delete;
+    ReconstructCache& operator= (const ReconstructCache&) = delete;
+
+    const std::string& GetFilename() const { return filename; }
+
+    /**
+     * @brief IsValid checks if a complete cache file with matching key and calibration data exists
+     */
+    bool IsValid() const;
+
+    /**
+     * @brief Write stores the event, which is left unchanged
+     */
+    void Write(event_t& event);
+
+    /**
+     * @brief Finish makes the cache file available, call it after the last event of the raw file
+     *
+     * If never called, the partially written file is removed.
+     */
+    void Finish();
+
+private:
+    const std::string key;
+    const std::string filename;
+    const std::string tmp_filename;
+    const std::shared_ptr<calibration::DataManager> calmgr;
+
+    std::unique_ptr<WrapTFileOutput> outputfile;
+    treeEvents_t treeEvents;
+
+    void Close();
+
+    static std::string MakeKey(const std::string& rawfile,
+                               const std::string& setupname,
+                               const std::vector<std::string>& setupoptions);
+};
+
+}}} // namespace ant::analysis::input
@@ -17,6 +17,9 @@ struct event_t : TEvent {
     bool empty_reconstructed = false;
     bool empty_mctrue = false;
 
+    // event only feeds the slowcontrol, see Unpacker::Module::InSplitRange
+    bool OutsideSplitRange = false;
+
     bool HasReconstructed() const { return reconstructed!=nullptr; }
     bool HasMCTrue() const { return mctrue!=nullptr; }
 
@@ -24,16 +24,18 @@ bool operator<(const reference_wrapper<TTree>& t1, const reference_wrapper<TTree
     return addressof(t1.get()) < addressof(t2.get());
 }
 
-GoatReader::GoatReader(const std::shared_ptr<const WrapTFileInput>& rootfiles) :
+GoatReader::GoatReader(const std::shared_ptr<const WrapTFileInput>& rootfiles, collections_t collections_) :
+    collections(collections_),
     current_entry(0),
     max_entries(0),
     init(true)
 {
     // let those components to the work, collect trees
-    init &= treeDetectorHitInput.LinkBranches(*rootfiles, trees);
-    init &= treeTaggerInput.LinkBranches(*rootfiles, trees);
-    init &= treeTriggerInput.LinkBranches(*rootfiles, trees);
-    init &= treeTrackInput.LinkBranches(*rootfiles, trees);
+    // all of them need to be present to recognize a GoAT file, but only the requested ones are read
+    init &= treeDetectorHitInput.LinkBranches(*rootfiles, trees, collections.test(collection_t::DetectorReadHits));
+    init &= treeTaggerInput.LinkBranches(*rootfiles, trees, collections.test(collection_t::TaggerHits));
+    init &= treeTriggerInput.LinkBranches(*rootfiles, trees, collections.test(collection_t::Trigger));
+    init &= treeTrackInput.LinkBranches(*rootfiles, trees, collections.test(collection_t::Candidates));
 
     // return silently if we haven't initiliazed
     if(!init)
@@ -97,10 +99,14 @@ bool GoatReader::ReadNextEvent(event_t& event)
 
     auto& recon = event.Reconstructed();
 
-    treeDetectorHitInput.Copy(recon);
-    treeTaggerInput.Copy(recon);
-    treeTriggerInput.Copy(recon);
-    treeTrackInput.Copy(recon);
+    if(collections.test(collection_t::DetectorReadHits))
+        treeDetectorHitInput.Copy(recon);
+    if(collections.test(collection_t::TaggerHits))
+        treeTaggerInput.Copy(recon);
+    if(collections.test(collection_t::Trigger))
+        treeTriggerInput.Copy(recon);
+    if(collections.test(collection_t::Candidates))
+        treeTrackInput.Copy(recon);
 
     ++current_entry;
     return true;
@@ -111,35 +117,55 @@ double GoatReader::PercentDone() const
     return double(current_entry)/double(max_entries);
 }
 
-bool GoatReader::treeDetectorHitInput_t::LinkBranches(const WrapTFileInput& input, trees_t& trees)
+void GoatReader::select_branches(TTree& tree, initializer_list<WrapTTree*> wraptrees,
+                                 initializer_list<const char*> unused)
+{
+    tree.SetBranchStatus("*", false);
+    for(auto wraptree : wraptrees)
+        wraptree->ActivateBranches();
+    for(auto branchname : unused)
+        tree.SetBranchStatus(branchname, false);
+    WrapTFileInput::SetupReadCache(addressof(tree));
+}
+
+bool GoatReader::treeDetectorHitInput_t::LinkBranches(const WrapTFileInput& input, trees_t& trees, bool read)
 {
     TTree* tree;
     if(!input.GetObject("detectorHits", tree))
         return false;
+    if(!read)
+        return true;
     NaI.LinkBranches(tree);
     PID.LinkBranches(tree);
     MWPC.LinkBranches(tree);
     BaF2.LinkBranches(tree);
     Veto.LinkBranches(tree);
+    // MWPC hits are not copied (yet)
+    select_branches(*tree, {&NaI, &PID, &BaF2, &Veto});
     insert_trees(trees, NaI, PID, MWPC, BaF2, Veto);
     return true;
 }
 
-bool GoatReader::treeTaggerInput_t::LinkBranches(const WrapTFileInput& input, trees_t& trees)
+bool GoatReader::treeTaggerInput_t::LinkBranches(const WrapTFileInput& input, trees_t& trees, bool read)
 {
     if(!input.GetObject("tagger",t.Tree))
         return false;
+    if(!read)
+        return true;
     t.LinkBranches();
+    select_branches(*t.Tree, {&t});
     insert_trees(trees, t);
     return true;
 }
 
-bool GoatReader::treeTriggerInput_t::LinkBranches(const WrapTFileInput& input, trees_t& trees)
+bool GoatReader::treeTriggerInput_t::LinkBranches(const WrapTFileInput& input, trees_t& trees, bool read)
 {
     if(!input.GetObject("trigger",t.Tree))
         return false;
     if(!input.GetObject("eventParameters",tEventParams.Tree))
         return false;
+    if(!read)
+        return true;
     t.LinkBranches();
     tEventParams.LinkBranches();
 
@@ -149,15 +175,20 @@ bool GoatReader::treeTriggerInput_t::LinkBranches(const WrapTFileInput& input, t
     LOG_IF(!t.helicity.IsPresent,  WARNING) << "Helicity bit information not found in input";
     LOG_IF(!t.MC_evt_id.IsPresent, WARNING) << "MC_evt_id/MC_rnd_id not found in input";
 
+    select_branches(*t.Tree, {&t}, {"triggerPattern"});
+    select_branches(*tEventParams.Tree, {&tEventParams}, {"nReconstructed"});
     insert_trees(trees, t, tEventParams);
     return true;
 }
 
-bool GoatReader::treeTrackInput_t::LinkBranches(const WrapTFileInput& input, trees_t& trees)
+bool GoatReader::treeTrackInput_t::LinkBranches(const WrapTFileInput& input, trees_t& trees, bool read)
 {
     if(!input.GetObject("tracks", t.Tree))
         return false;
+    if(!read)
+        return true;
     t.LinkBranches();
+    select_branches(*t.Tree, {&t}, {"MWPC0Energy", "MWPC1Energy", "pseudoVertexX", "pseudoVertexY", "pseudoVertexZ"});
     insert_trees(trees, t);
     return true;
 }
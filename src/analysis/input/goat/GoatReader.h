@@ -4,9 +4,11 @@
 
 #include "base/WrapTTree.h"
 #include "base/types.h"
+#include "base/bitflag.h"
 
 #include <string>
 #include <set>
+#include <initializer_list>
 
 namespace ant {
 
@@ -22,6 +24,18 @@ namespace analysis {
 namespace input {
 
 class GoatReader : public DataReader {
+public:
+    /**
+     * @brief The collection_t enum lists the parts of TEventData which can be read from GoAT trees
+     */
+    enum class collection_t {
+        DetectorReadHits, // from detectorHits tree
+        TaggerHits,       // from tagger tree
+        Trigger,          // from trigger and eventParameters tree
+        Candidates,       // including clusters, from tracks tree
+    };
+    using collections_t = bitflag<collection_t>;
+
 protected:
 
     std::shared_ptr<const WrapTFileInput> inputfiles;
@@ -55,7 +69,7 @@ protected:
         treeCluster_t    NaI{"NaI"};
         treeCluster_t    BaF2{"BaF2"};
 
-        bool LinkBranches(const WrapTFileInput& input, trees_t& trees);
+        bool LinkBranches(const WrapTFileInput& input, trees_t& trees, bool read);
         void Copy(TEventData& recon);
     };
 
@@ -67,7 +81,7 @@ protected:
         };
         tree_t t;
 
-        bool LinkBranches(const WrapTFileInput& input, trees_t& trees);
+        bool LinkBranches(const WrapTFileInput& input, trees_t& trees, bool read);
         void Copy(TEventData& recon);
     };
 
@@ -92,7 +106,7 @@ protected:
         tree_t t;
         treeEventParameters_t tEventParams;
 
-        bool LinkBranches(const WrapTFileInput& input, trees_t& trees);
+        bool LinkBranches(const WrapTFileInput& input, trees_t& trees, bool read);
         void Copy(TEventData& recon);
     };
 
@@ -120,7 +134,7 @@ protected:
 
         tree_t t;
 
-        bool LinkBranches(const WrapTFileInput& input, trees_t& trees);
+        bool LinkBranches(const WrapTFileInput& input, trees_t& trees, bool read);
         void Copy(TEventData& recon);
     };
 
@@ -134,13 +148,24 @@ protected:
         trees.insert({std::ref(static_cast<TTree&>(*args.Tree))...});
     }
 
+    // reads only the linked branches of the tree, except the unused ones
+    static void select_branches(TTree& tree, std::initializer_list<WrapTTree*> wraptrees,
+                                std::initializer_list<const char*> unused = {});
+
+    const collections_t collections;
     trees_t trees;
     long long current_entry;
     long long max_entries;
     bool init;
 
 public:
-    GoatReader(const std::shared_ptr<const WrapTFileInput>& rootfiles);
+    /**
+     * @brief GoatReader reads GoAT trees, if found in the given files
+     * @param rootfiles the input files
+     * @param collections only those parts of the event are read, the trees and branches of the others are skipped
+     */
+    GoatReader(const std::shared_ptr<const WrapTFileInput>& rootfiles,
+               collections_t collections = ~collections_t());
     virtual ~GoatReader();
 
     virtual reader_flags_t GetFlags() const override;
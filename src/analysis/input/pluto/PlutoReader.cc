@@ -17,6 +17,7 @@
 #include "base/Logger.h"
 #include "base/std_ext/string.h"
 #include "base/std_ext/container.h"
+#include "base/std_ext/arena.h"
 
 #include "TTree.h"
 
@@ -35,12 +36,15 @@ PlutoReader::PlutoReader(const std::shared_ptr<WrapTFileInput>& rootfiles) :
     VLOG(5) << "Found Pluto 'data' tree";
 
     plutoTree.LinkBranches();
+    SelectParticleBranches();
+    WrapTFileInput::SetupReadCache(plutoTree.Tree);
 
     if(files->GetObject("data_tid", tidTree.Tree)) {
         if(tidTree.Tree->GetEntries() != plutoTree.Tree->GetEntries()) {
             throw Exception("Pluto Tree / TID Tree size mismatch:");
         }
         tidTree.LinkBranches();
+        WrapTFileInput::SetupReadCache(tidTree.Tree);
     }
     else {
         // think of some better timestamp here?
@@ -65,6 +69,25 @@ PlutoReader::PlutoReader(const std::shared_ptr<WrapTFileInput>& rootfiles) :
 
 PlutoReader::~PlutoReader() {}
 
+void PlutoReader::SelectParticleBranches()
+{
+    // CopyPluto only uses the four-momentum and the decay tree info of the PParticles,
+    // so don't stream the other members if the TClonesArray was written split
+    const auto& prefix = plutoTree.Particles.Name + ".";
+    const std::vector<std::string> used_members = {"fE", "pid", "parentId", "parentIndex", "daughterIndex"};
+    for(const auto& member : used_members) {
+        if(plutoTree.Tree->GetBranch((prefix+member).c_str()) == nullptr) {
+            VLOG(5) << "Pluto tree not split as expected, reading all members of " << plutoTree.Particles.Name;
+            return;
+        }
+    }
+
+    plutoTree.Tree->SetBranchStatus((prefix+"*").c_str(), 0);
+    plutoTree.Tree->SetBranchStatus((prefix+"fP*").c_str(), 1);
+    for(const auto& member : used_members)
+        plutoTree.Tree->SetBranchStatus((prefix+member).c_str(), 1);
+}
+
 /**
  * @brief Find a PParticle in a vector by its ID. ID has to be unique in the vector.
  * @param particles vector to search
@@ -258,7 +281,7 @@ void PlutoReader::CopyPluto(TEventData& mctrue)
         // make an AntParticle out of it
         LorentzVec lv = *plutoParticle;
         lv *= 1000.0;   // convert to MeV
-        auto antParticle = make_shared<TParticle>(*type,lv);
+        auto antParticle = std_ext::make_arena_shared<TParticle>(*type,lv);
 
         // Consider final state particle
         if(plutoParticle->GetDaughterIndex() == -1 ) { // final state
@@ -285,8 +308,7 @@ void PlutoReader::CopyPluto(TEventData& mctrue)
     // then try building the usual decay tree
     if(!BuildParticleGunTree(mctrue.ParticleTree, plutoParticles, flatTree)) {
         if(!BuildDecayTree(mctrue.ParticleTree, plutoParticles, flatTree, dileptonIndices)) {
-            LOG_N_TIMES(10, WARNING) << "Missing decay tree info for event " << mctrue.ID
-                                     << " (max 10 times reported)";
+            LOG_AGGREGATED(10, WARNING) << "Missing decay tree info for event " << mctrue.ID;
             VLOG(5)      << "Dumping Pluto particles:\n" << PlutoTable(plutoParticles);
         }
     }
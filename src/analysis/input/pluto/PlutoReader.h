@@ -49,6 +49,7 @@ protected:
 
     long long current_entry = 0;
 
+    void SelectParticleBranches();
     void CopyPluto(TEventData& mctrue);
 
     PStaticData* pluto_database;
@@ -9,6 +9,8 @@
 #include "slowcontrol/SlowControlManager.h"
 
 #include "base/ProgressCounter.h"
+#include "base/std_ext/arena.h"
+#include "plot/FastHist.h"
 
 #include "TTree.h"
 
@@ -66,6 +68,12 @@ void PhysicsManager::ReadFrom(
     if(physics.empty())
         throw Exception("No analysis instances activated. Cannot not analyse anything.");
 
+    physics_stages.clear();
+    for(const auto& p : physics)
+        physics_stages.push_back(addressof(Profiler::GetStage("Physics/"+p->GetName())));
+    auto& stage_slowcontrol = Profiler::GetStage("SlowControl");
+    auto& stage_saveevent = Profiler::GetStage("SaveEvent");
+
     // prepare slowcontrol, init here since physics classes
     // register slowcontrol variables in constructor
     SlowControlManager slowControlManager(reader_flags);
@@ -118,7 +126,12 @@ void PhysicsManager::ReadFrom(
             nEventsRead++;
 
             // dump it into slowcontrol until full...
-            if(slowControlManager.ProcessEvent(move(event)))
+            bool slowcontrol_complete;
+            {
+                Profiler::Scope p(stage_slowcontrol);
+                slowcontrol_complete = slowControlManager.ProcessEvent(move(event));
+            }
+            if(slowcontrol_complete)
                 break;
             // ..or max buffersize reached: 20000 corresponds to two Acqu Scaler blocks
             if(slowControlManager.BufferSize()>20000) {
@@ -138,47 +151,65 @@ void PhysicsManager::ReadFrom(
                 break;
             }
 
-            logger::DebugInfo::nProcessedEvents = nEventsProcessed;
-
-            physics::manager_t manager;
-
-            // if we've already reached the maxevents,
-            // we just postprocess the remaining slowcontrol buffer (if any)
-            if(!reached_maxevents) {
-                if(nEventsAnalyzed == maxevents) {
-                    VLOG(3) << "Reached max Events " << maxevents;
-                    reached_maxevents = true;
-                    // we cannot simply break here since might
-                    // need to save stuff for slowcontrol purposes
-                    if(slowControlManager.BufferSize()==0)
-                        break;
+            // events outside the split range have done their job in the slowcontrol manager,
+            // they're analysed and saved by the process handling the other part
+            if(event.OutsideSplitRange) {
+                // release it before its memory is recycled below
+                auto skipped = move(event);
+                (void)skipped;
+            }
+            else {
+                logger::DebugInfo::nProcessedEvents = nEventsProcessed;
+
+                physics::manager_t manager;
+
+                // if we've already reached the maxevents,
+                // we just postprocess the remaining slowcontrol buffer (if any)
+                if(!reached_maxevents) {
+                    if(nEventsAnalyzed == maxevents) {
+                        VLOG(3) << "Reached max Events " << maxevents;
+                        reached_maxevents = true;
+                        // we cannot simply break here since might
+                        // need to save stuff for slowcontrol purposes
+                        if(slowControlManager.BufferSize()==0)
+                            break;
+                    }
+
+                    if(!reached_maxevents && !buf_event.WantsSkip) {
+
+                        ProcessEvent(event, manager);
+
+                        // prefer Reconstructed ID, but at least one branch should be non-null
+                        const auto& eventid = event.HasReconstructed() ? event.Reconstructed().ID : event.MCTrue().ID;
+                        if(nEventsAnalyzed==0)
+                            processedTIDrange.Start() = eventid;
+                        processedTIDrange.Stop() = eventid;
+
+                        nEventsAnalyzed++;
+
+                        if(manager.saveEvent)
+                            nEventsSaved++;
+                    }
                 }
 
-                if(!reached_maxevents && !buf_event.WantsSkip) {
-
-                    ProcessEvent(event, manager);
-
-                    // prefer Reconstructed ID, but at least one branch should be non-null
-                    const auto& eventid = event.HasReconstructed() ? event.Reconstructed().ID : event.MCTrue().ID;
-                    if(nEventsAnalyzed==0)
-                        processedTIDrange.Start() = eventid;
-                    processedTIDrange.Stop() = eventid;
-
-                    nEventsAnalyzed++;
-
-                    if(manager.saveEvent)
-                        nEventsSaved++;
+                // SaveEvent is the sink for events
+                {
+                    Profiler::Scope p(stage_saveevent);
+                    SaveEvent(move(event), manager);
                 }
-            }
 
-            // SaveEvent is the sink for events
-            SaveEvent(move(event), manager);
+                nEventsProcessed++;
+            }
 
-            nEventsProcessed++;
+            std_ext::arena::Get().EndEvent();
+            Profiler::CountEvent();
         }
         ProgressCounter::Tick();
     }
 
+    // the physics classes might use their histograms now
+    FastHist::FlushAll();
+
     for(auto& pclass : physics) {
         pclass->Finish();
     }
@@ -196,6 +227,8 @@ void PhysicsManager::ReadFrom(
               << processed_str << ", speed "
               << nEventsProcessed/progress.GetTotalSecs() << " event/s";
 
+    logger::Aggregator::PrintSummary();
+
     const auto nEventsSavedTotal = treeEvents.Tree->GetEntries();
     if(nEventsSaved==0) {
         if(nEventsSavedTotal>0)
@@ -250,7 +283,9 @@ void PhysicsManager::ProcessEvent(input::event_t& event, physics::manager_t& man
     event.EnsureTempBranches();
 
     // run the physics classes
+    auto it_stage = physics_stages.begin();
     for( auto& m : physics ) {
+        Profiler::Scope p(**it_stage++);
         m->ProcessEvent(event, manager);
     }
 
@@ -4,6 +4,8 @@
 #include "analysis/input/treeEvents_t.h"
 #include "analysis/input/reader_flags_t.h"
 
+#include "base/Profiler.h"
+
 #include <memory>
 #include <queue>
 
@@ -32,6 +34,9 @@ protected:
 
     physics_list_t physics;
 
+    // profiler stages, in the same order as physics
+    std::vector<Profiler::Stage_t*> physics_stages;
+
     std::unique_ptr<input::DataReader> source;
     using readers_t = std::list< std::unique_ptr<input::DataReader> >;
     readers_t amenders;
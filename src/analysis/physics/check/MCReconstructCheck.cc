@@ -265,7 +265,7 @@ void MCReconstructCheck::histgroup::Finish()
 }
 
 double angle(const TCandidate& c1, const TCandidate& c2) {
-    return vec3::RThetaPhi(1, c1.Theta, c1.Phi).Angle(vec3::RThetaPhi(1, c2.Theta, c2.Phi));
+    return c1.Direction.Angle(c2.Direction);
 }
 
 TCandidatePtrList CandidatesByDetector(const Detector_t::Any_t& detector, const TCandidateList& candidates) {
@@ -3,7 +3,6 @@
 #include "TH1D.h"
 #include "base/std_ext/string.h"
 #include "base/Logger.h"
-#include "utils/ProtonPermutation.h"
 
 
 using namespace ant;
@@ -18,25 +17,17 @@ void SetBinLabel(TH1* hist, const int bin, const std::string& label) {
     hist->GetXaxis()->SetBinLabel(bin, label.c_str());
 }
 
-LorentzVec sum_particles(const TParticleList& particles) {
-
-    LorentzVec lv;
-
-    for(const auto& p : particles) {
-        lv += *p;
-    }
-
-    return lv;
-}
-
 bool EventFilter::checkCoplanarity(const TCandidateList &cands, const double maxangle)
 {
-
-    for(utils::ProtonPermutation perm(cands.get_ptr_list()); perm.Good(); perm.Next()) {
-        const LorentzVec photons = sum_particles(perm.Photons());
-        const auto& proton = perm.Proton();
-
-        if(fabs(vec2::Phi_mpi_pi(M_PI + proton->Phi() - photons.Phi())) < maxangle)
+    // photon momenta from the cached candidate directions,
+    // each candidate is tried as the proton against the sum of all others
+    vec3 sum;
+    for(const auto& c : cands)
+        sum += c.Direction*c.CaloEnergy;
+
+    for(const auto& c : cands) {
+        const vec3 photons = sum - c.Direction*c.CaloEnergy;
+        if(fabs(vec2::Phi_mpi_pi(M_PI + c.Phi - photons.Phi())) < maxangle)
             return true;
     }
 
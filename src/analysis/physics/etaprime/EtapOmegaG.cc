@@ -261,17 +261,27 @@ void EtapOmegaG::ProcessEvent(const TEvent& event, manager_t&)
     Sig.OmegaPi0.treefitter.SetUncertaintyModel(is_MC ? fitmodel_mc : fitmodel_data);
     Ref.kinfitter.SetUncertaintyModel(is_MC ? fitmodel_mc : fitmodel_data);
 
-
-    for(const TTaggerHit& taggerhit : data.TaggerHits) {
-        promptrandom.SetTaggerTime(triggersimu.GetCorrectedTaggerTime(taggerhit));
-        if(promptrandom.State() == PromptRandom::Case::Outside)
-            continue;
+    // the particles are the same for all tagger hits, so set up the fits only once
+    Sig.kinfitter.PrepareEvent();
+    Sig.treefitter_Pi0Pi0.PrepareEvent();
+    Sig.treefitter_Pi0Eta.PrepareEvent();
+    Sig.Pi0.treefitter.PrepareEvent();
+    Sig.OmegaPi0.treefitter.PrepareEvent();
+    Ref.kinfitter.PrepareEvent();
+
+    // only visits the hits inside the prompt or random windows
+    const auto corrected_time = [this] (const TTaggerHit& taggerhit) {
+        return triggersimu.GetCorrectedTaggerTime(taggerhit);
+    };
+    for(const auto& selected : promptrandom.Select(data.TaggerHits, corrected_time)) {
+        const TTaggerHit& taggerhit = *selected.Hit;
+        promptrandom.SetTaggerHit(selected);
 
         t.TaggW  = promptrandom.FillWeight();
         t.TaggE  = taggerhit.PhotonEnergy;
         t.TaggT  = taggerhit.Time;
         t.TaggCh = taggerhit.Channel;
-        t.TaggTcorr = triggersimu.GetCorrectedTaggerTime(taggerhit);
+        t.TaggTcorr = selected.CorrectedTime;
 
         p.TaggerHit = taggerhit;
         p.TaggW = t.TaggW;
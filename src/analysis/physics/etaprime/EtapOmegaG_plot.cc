@@ -34,7 +34,7 @@ struct CommonHist_t {
 
         double Weight() const {
             if(MCWeighting.Tree)
-                return MCWeighting.MCWeight;
+                return MCWeighting.GetWeight();
             return Common.TaggW;
         }
 
@@ -649,6 +649,7 @@ struct EtapOmegaG_plot : Plotter {
         if(input.GetObject("EtapOmegaG/"+tag+"/"+utils::MCWeighting::treeName, treeMCWeighting.Tree)) {
             LOG(INFO) << "Found " << tag << " MCWeighting tree";
             treeMCWeighting.LinkBranches();
+            treeMCWeighting.ReadNormalization();
             check_entries(treeMCWeighting);
         }
 
@@ -662,6 +663,7 @@ struct EtapOmegaG_plot : Plotter {
         if(input.GetObject("EtapOmegaG/"+utils::MCWeighting::treeName, treeMCWeighting.Tree) &&
            input.GetObject("EtapOmegaG/"+utils::MCWeighting::treeName+"_extra", treeMCWeighting_extra.Tree)) {
             treeMCWeighting.LinkBranches();
+            treeMCWeighting.ReadNormalization();
             treeMCWeighting_extra.LinkBranches();
             if(treeMCWeighting.Tree->GetEntries() != treeMCWeighting.Tree->GetEntries()) {
                 LOG(ERROR) << "Mismatch in trees for MCTrue generated hist";
@@ -678,7 +680,7 @@ struct EtapOmegaG_plot : Plotter {
                 if(tag == "Ref" && treeMCWeighting_extra.MCTrue != 2)
                     continue;
                 treeMCWeighting.Tree->GetEntry(entry);
-                h->Fill(treeMCWeighting_extra.TaggCh(), treeMCWeighting.MCWeight());
+                h->Fill(treeMCWeighting_extra.TaggCh(), treeMCWeighting.GetWeight());
             }
         }
 
@@ -394,6 +394,40 @@ void OmegaEtaG2::Analyse(const TEventData &data, const TEvent& event, manager_t&
         fitter_eta.treefitter.SetUncertaintyModel(model);
     }
 
+    // the proton/photons combinations do not depend on the tagger hit,
+    // so build them once and let the fitter set up the particles only once
+    struct comb_t {
+        TParticlePtr  Proton; // nullptr if proton checks failed
+        TParticleList Photons;
+    };
+    vector<comb_t> combs;
+    for(auto it_proton = cands.begin(); it_proton != cands.end(); ++it_proton) {
+        combs.emplace_back();
+        auto& comb = combs.back();
+
+        //proton acceptance checks
+        if(!ProtonCheck(*it_proton))
+            continue;
+
+        comb.Proton = make_shared<TParticle>(ParticleTypeDatabase::Proton, *it_proton);
+
+        comb.Photons.reserve(nphotons);
+        for(auto it_photon = cands.begin(); it_photon!=cands.end(); ++it_photon) {
+
+            if(it_photon == it_proton)
+                continue;
+
+            if(PhotonCheck(*it_proton)) {
+
+                if(!opt_strict_Vetos || StrictPhotonVeto(**it_photon, **it_proton)) {
+                    comb.Photons.emplace_back(make_shared<TParticle>(ParticleTypeDatabase::Photon, *it_photon));
+                }
+
+            }
+        }
+    }
+    fitter.PrepareEvent();
+
     for(const TTaggerHit& TagH : data.TaggerHits) {
 
         dCounters.TaggerLoopBegin();
@@ -422,32 +456,15 @@ void OmegaEtaG2::Analyse(const TEventData &data, const TEvent& event, manager_t&
         TParticlePtr  fitted_proton;
         bool fit_ok = false;
 
-        for(auto it_proton = cands.begin(); it_proton != cands.end(); ++it_proton) {
+        for(const auto& comb : combs) {
 
             dCounters.PIDLoopBegin();
 
-            //proton acceptance checks
-            if(!ProtonCheck(*it_proton))
+            if(!comb.Proton)
                 continue; //proton loop
 
-            const TParticlePtr proton = make_shared<TParticle>(ParticleTypeDatabase::Proton, *it_proton);
-
-
-            TParticleList photons;
-            photons.reserve(nphotons);
-            for(auto it_photon = cands.begin(); it_photon!=cands.end(); ++it_photon) {
-
-                if(it_photon == it_proton)
-                    continue;
-
-                if(PhotonCheck(*it_proton)) {
-
-                    if(!opt_strict_Vetos || StrictPhotonVeto(**it_photon, **it_proton)) {
-                        photons.emplace_back(make_shared<TParticle>(ParticleTypeDatabase::Photon, *it_photon));
-                    }
-
-                }
-            }
+            const TParticlePtr& proton = comb.Proton;
+            const TParticleList& photons = comb.Photons;
 
             if(photons.size() != nphotons)
                 continue; //proton loop
@@ -408,6 +408,13 @@ void sigmaPlus::ProcessEvent(const ant::TEvent& event, manager_t&)
     tree.CBAvgTime = triggersimu.GetRefTiming();
 
     utils::ProtonPhotonCombs proton_photons(data.Candidates);
+    // cuts independent of the beam energy only once per event
+    const auto prefiltered = proton_photons()
+                             .FilterMult(phSettings.nPhotons,40)
+                             .FilterIM();
+    fitterEMB.PrepareEvent();
+    fitter3Pi0.PrepareEvent();
+    fitterK0S.PrepareEvent();
 
     for ( const auto& taggerHit: data.TaggerHits )
     {
@@ -429,11 +436,10 @@ void sigmaPlus::ProcessEvent(const ant::TEvent& event, manager_t&)
             tree.Tagg_EffErr  = taggEff.Error;
         }
 
-        auto selections =  proton_photons()
-                           .FilterMult(phSettings.nPhotons,40)
-                           .FilterMM(taggerHit, phSettings.Cut_MM)
-//                           .FilterCustom([] (const utils::ProtonPhotonCombs::comb_t& comb) { return std_ext::radian_to_degree(comb.Proton->Theta()) > 65;})
-                           ;
+        auto selections = prefiltered;
+        selections.FilterMM(taggerHit, phSettings.Cut_MM)
+//                  .FilterCustom([] (const utils::ProtonPhotonCombs::comb_t& comb) { return std_ext::radian_to_degree(comb.Proton->Theta()) > 65;})
+                  ;
         if (selections.empty())
             continue;
 
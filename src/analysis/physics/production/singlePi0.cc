@@ -255,6 +255,11 @@ void singlePi0::ProcessEvent(const ant::TEvent& event, manager_t&)
     //===================== Reconstruction ====================================================
     tree.CBAvgTime = triggersimu.GetRefTiming();
     utils::ProtonPhotonCombs proton_photons(data.Candidates);
+    // cuts independent of the beam energy only once per event
+    const auto prefiltered = proton_photons()
+                             .FilterMult(phSettings.nPhotons,100)
+                             .FilterIM(phSettings.Cut_IM);
+    fitterEMB.PrepareEvent();
 
     for ( const auto& taggerHit: data.TaggerHits )
     {
@@ -280,10 +285,8 @@ void singlePi0::ProcessEvent(const ant::TEvent& event, manager_t&)
 //                                                             taggerHit.GetPhotonBeam(),
 //                                                             taggerHit.PhotonEnergy,
 //                                                             phSettings.Cut_MM);
-        auto selections =  proton_photons()
-                           .FilterMult(phSettings.nPhotons,100)
-                           .FilterIM(phSettings.Cut_IM)
-                           .FilterMM(taggerHit, phSettings.Cut_MM);
+        auto selections = prefiltered;
+        selections.FilterMM(taggerHit, phSettings.Cut_MM);
 
         if (selections.empty())
         {
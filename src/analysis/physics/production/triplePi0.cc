@@ -340,6 +340,12 @@ void triplePi0::ProcessEvent(const ant::TEvent& event, manager_t&)
     tree.CBAvgTime = triggersimu.GetRefTiming();
 
     utils::ProtonPhotonCombs proton_photons(data.Candidates);
+    // cuts independent of the beam energy only once per event
+    const auto prefiltered = proton_photons()
+                             .FilterMult(phSettings.nPhotons,100)
+                             .FilterIM();
+    fitterEMB.PrepareEvent();
+    fitterSig.PrepareEvent();
 
     for ( const auto& taggerHit: data.TaggerHits )
     {
@@ -362,9 +368,8 @@ void triplePi0::ProcessEvent(const ant::TEvent& event, manager_t&)
         }
 
 
-        auto selections =  proton_photons()
-                           .FilterMult(phSettings.nPhotons,100)
-                           .FilterMM(taggerHit, phSettings.Cut_MM);
+        auto selections = prefiltered;
+        selections.FilterMM(taggerHit, phSettings.Cut_MM);
         if (selections.empty())
         {
             FillStep("No combs left");
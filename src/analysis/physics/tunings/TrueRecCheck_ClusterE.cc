@@ -15,7 +15,8 @@ TrueRecCheck_ClusterE::TrueRecCheck_ClusterE(const string& name, OptionsPtr opts
     Physics(name, opts),
     CBThetaWindow(degree_to_radian(50.0), degree_to_radian(180.0-50.0)),
     TAPSThetaWindow(degree_to_radian(3.0), degree_to_radian(18.0)),
-    CBHemisphereGap({degree_to_radian(interval<double>::CenterWidth(0.0,40.0)),degree_to_radian(interval<double>::CenterWidth(180.0,40.0))})
+    CBHemisphereGap({degree_to_radian(interval<double>::CenterWidth(0.0,40.0)),degree_to_radian(interval<double>::CenterWidth(180.0,40.0))}),
+    matcher(utils::AssignmentMatcher::mode_t::Greedy, {0.0, std_ext::degree_to_radian(15.0)})
 {
     string partname[] = {"p","ep","em","g"};
     string parttitle[] = {"p","e^{+}","e^{-}","#gamma"};
@@ -94,9 +95,9 @@ void TrueRecCheck_ClusterE::ProcessEvent(const TEvent& event, manager_t&)
         //-- Match the true particles to the reconstructed candidates
         const auto mcparticles = mcparticleslist.GetAll();
         const auto& candidates = event.Reconstructed().Candidates;
-        const auto matched  = utils::match1to1(mcparticles, candidates.get_ptr_list(),
-                                               [] (const TParticlePtr& p1, const TCandidatePtr& p2) {return p1->Angle(*p2);},
-                                               {0.0, std_ext::degree_to_radian(15.0)});
+        matcher.Match(mcparticles, candidates.get_ptr_list(),
+                      [] (const TParticlePtr& p1, const TCandidatePtr& p2) {return p1->Angle(*p2);},
+                      matched);
 
         //-- Fill their corresponding histograms for each true particle
         for(auto& p_true: mcparticles){
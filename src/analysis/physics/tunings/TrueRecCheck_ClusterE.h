@@ -4,8 +4,10 @@
 #include "base/interval.h"
 #include "base/piecewise_interval.h"
 #include "utils/Matcher.h"
+#include "tree/TParticle.h"
 
 #include <string>
+#include <vector>
 
 namespace ant {
 namespace analysis {
@@ -32,6 +34,10 @@ protected:
     TH2D *h_Ek_TrueRecvsRec[2][nrParticles];
     TH1D *h_PairedOpAngle[2][nrParticles];
 
+    // greedy as utils::match1to1, kept over events to not allocate for each
+    utils::AssignmentMatcher matcher;
+    std::vector<utils::scored_match<TParticlePtr, TCandidatePtr>> matched;
+
 public:
     TrueRecCheck_ClusterE(const std::string& name, OptionsPtr opts);
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
@@ -0,0 +1,172 @@
+#include "FastHist.h"
+
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TROOT.h"
+#include "TList.h"
+
+#include <algorithm>
+#include <list>
+#include <iterator>
+#include <type_traits>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+
+list<weak_ptr<FastHist::buffer_t>>& FastHist::buffers()
+{
+    static list<weak_ptr<buffer_t>> instance;
+    return instance;
+}
+
+// gets notified by ROOT when a histogram with the kMustCleanup bit is deleted
+struct FastHist::cleanup_t : TObject {
+    virtual void RecursiveRemove(TObject* obj) override {
+        for(auto& b : buffers()) {
+            auto buffer = b.lock();
+            if(buffer && buffer->Hist == obj)
+                buffer->Hist = nullptr;
+        }
+    }
+
+    static void Register(TH1* h) {
+        // never deleted, as the list of cleanups might be gone before static destruction
+        static cleanup_t* instance = [] () {
+            auto c = new cleanup_t();
+            gROOT->GetListOfCleanups()->Add(c);
+            return c;
+        }();
+        (void)instance;
+        h->SetBit(kMustCleanup);
+    }
+};
+
+FastHist::axis_t::axis_t(const TAxis& axis) :
+    Bins(axis.GetNbins()), Min(axis.GetXmin()), Max(axis.GetXmax())
+{
+    if(axis.GetXbins()->GetSize() > 0)
+        throw Exception("FastHist supports fixed binning only");
+    if(axis.GetLabels())
+        throw Exception("FastHist does not support labeled axes");
+}
+
+FastHist::buffer_t::buffer_t(TH1* h) :
+    Hist(h),
+    Bins(h->GetNcells(), 0.0),
+    Stats(),
+    Entries(0),
+    Dirty(false)
+{
+    if(h->GetSumw2N() > 0)
+        Sumw2.resize(Bins.size(), 0.0);
+}
+
+FastHist::buffer_t::~buffer_t()
+{
+    Flush();
+}
+
+void FastHist::buffer_t::EnableSumw2(int bin, double w)
+{
+    // same as TH1::Fill does: all fills before had unit weight
+    Sumw2 = Bins;
+    Sumw2[bin] += w*w - w;
+}
+
+void FastHist::buffer_t::Flush()
+{
+    if(!Dirty || !Hist)
+        return;
+
+    // get the stats before touching the bins, they might be computed from them
+    double stats[TH1::kNstat] = {};
+    Hist->GetStats(stats);
+
+    // the histogram uses Sumw2 as soon as any fill was weighted,
+    // enable it before adding the bins, as TH1::Sumw2 initializes it from the present contents
+    // (all from unit weight fills, otherwise it would be enabled already)
+    if(!Sumw2.empty() && Hist->GetSumw2N() == 0)
+        Hist->Sumw2();
+
+    auto& bins = dynamic_cast<TArrayD&>(*Hist);
+    for(size_t i=0;i<Bins.size();i++)
+        bins.GetArray()[i] += Bins[i];
+
+    if(Hist->GetSumw2N() > 0) {
+        const auto& sumw2 = Sumw2.empty() ? Bins : Sumw2;
+        auto h_sumw2 = Hist->GetSumw2()->GetArray();
+        for(size_t i=0;i<sumw2.size();i++)
+            h_sumw2[i] += sumw2[i];
+    }
+
+    for(unsigned i=0;i<std::extent<decltype(Stats)>::value;i++)
+        stats[i] += Stats[i];
+    const auto entries = Hist->GetEntries() + Entries;
+    Hist->PutStats(stats);
+    Hist->SetEntries(entries);
+
+    // keep the Sumw2 buffer once needed
+    std::fill(Bins.begin(), Bins.end(), 0.0);
+    std::fill(Sumw2.begin(), Sumw2.end(), 0.0);
+    std::fill(std::begin(Stats), std::end(Stats), 0.0);
+    Entries = 0;
+    Dirty = false;
+}
+
+FastHist::FastHist(TH1* h) :
+    statOverflows(TH1::GetStatOverflows())
+{
+    if(!h)
+        throw Exception("FastHist needs a histogram");
+    cleanup_t::Register(h);
+    buffer = make_shared<buffer_t>(h);
+    auto& b = buffers();
+    b.remove_if([] (const weak_ptr<buffer_t>& p) { return p.expired(); });
+    b.emplace_back(buffer);
+}
+
+void FastHist::FlushAll()
+{
+    auto& b = buffers();
+    b.remove_if([] (const weak_ptr<buffer_t>& p) { return p.expired(); });
+    for(auto& p : b) {
+        if(auto buffer = p.lock())
+            buffer->Flush();
+    }
+}
+
+FastTH1D::FastTH1D(TH1D* h) :
+    FastHist(h),
+    x_axis(*h->GetXaxis()),
+    hist(h)
+{}
+
+void FastTH1D::Fill(const vector<double>& x, double w) noexcept
+{
+    for(auto v : x)
+        Fill(v, w);
+}
+
+void FastTH1D::Fill(const vector<double>& x, const vector<double>& w)
+{
+    if(x.size() != w.size())
+        throw Exception("FastTH1D: Values and weights differ in size");
+    for(size_t i=0;i<x.size();i++)
+        Fill(x[i], w[i]);
+}
+
+FastTH2D::FastTH2D(TH2D* h) :
+    FastHist(h),
+    x_axis(*h->GetXaxis()),
+    y_axis(*h->GetYaxis()),
+    hist(h)
+{}
+
+void FastTH2D::Fill(const vector<double>& x, const vector<double>& y, double w)
+{
+    if(x.size() != y.size())
+        throw Exception("FastTH2D: x and y values differ in size");
+    for(size_t i=0;i<x.size();i++)
+        Fill(x[i], y[i], w);
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <vector>
+#include <list>
+#include <memory>
+#include <stdexcept>
+
+class TH1;
+class TH1D;
+class TH2D;
+class TAxis;
+
+namespace ant {
+namespace analysis {
+
+/**
+ * @brief The FastHist class is the common part of the fast fill handles FastTH1D and FastTH2D
+ *
+ * The handles fill flat arrays of the fixed binning without going through TH1::Fill,
+ * and add them to the underlying histogram (including statistics and entries) on Flush().
+ * The resulting histogram is the same as if it had been filled directly.
+ * The handles are cheap to copy and share the same buffer, like a TH1D* does.
+ * The buffer is flushed when the last handle is gone. If ROOT deletes the histogram before
+ * (for example when its directory is closed), the buffer is detached and further fills are dropped.
+ */
+class FastHist {
+protected:
+    struct axis_t {
+        int    Bins;
+        double Min;
+        double Max;
+        explicit axis_t(const TAxis& axis);
+
+        // same as TAxis::FindBin for fixed binning, including NaN going to overflow
+        int FindBin(double x) const noexcept {
+            if(x < Min)
+                return 0;
+            if(!(x < Max))
+                return Bins+1;
+            return 1 + int(Bins*(x-Min)/(Max-Min));
+        }
+
+        bool InRange(int bin) const noexcept {
+            return bin > 0 && bin <= Bins;
+        }
+    };
+
+    struct buffer_t {
+        TH1* Hist; // nullptr once deleted by ROOT
+        std::vector<double> Bins;
+        std::vector<double> Sumw2; // only allocated when needed, as for TH1
+        double Stats[7];           // as TH1::GetStats for TH2, TH1 uses the first four only
+        double Entries;
+        bool   Dirty;
+        explicit buffer_t(TH1* h);
+        ~buffer_t();
+        void EnableSumw2(int bin, double w);
+        void Flush();
+    };
+
+    // all buffers with handles, expired ones are removed on the next registration or FlushAll
+    static std::list<std::weak_ptr<buffer_t>>& buffers();
+    struct cleanup_t;
+
+    std::shared_ptr<buffer_t> buffer;
+    bool statOverflows;
+
+    explicit FastHist(TH1* h);
+
+    void AddBin(int bin, double w) noexcept {
+        auto& b = *buffer;
+        b.Dirty = true;
+        b.Entries++;
+        b.Bins[bin] += w;
+        if(!b.Sumw2.empty())
+            b.Sumw2[bin] += w*w;
+        else if(w != 1.0)
+            b.EnableSumw2(bin, w);
+    }
+
+public:
+
+    /**
+     * @brief Flush adds the buffered fills to the histogram
+     */
+    void Flush() { buffer->Flush(); }
+
+    /**
+     * @brief FlushAll flushes all handles with pending fills, called before the physics classes are finished
+     */
+    static void FlushAll();
+
+    struct Exception : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+};
+
+class FastTH1D : public FastHist {
+    axis_t x_axis;
+    TH1D* hist;
+public:
+    explicit FastTH1D(TH1D* h);
+
+    void Fill(double x, double w = 1.0) noexcept {
+        const int bin = x_axis.FindBin(x);
+        AddBin(bin, w);
+        if(!statOverflows && !x_axis.InRange(bin))
+            return;
+        auto s = buffer->Stats;
+        s[0] += w;
+        s[1] += w*w;
+        s[2] += w*x;
+        s[3] += w*x*x;
+    }
+
+    void Fill(const std::vector<double>& x, double w = 1.0) noexcept;
+    void Fill(const std::vector<double>& x, const std::vector<double>& w);
+
+    // the buffered fills only show up after Flush()
+    TH1D* Get() const noexcept { return hist; }
+};
+
+class FastTH2D : public FastHist {
+    axis_t x_axis;
+    axis_t y_axis;
+    TH2D* hist;
+public:
+    explicit FastTH2D(TH2D* h);
+
+    void Fill(double x, double y, double w = 1.0) noexcept {
+        const int binx = x_axis.FindBin(x);
+        const int biny = y_axis.FindBin(y);
+        AddBin(biny*(x_axis.Bins+2) + binx, w);
+        if(!statOverflows && !(x_axis.InRange(binx) && y_axis.InRange(biny)))
+            return;
+        auto s = buffer->Stats;
+        s[0] += w;
+        s[1] += w*w;
+        s[2] += w*x;
+        s[3] += w*x*x;
+        s[4] += w*y;
+        s[5] += w*y*y;
+        s[6] += w*x*y;
+    }
+
+    void Fill(const std::vector<double>& x, const std::vector<double>& y, double w = 1.0);
+
+    // the buffered fills only show up after Flush()
+    TH2D* Get() const noexcept { return hist; }
+};
+
+}} // namespace ant::analysis
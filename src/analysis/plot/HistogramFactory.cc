@@ -366,6 +366,23 @@ TH3D* HistogramFactory::makeTH3D(
     return h;
 }
 
+FastTH1D HistogramFactory::makeFastTH1D(
+        const string& title,
+        const AxisSettings& x_axis_settings,
+        const string& name, bool sumw2) const
+{
+    return FastTH1D(makeTH1D(title, x_axis_settings, name, sumw2));
+}
+
+FastTH2D HistogramFactory::makeFastTH2D(
+        const string& title,
+        const AxisSettings& x_axis_settings,
+        const AxisSettings& y_axis_settings,
+        const string& name, bool sumw2) const
+{
+    return FastTH2D(makeTH2D(title, x_axis_settings, y_axis_settings, name, sumw2));
+}
+
 TGraph* HistogramFactory::makeGraph(
         const string& title,
         const string& name) const
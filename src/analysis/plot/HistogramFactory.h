@@ -2,6 +2,7 @@
 
 #include "base/interval.h"
 #include "base/BinSettings.h"
+#include "FastHist.h"
 
 #include <string>
 #include <vector>
@@ -222,6 +223,27 @@ public:
             const std::string& name="",
             bool  sumw2 = false) const;
 
+    /**
+     * @brief create TH1D which is filled by the returned handle, much faster than TH1::Fill
+     * @see FastHist, the fills are added to the histogram when flushed
+     */
+    FastTH1D makeFastTH1D(
+            const std::string& title,
+            const AxisSettings& x_axis_settings,
+            const std::string& name="",
+            bool  sumw2 = false) const;
+
+    /**
+     * @brief create TH2D which is filled by the returned handle, much faster than TH2::Fill
+     * @see FastHist, the fills are added to the histogram when flushed
+     */
+    FastTH2D makeFastTH2D(
+            const std::string& title,
+            const AxisSettings& x_axis_settings,
+            const AxisSettings& y_axis_settings,
+            const std::string& name="",
+            bool  sumw2 = false) const;
+
     TGraph* makeGraph(
             const std::string& title,
             const std::string& name="") const;
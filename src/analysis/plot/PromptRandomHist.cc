@@ -2,6 +2,9 @@
 
 #include "expconfig/ExpConfig.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace ant;
 using namespace ant::analysis;
 using namespace ant::analysis::PromptRandom;
@@ -29,7 +32,7 @@ void Hist2::MakeHistograms(const HistogramFactory& factory, const string& name,
     subtracted->Sumw2();
 }
 
-void Switch::update_ratio() {
+void Switch::update_windows() {
     double p = promptw.Area();
     double r = randomw.Area();
     if(r <= 0.0) {
@@ -37,23 +40,34 @@ void Switch::update_ratio() {
     } else {
         ratio = p/r;
     }
+
+    // same precedence as in SetTaggerTime
+    windows.clear();
+    for(const auto& i : randomw)
+        windows.push_back({i, Case::Random, -ratio});
+    for(const auto& i : promptw)
+        windows.push_back({i, Case::Prompt, 1.0});
+
+    windows_t all(randomw);
+    all.insert(all.end(), promptw.begin(), promptw.end());
+    enclosing = all.EnclosingInterval();
 }
 
 Switch::Switch(const expconfig::Setup_traits& setup) :
     promptw(setup.GetPromptWindows()),
     randomw(setup.GetRandomWindows())
 {
-    update_ratio();
+    update_windows();
 }
 
 void Switch::AddPromptRange(const Switch::interval_t& i) {
     promptw.emplace_back(i);
-    update_ratio();
+    update_windows();
 }
 
 void Switch::AddRandomRange(const Switch::interval_t& i) {
     randomw.emplace_back(i);
-    update_ratio();
+    update_windows();
 }
 
 void Switch::SetTaggerTime(const double tagtime) {
@@ -70,3 +84,50 @@ void Switch::SetTaggerTime(const double tagtime) {
     }
 
 }
+
+void Switch::SetTaggerHit(const Switch::TaggerHit_t& taggerhit) {
+    rpcase = taggerhit.State;
+    fillw = taggerhit.FillWeight;
+}
+
+vector<Switch::TaggerHit_t> Switch::Select(const vector<TTaggerHit>& taggerhits,
+                                           const time_correction_t& corrected_time) const {
+
+    vector<TaggerHit_t> selected;
+    if(windows.empty())
+        return selected;
+
+    const auto get_time = [&corrected_time] (const TTaggerHit& h) {
+        return corrected_time ? corrected_time(h) : h.Time;
+    };
+
+    auto first = taggerhits.begin();
+    auto last  = taggerhits.end();
+
+    // sorted hits outside all windows are skipped by bisection,
+    // hits without time are never inside a window and must all come last,
+    // as a NaN in the middle would otherwise pass for sorted
+    const auto no_time = [] (const TTaggerHit& h) { return std::isnan(h.Time); };
+    const auto by_time = [] (const TTaggerHit& a, const TTaggerHit& b) {
+        return a.Time < b.Time;
+    };
+    const auto timed_last = std::find_if(first, last, no_time);
+    if(std::all_of(timed_last, last, no_time) && std::is_sorted(first, timed_last, by_time)) {
+        last  = timed_last;
+        first = std::lower_bound(first, last, enclosing.Start(),
+                                 [&get_time] (const TTaggerHit& h, double t) { return get_time(h) < t; });
+        last  = std::upper_bound(first, last, enclosing.Stop(),
+                                 [&get_time] (double t, const TTaggerHit& h) { return t < get_time(h); });
+    }
+
+    for(auto it = first; it != last; ++it) {
+        const double t = get_time(*it);
+        for(const auto& w : windows) {
+            if(w.Interval.Contains(t)) {
+                selected.push_back({addressof(*it), t, w.State, w.FillWeight});
+                break;
+            }
+        }
+    }
+    return selected;
+}
@@ -5,10 +5,14 @@
 
 #include "HistogramFactory.h"
 
+#include "tree/TTaggerHit.h"
+
 #include "TH1D.h"
 #include "TH2D.h"
 
+#include <functional>
 #include <string>
+#include <vector>
 
 namespace ant {
 
@@ -31,12 +35,32 @@ public:
     using windows_t  = ant::PiecewiseInterval<double>;
     using interval_t = windows_t::interval_t;
 
+    /**
+     * @brief The TaggerHit_t struct is a tagger hit inside the prompt or random windows
+     */
+    struct TaggerHit_t {
+        const TTaggerHit* Hit;
+        double CorrectedTime; // as given by the time correction of Select()
+        Case   State;
+        double FillWeight;
+    };
+
 protected:
     windows_t promptw = {};
     windows_t randomw = {};
     double ratio = 1.0;  // == all prompt
 
-    void update_ratio();
+    // random and prompt windows with their weights, random ones come first
+    struct window_t {
+        interval_t Interval;
+        Case       State;
+        double     FillWeight;
+    };
+    std::vector<window_t> windows;
+    interval_t enclosing{0, 0};
+
+    // updates the ratio and the windows
+    void update_windows();
 
     Case rpcase = Case::Prompt;
     double fillw = 1.0;
@@ -70,6 +94,23 @@ public:
 
     void SetTaggerTime(double tagtime);
 
+    /**
+     * @brief SetTaggerHit sets the state of a hit obtained from Select() without searching the windows again
+     */
+    void SetTaggerHit(const TaggerHit_t& taggerhit);
+
+    using time_correction_t = std::function<double(const TTaggerHit&)>;
+
+    /**
+     * @brief Select finds the tagger hits inside the prompt or random windows
+     * @param taggerhits the hits, searched faster if sorted by time as from Reconstruct
+     * @param corrected_time usually TriggerSimulation::GetCorrectedTaggerTime, the raw time if empty
+     * @return the prompt and random hits in the given order, with their state and fill weight
+     * @note the correction must preserve the order of the hit times, otherwise sorted hits are not bisected correctly
+     */
+    std::vector<TaggerHit_t> Select(const std::vector<TTaggerHit>& taggerhits,
+                                    const time_correction_t& corrected_time = {}) const;
+
 
 };
 
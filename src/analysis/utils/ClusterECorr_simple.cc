@@ -1,5 +1,9 @@
 #include "ClusterECorr_simple.h"
 
+#include "base/std_ext/math.h"
+
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 using namespace ant;
@@ -22,25 +26,34 @@ void ClusterECorr_simple::LoadECorr(const string& filename, const string& hname)
             throw(std::runtime_error("Histogram not found: "+hname));
         else
             hECorrSet = true;
-        hECorr = *dynamic_cast<TH1D*>(hOrig->Clone());
+
+        // the lookup clips to the centers of the first and last bin
+        const auto axis = hOrig->GetXaxis();
+        const int nbins = axis->GetNbins();
+        CluEMin = axis->GetBinCenter(1);
+        CluEMax = axis->GetBinCenter(nbins);
+        binEdges.clear();
+        binContents.clear();
+        for(int bin=1;bin<=nbins;bin++) {
+            binEdges.push_back(axis->GetBinUpEdge(bin));
+            binContents.push_back(hOrig->GetBinContent(bin));
+        }
         hOrig->Delete();
     }
 }
 
-double ClusterECorr_simple::GetECorr(const double CluEin)
+double ClusterECorr_simple::GetECorr(const double CluEin) const
 {
-    if(hECorrSet){
-        double CluE = CluEin;
-        double CluEMin = hECorr.GetXaxis()->GetBinCenter(1);
-        int maxbin = hECorr.GetXaxis()->GetNbins();
-        double CluEMax = hECorr.GetXaxis()->GetBinCenter(maxbin);
-        if(CluE<CluEMin) CluE = CluEMin;
-        if(CluE>CluEMax) CluE = CluEMax;
-        int bin = hECorr.FindFixBin(CluE);
-        double ECorr = hECorr.GetBinContent(bin);
-        return ECorr;
-    }
-    else
+    if(!hECorrSet)
         throw(std::runtime_error("Correction histogram not set"));
-    return 0;
+
+    // NaN cannot be clipped and would end up in the last bin
+    if(std::isnan(CluEin))
+        return std_ext::NaN;
+
+    const double CluE = std::min(std::max(CluEin, CluEMin), CluEMax);
+    // same as TH1::FindFixBin, the upper edge belongs to the next bin
+    const auto it = std::upper_bound(binEdges.begin(), binEdges.end(), CluE);
+    const auto bin = std::min<size_t>(it - binEdges.begin(), binContents.size()-1);
+    return binContents[bin];
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
 
 #include "TH1D.h"
 
@@ -25,10 +26,15 @@ public:
     ClusterECorr_simple();
     ~ClusterECorr_simple();
     void LoadECorr(const std::string& filename, const std::string &hname);
-    double GetECorr(const double CluEin);
+    // NaN for NaN energies
+    double GetECorr(const double CluEin) const;
 
 private:
-    TH1D hECorr;
+    // tabulated from the histogram: upper bin edges and contents
+    std::vector<double> binEdges;
+    std::vector<double> binContents;
+    double CluEMin = 0;
+    double CluEMax = 0;
     bool hECorrSet = false;
 };
 
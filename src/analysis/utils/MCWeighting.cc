@@ -4,17 +4,23 @@
 #include "base/std_ext/string.h"
 #include "base/Logger.h"
 
-
-// use ROOT's function GSL wrapper...
-#include "Math/SpecFuncMathMore.h"
+#include "TTree.h"
+#include "TChain.h"
+#include "TChainElement.h"
+#include "TFile.h"
+#include "TH1D.h"
 
 #include <numeric>
+#include <algorithm>
+#include <iomanip>
+#include <memory>
 
 using namespace std;
 using namespace ant;
 using namespace ant::analysis::utils;
 
 const string MCWeighting::treeName = "MCWeighting";
+const string MCWeighting::sumsName = "MCWeighting_Sums";
 
 // data for the EtaPrime was copied from P.Adlarson code
 // but actually merged from provided files by mail (uses Sergey's original binning not Viktors bin center positions
@@ -88,6 +94,26 @@ MCWeighting::MCWeighting(const HistogramFactory& histFac, const item_t& item) :
     Item(item),
     HistFac(histFac)
 {
+    const auto& db = Item.Database;
+    if(db.size()<2)
+        throw Exception("Database coefficients must have at least two energy bins for linear interpolation");
+
+    for(auto& c : db) {
+        beamE_centers.push_back(c.BeamE.Center());
+        nCoefficients = max<unsigned>(nCoefficients, c.LegendreCoefficients.size());
+    }
+
+    auto padded = [] (const coefficients_t& c, unsigned l) {
+        return l<c.LegendreCoefficients.size() ? c.LegendreCoefficients[l] : 0.0;
+    };
+
+    for(auto i=0u;i<db.size()-1;i++) {
+        const auto dE = beamE_centers[i+1] - beamE_centers[i];
+        for(auto l=0u;l<nCoefficients;l++) {
+            coeffs_lo.push_back(padded(db[i], l));
+            coeffs_slope.push_back((padded(db[i+1], l) - padded(db[i], l))/dE);
+        }
+    }
 }
 
 MCWeighting::database_t MCWeighting::SanitizeDatabase(database_t d)
@@ -126,45 +152,28 @@ double MCWeighting::GetCosTheta(const TParticleTree_t& tree)
 
 double MCWeighting::GetN(const double beamE, const double cosTheta) const
 {
-    // database coefficients are sorted in ascending BeamE
-    // find the first item which has larger beamE
-    const auto& db = Item.Database;
-    using it_t = vector<coefficients_t>::const_iterator;
-    it_t it_coeff_hi = std::find_if(db.begin(), db.end(),
-                                    [beamE] (const coefficients_t& c) { return c.BeamE.Center() > beamE; });
-
-    // handle corner cases of extrapolation
-    if(it_coeff_hi == db.begin()) {
-        // beamE smaller than all entries
-        it_coeff_hi = std::next(db.begin());
-    }
-    else if(it_coeff_hi == db.end()) {
-        // beamE larger than all entries
-        it_coeff_hi = std::prev(it_coeff_hi);
+    // find the pair of neighbouring energy bins around beamE,
+    // use the first/last pair for extrapolation
+    const auto it_hi = std::upper_bound(beamE_centers.begin(), beamE_centers.end(), beamE);
+    const auto i = std::min<size_t>(std::max<ptrdiff_t>(it_hi - beamE_centers.begin(), 1) - 1,
+                                    beamE_centers.size() - 2);
+    const double dE = beamE - beamE_centers[i];
+
+    // sum the linearly interpolated coefficients times the Legendre polynomials,
+    // which are obtained with Bonnet's recursion (P_0 = 1, P_1 = x)
+    const double* c_lo = &coeffs_lo[i*nCoefficients];
+    const double* c_slope = &coeffs_slope[i*nCoefficients];
+    const double x = cosTheta;
+    double P_prev = 0.0;
+    double P = 1.0;
+    double N = 0;
+    for(auto l=0u;l<nCoefficients;l++) {
+        N += (c_lo[l] + c_slope[l]*dE)*P;
+        const double P_next = ((2*l+1)*x*P - l*P_prev)/(l+1);
+        P_prev = P;
+        P = P_next;
     }
-
-    // get linearly interpolated legendre coefficients
-    auto it_coeff_lo = std::prev(it_coeff_hi);
-
-    // calculate N_lo / N_hi
-    auto get_N = [cosTheta] (const it_t& it_coeff) {
-        auto& coeffs = it_coeff->LegendreCoefficients;
-        double sum = 0;
-        for(auto l=0u;l<coeffs.size();l++)
-            sum += coeffs[l]*ROOT::Math::legendre(l, cosTheta);
-        return sum;
-    };
-
-    const double beamE_lo = it_coeff_lo->BeamE.Center();
-    const double beamE_hi = it_coeff_hi->BeamE.Center();
-    const double N_lo = get_N(it_coeff_lo);
-    const double N_hi = get_N(it_coeff_hi);
-
-    // slope
-    const double m = (N_hi - N_lo)/(beamE_hi - beamE_lo);
-
-    // calc energy-interpolated N
-    return N_lo + m*(beamE - beamE_lo);
+    return N;
 }
 
 void MCWeighting::SetParticleTree(const TParticleTree_t& tree)
@@ -174,7 +183,7 @@ void MCWeighting::SetParticleTree(const TParticleTree_t& tree)
 
     // lazy init of tree
     if(t.Tree == nullptr)
-        t.CreateBranches(HistFac.makeTTree(treeName+"_UNFINISHED"));
+        t.CreateBranches(HistFac.makeTTree(treeName));
 
     // check if it the specified meson was produced
     if(ParticleTools::FindParticle(Item.Type, tree, 1) &&
@@ -193,7 +202,7 @@ void MCWeighting::Fill()
     if(!t.Tree)
         return;
 
-    t.MCWeight = last_N;
+    t.MCWeightRaw = last_N;
     t.Tree->Fill();
 }
 
@@ -202,36 +211,74 @@ void MCWeighting::Finish()
     if(!t.Tree)
         return;
 
-    tree_t t_norm;
-    t_norm.CreateBranches(HistFac.makeTTree(treeName));
-
-    for(auto entry = 0;entry<t.Tree->GetEntries(); entry++) {
-        t.Tree->GetEntry(entry);
-        t_norm.MCWeight = isfinite(t.MCWeight) ? (t.MCWeight * nParticleTrees)/N_sum : 1.0;
-        t_norm.Tree->Fill();
-    }
-
-    // dispose temp tree
-    delete t.Tree;
-    t.Tree = nullptr;
-
-    // remember tree for possible friending
-    treeWeighted = t_norm.Tree;
+    // the weights are normalized when reading the tree, by tree_t::GetWeight() or the alias,
+    // so only the sums are stored (which can be merged by hadd)
+    auto h_sums = HistFac.makeTH1D("MCWeighting sums", "", "", BinSettings(2), sumsName);
+    h_sums->SetBinContent(1, nParticleTrees);
+    h_sums->SetBinContent(2, N_sum);
+    normalization = nParticleTrees/N_sum;
 }
 
 bool MCWeighting::FriendTTree(TTree* tree)
 {
-    if(treeWeighted) {
-        tree->AddFriend(treeWeighted, "", kTRUE);
+    if(isfinite(normalization)) {
+        tree->AddFriend(t.Tree, "", kTRUE);
+        tree->SetAlias("MCWeight", MakeAlias(normalization).c_str());
         return true;
     }
     return false;
 }
 
+string MCWeighting::MakeAlias(double normalization)
+{
+    return std_ext::formatter()
+            << std::setprecision(17)
+            << "(MCWeightRaw==MCWeightRaw ? " << normalization << "*MCWeightRaw : 1)";
+}
 
+void MCWeighting::tree_t::ReadNormalization()
+{
+    // older versions wrote the normalized weight
+    if(!MCWeightRaw.IsPresent) {
+        Normalization = 1.0;
+        return;
+    }
 
+    double nParticleTrees = 0;
+    double N_sum = 0;
+    auto add_sums = [&nParticleTrees, &N_sum] (TDirectory* dir, const string& dirname) {
+        TH1* h_sums = nullptr;
+        if(dir)
+            dir->GetObject(sumsName.c_str(), h_sums);
+        if(!h_sums)
+            throw Exception(std_ext::formatter() << "Did not find " << sumsName << " in " << dirname);
+        nParticleTrees += h_sums->GetBinContent(1);
+        N_sum += h_sums->GetBinContent(2);
+    };
 
+    if(auto chain = dynamic_cast<TChain*>(Tree)) {
+        // the sums are next to the tree in each file of the chain
+        TIter next(chain->GetListOfFiles());
+        while(auto element = dynamic_cast<TChainElement*>(next())) {
+            const string filename = element->GetTitle();
+            string treename = element->GetName();
+            const auto slash = treename.rfind('/');
+            const string dirname = slash == string::npos ? "" : treename.substr(0, slash);
+            unique_ptr<TFile> file(TFile::Open(filename.c_str()));
+            if(!file || file->IsZombie())
+                throw Exception("Cannot open "+filename);
+            add_sums(dirname.empty() ? file.get() : file->GetDirectory(dirname.c_str()), filename+":"+dirname);
+        }
+    }
+    else {
+        add_sums(Tree->GetDirectory(), Tree->GetName());
+    }
 
+    Normalization = nParticleTrees/N_sum;
+}
 
-
-
+void MCWeighting::tree_t::SetAlias(TTree* tree) const
+{
+    if(MCWeightRaw.IsPresent)
+        tree->SetAlias("MCWeight", MakeAlias(Normalization).c_str());
+}
@@ -6,6 +6,7 @@
 
 #include <vector>
 #include <map>
+#include <cmath>
 
 namespace ant {
 namespace analysis {
@@ -45,12 +46,15 @@ public:
     // usage of those methods is tricky...see also test/TestMCWeighting physics class
     // 1) SetParticleTree should be called for each event encountered
     // 2) Fill() should be called everytime a tree is filled with "physics" results
-    // 3) Finish() must be called after no more Fill/SetParticleTree are done
+    // 3) Finish() must be called after no more Fill/SetParticleTree are done,
+    //    it stores the sums for the normalization next to the tree, the raw weights are not rewritten
     void SetParticleTree(const TParticleTree_t& tree);
     void Fill();
     void Finish();
 
-    // can be used to access the "internal" MCWeights tree
+    // can be used to access the "internal" MCWeights tree after Finish(),
+    // the friended tree provides the normalized weight as alias "MCWeight" to the given tree
+    // (normalized with the events of this run only, use tree_t::SetAlias for merged files)
     // alternatively, get the tree by its name MCWeighting::treeName
     bool FriendTTree(TTree* tree);
 
@@ -60,10 +64,33 @@ public:
 
     struct tree_t : WrapTTree {
         // use "unique" branch name to make it easy to friend
-        // this TTree
-        ADD_BRANCH_T(double, MCWeight)
+        // this TTree, NaN if the event did not contain the meson
+        ADD_BRANCH_OPT_T(double, MCWeightRaw)
+
+        // already normalized weight written by older versions
+        ADD_BRANCH_OPT_T(double, MCWeight)
+
+        // obtained from the histogram MCWeighting::sumsName next to the tree,
+        // summed over all files of a TChain, call ReadNormalization() after linking the branches
+        double Normalization = 1.0;
+        void ReadNormalization();
+
+        // sets the alias "MCWeight" for the normalized weight on the given tree,
+        // which must have this tree as friend
+        void SetAlias(TTree* tree) const;
+
+        double GetWeight() const {
+            if(!MCWeightRaw.IsPresent)
+                return MCWeight;
+            const double N = MCWeightRaw;
+            return IsWeighted(N) ? Normalization*N : 1.0;
+        }
     };
 
+    // histogram with the number of weighted events in the first bin and the sum of their raw weights in the second,
+    // is merged by hadd in contrast to the normalization itself
+    static const std::string sumsName;
+
 //protected:
 
     static database_t SanitizeDatabase(database_t d);
@@ -74,13 +101,30 @@ public:
 
     const item_t& Item;
 
+    // tabulated from Item.Database for GetN: the centers of the beam energy bins,
+    // and for each pair of neighbouring bins the Legendre coefficients at the lower center
+    // and their slope in beam energy, each padded to nCoefficients
+    std::vector<double> beamE_centers;
+    std::vector<double> coeffs_lo;
+    std::vector<double> coeffs_slope;
+    unsigned nCoefficients = 0;
+
     unsigned nParticleTrees = 0;
     double N_sum = 0;
     double last_N = std_ext::NaN;
 
+    struct rawtree_t : WrapTTree {
+        ADD_BRANCH_T(double, MCWeightRaw)
+    };
+
+    // events without the meson have NaN as raw weight,
+    // same check as in the alias (NaN is the only value not equal to itself)
+    static bool IsWeighted(double N) { return !std::isnan(N); }
+    static std::string MakeAlias(double normalization);
+
     HistogramFactory HistFac;
-    tree_t t;
-    TTree* treeWeighted = nullptr;
+    rawtree_t t;
+    double normalization = std_ext::NaN;
 };
 
 }
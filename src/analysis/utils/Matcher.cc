@@ -0,0 +1,144 @@
+#include "Matcher.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::utils;
+
+void AssignmentMatcher::Solve()
+{
+    result.clear();
+    if(n_rows == 0 || n_cols == 0)
+        return;
+
+    if(Mode == mode_t::Greedy)
+        SolveGreedy();
+    else
+        SolveOptimal();
+
+    sort(result.begin(), result.end(), [] (const index_match_t& a, const index_match_t& b) {
+        return a.score < b.score;
+    });
+}
+
+void AssignmentMatcher::SolveGreedy()
+{
+    // the index into the cost matrix resembles the order
+    // in which match1to1 builds its list, and breaking ties by index
+    // makes the unstable sort behave like std::list::sort
+    order.clear();
+    for(size_t i=0;i<costs.size();i++) {
+        if(allowed(costs[i]))
+            order.push_back(i);
+    }
+
+    sort(order.begin(), order.end(), [this] (size_t a, size_t b) {
+        if(costs[a] == costs[b])
+            return a < b;
+        return costs[a] < costs[b];
+    });
+
+    used_rows.assign(n_rows, false);
+    used_cols.assign(n_cols, false);
+
+    for(auto i : order) {
+        const auto row = i / n_cols;
+        const auto col = i % n_cols;
+        if(used_rows[row] || used_cols[col])
+            continue;
+        used_rows[row] = true;
+        used_cols[col] = true;
+        result.push_back({costs[i], row, col});
+        if(result.size() == min(n_rows, n_cols))
+            break;
+    }
+}
+
+void AssignmentMatcher::SolveOptimal()
+{
+    // the Hungarian method needs n <= m,
+    // so transpose the cost matrix if necessary
+    const bool transposed = n_rows > n_cols;
+    const auto n = transposed ? n_cols : n_rows;
+    const auto m = transposed ? n_rows : n_cols;
+
+    // scores outside the window get a cost so high that using one
+    // is always worse than any assignment with more allowed pairs
+    auto min_cost = std_ext::inf;
+    auto max_cost = -std_ext::inf;
+    for(auto c : costs) {
+        if(!allowed(c))
+            continue;
+        min_cost = std::min(min_cost, c);
+        max_cost = std::max(max_cost, c);
+    }
+    if(!isfinite(min_cost))
+        return; // nothing can be matched
+    const double forbidden = (max_cost - min_cost)*n + 1.0;
+
+    auto cost = [this, transposed, min_cost, forbidden] (size_t i, size_t j) {
+        const auto c = transposed ? costs[j*n_cols+i] : costs[i*n_cols+j];
+        return allowed(c) ? c - min_cost : forbidden;
+    };
+
+    // indices are shifted by one, zero is used as a sentinel
+    constexpr auto none = std::numeric_limits<size_t>::max();
+    u.assign(n+1, 0.0);
+    v.assign(m+1, 0.0);
+    p.assign(m+1, 0);
+    way.assign(m+1, 0);
+
+    for(size_t i=1;i<=n;i++) {
+        p[0] = i;
+        size_t j0 = 0;
+        minv.assign(m+1, std_ext::inf);
+        used.assign(m+1, false);
+        do {
+            used[j0] = true;
+            const auto i0 = p[j0];
+            auto delta = std_ext::inf;
+            size_t j1 = none;
+            for(size_t j=1;j<=m;j++) {
+                if(used[j])
+                    continue;
+                const auto cur = cost(i0-1, j-1) - u[i0] - v[j];
+                if(cur < minv[j]) {
+                    minv[j] = cur;
+                    way[j] = j0;
+                }
+                if(minv[j] < delta) {
+                    delta = minv[j];
+                    j1 = j;
+                }
+            }
+            for(size_t j=0;j<=m;j++) {
+                if(used[j]) {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                }
+                else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        }
+        while(p[j0] != 0);
+
+        // augment along the found path
+        do {
+            const auto j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        }
+        while(j0 != 0);
+    }
+
+    for(size_t j=1;j<=m;j++) {
+        if(p[j] == 0)
+            continue;
+        const auto row = transposed ? j-1 : p[j]-1;
+        const auto col = transposed ? p[j]-1 : j-1;
+        const auto c = costs[row*n_cols+col];
+        if(allowed(c))
+            result.push_back({c, row, col});
+    }
+}
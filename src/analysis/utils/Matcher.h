@@ -3,6 +3,8 @@
 #include <list>
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <cmath>
 
 #include "base/interval.h"
 #include "base/std_ext/math.h"
@@ -27,6 +29,9 @@ static double matchDistance( const T& a, const T& b ) {
 
 template <typename T1, typename T2>
 struct scored_match {
+    using first_type  = T1;
+    using second_type = T2;
+
     double score;
     T1 a;
     T2 b;
@@ -98,20 +103,20 @@ std::list< scored_match<typename List1::value_type, typename List2::value_type>
     return scores;
 }
 
-template <typename T1, typename T2>
-T2 FindMatched(const std::list<utils::scored_match<T1,T2>>& l, const T1& f) {
+template <typename Matches>
+typename Matches::value_type::second_type FindMatched(const Matches& l, const typename Matches::value_type::first_type& f) {
     for( const auto& i : l ) {
         if( i.a == f) {
             return i.b;
         }
     }
-    return T2();
+    return typename Matches::value_type::second_type();
 }
 
 // this method returns a list of particles
 // which are not in the in the scored list
-template <typename T1, typename T2>
-std::vector<T2> FindUnmatched(const std::list<utils::scored_match<T1,T2>>& l, const std::vector<T2>& f) {
+template <typename Matches, typename T2>
+std::vector<T2> FindUnmatched(const Matches& l, const std::vector<T2>& f) {
     std::vector<T2> unmatched;
     for( const auto& i : f ) { // loop over std::vector<T2>
         bool found = false;
@@ -129,7 +134,6 @@ std::vector<T2> FindUnmatched(const std::list<utils::scored_match<T1,T2>>& l, co
 };
 
 
-
 struct matchpair {
     size_t a;
     size_t b;
@@ -204,6 +208,130 @@ std::vector<matchpair>match2(const List1& list1,
 }
 
 
+/**
+ * @brief The AssignmentMatcher class matches two lists by a score, like match1to1
+ *
+ * The cost matrix and the solver workspace are kept between calls,
+ * so a matcher kept as a member of a physics class does not allocate in steady state.
+ *
+ * mode_t::Greedy takes the best scoring pairs first, exactly as match1to1 does,
+ * including infinite scores inside the score window.
+ * mode_t::Optimal solves the assignment problem (Hungarian method), i.e. it finds
+ * the maximum number of pairs inside the score window and, among those,
+ * the ones with the minimal sum of scores. Infinite scores cannot be summed,
+ * so in contrast to match1to1 such pairs are never matched.
+ */
+class AssignmentMatcher {
+public:
+    enum class mode_t {
+        Greedy, Optimal
+    };
+
+    struct index_match_t {
+        double score;
+        std::size_t a; // index into list1
+        std::size_t b; // index into list2
+    };
+
+    explicit AssignmentMatcher(mode_t mode = mode_t::Optimal,
+                               const IntervalD& score_window = IntervalD(-std_ext::inf, std_ext::inf)) :
+        Mode(mode), ScoreWindow(score_window)
+    {}
+
+    mode_t Mode;
+    IntervalD ScoreWindow;
+
+    /**
+     * @brief MatchIndices finds the pairs of indices of list1 and list2
+     * @return matched pairs sorted by score, valid until the next call
+     */
+    template <class MatchFunction, typename List1, typename List2>
+    const std::vector<index_match_t>& MatchIndices(const List1& list1, const List2& list2, MatchFunction f) {
+        n_rows = list1.size();
+        n_cols = list2.size();
+        costs.resize(n_rows*n_cols);
+        auto c = costs.begin();
+        for(const auto& i : list1)
+            for(const auto& j : list2)
+                *c++ = f(i,j);
+        Solve();
+        return result;
+    }
+
+    /**
+     * @brief Match fills the matched elements into matches, same as match1to1 does
+     * @param matches cleared before, keep it between calls to avoid allocations
+     *
+     * The matched pairs are sorted by score.
+     */
+    template <class MatchFunction, typename List1, typename List2>
+    void Match(const List1& list1, const List2& list2, MatchFunction f,
+               std::vector< scored_match<typename List1::value_type, typename List2::value_type> >& matches) {
+        using T1 = typename List1::value_type;
+        using T2 = typename List2::value_type;
+
+        MatchIndices(list1, list2, f);
+
+        // index the lists once, they are not necessarily random access
+        ptr1.clear();
+        for(const auto& i : list1)
+            ptr1.push_back(std::addressof(i));
+        ptr2.clear();
+        for(const auto& j : list2)
+            ptr2.push_back(std::addressof(j));
+
+        matches.clear();
+        for(const auto& m : result)
+            matches.push_back({m.score,
+                               *static_cast<const T1*>(ptr1[m.a]),
+                               *static_cast<const T2*>(ptr2[m.b])});
+    }
+
+    /**
+     * @brief Match returns the matched elements, same as match1to1 does
+     * @return matched pairs sorted by score, allocated for each call
+     */
+    template <class MatchFunction, typename List1, typename List2>
+    std::vector< scored_match<typename List1::value_type, typename List2::value_type> >
+    Match(const List1& list1, const List2& list2, MatchFunction f) {
+        std::vector< scored_match<typename List1::value_type, typename List2::value_type> > matches;
+        Match(list1, list2, f, matches);
+        return matches;
+    }
+
+protected:
+    std::size_t n_rows = 0;
+    std::size_t n_cols = 0;
+    std::vector<double> costs; // row-major, n_rows x n_cols
+    std::vector<index_match_t> result;
+
+    // elements of the lists given to Match
+    std::vector<const void*> ptr1;
+    std::vector<const void*> ptr2;
+
+    // workspace for greedy
+    std::vector<std::size_t> order;
+    std::vector<bool> used_rows;
+    std::vector<bool> used_cols;
+
+    // workspace for Hungarian method
+    std::vector<double> u;
+    std::vector<double> v;
+    std::vector<double> minv;
+    std::vector<std::size_t> p;
+    std::vector<std::size_t> way;
+    std::vector<bool> used;
+
+    // NaN is never inside the window
+    bool allowed(double score) const {
+        if(Mode == mode_t::Optimal && !std::isfinite(score))
+            return false;
+        return ScoreWindow.Contains(score);
+    }
 
+    void Solve();
+    void SolveGreedy();
+    void SolveOptimal();
+};
 
 }}} // namespace ant::analysis::utils
@@ -3,11 +3,15 @@
 #include "tree/TParticle.h"
 
 #include "base/std_ext/system.h"
+#include "base/std_ext/arena.h"
 #include "base/WrapTFile.h"
 #include "base/Logger.h"
 
 #include "TCutG.h"
 
+#include <algorithm>
+#include <cmath>
+
 
 using namespace std;
 using namespace ant;
@@ -21,12 +25,20 @@ TParticlePtr ParticleID::Process(const TCandidatePtr& cand) const
 {
     auto type = Identify(cand);
     if(type !=nullptr) {
-       return std::make_shared<TParticle>(*type, cand);
+       return std_ext::make_arena_shared<TParticle>(*type, cand);
     }
 
     return nullptr;
 }
 
+void ParticleID::Identify(const TCandidateList& cands, types_t& types) const
+{
+    types.resize(0);
+    types.reserve(cands.size());
+    for(auto cand : cands.get_iter())
+        types.push_back(Identify(cand));
+}
+
 std::unique_ptr<const ParticleID> ParticleID::default_particle_id = nullptr;
 
 const ParticleID& ParticleID::GetDefault()
@@ -53,6 +65,125 @@ const ParticleTypeDatabase::Type* SimpleParticleID::Identify(const TCandidatePtr
         return addressof(ParticleTypeDatabase::Photon);
 }
 
+// true if the segment (x0,y0)-(x1,y1) touches the box [bx0,bx1]x[by0,by1],
+// clips the segment's parameter range like Liang-Barsky
+bool SegmentTouchesBox(double x0, double y0, double x1, double y1,
+                       double bx0, double by0, double bx1, double by1)
+{
+    double t0 = 0, t1 = 1;
+    auto clip = [&t0, &t1] (double p, double q) {
+        if(p == 0)
+            return q >= 0;
+        const double r = q/p;
+        if(p < 0) {
+            if(r > t1)
+                return false;
+            t0 = std::max(t0, r);
+        }
+        else {
+            if(r < t0)
+                return false;
+            t1 = std::min(t1, r);
+        }
+        return true;
+    };
+    const double dx = x1 - x0;
+    const double dy = y1 - y0;
+    return clip(-dx, x0 - bx0) && clip(dx, bx1 - x0)
+            && clip(-dy, y0 - by0) && clip(dy, by1 - y0);
+}
+
+RasterizedCut::RasterizedCut(const std::shared_ptr<TCutG>& cut_, unsigned nBinsX, unsigned nBinsY) :
+    cut(cut_),
+    nx(nBinsX),
+    ny(nBinsY),
+    cells(nx*ny, cell_t::Outside)
+{
+    if(!cut)
+        throw runtime_error("Cannot rasterize non-existing cut");
+    if(nx == 0 || ny == 0)
+        throw runtime_error("Cannot rasterize cut without bins");
+
+    const int n = cut->GetN();
+    const double* px = cut->GetX();
+    const double* py = cut->GetY();
+
+    if(n == 0) {
+        xmin = ymin = 0;
+        xscale = yscale = 1;
+        return;
+    }
+
+    // the grid covers the bounding box with a margin of half a cell,
+    // so everything outside the grid is outside the cut
+    auto setup_axis = [] (const double* p, int n, unsigned nbins, double& min, double& scale) {
+        const auto minmax = std::minmax_element(p, p+n);
+        double width = *minmax.second - *minmax.first;
+        if(!(width > 0))
+            width = 1.0;
+        min = *minmax.first - width/(2*nbins);
+        scale = nbins/(width*(nbins+1)/nbins);
+    };
+    setup_axis(px, n, nx, xmin, xscale);
+    setup_axis(py, n, ny, ymin, yscale);
+
+    // mark the cells touched by the polygon edges, including the closing edge,
+    // the cells are slightly enlarged to be safe against rounding
+    const double eps = 1e-6;
+    for(int i=0;i<n;i++) {
+        const int j = (i+1) % n;
+        const double x0 = (px[i] - xmin)*xscale;
+        const double y0 = (py[i] - ymin)*yscale;
+        const double x1 = (px[j] - xmin)*xscale;
+        const double y1 = (py[j] - ymin)*yscale;
+        auto bin_range = [eps] (double a, double b, unsigned nbins, unsigned& first, unsigned& last) {
+            first = static_cast<unsigned>(std::max(0.0, std::floor(std::min(a, b) - eps)));
+            last  = static_cast<unsigned>(std::max(0.0, std::min<double>(nbins-1, std::floor(std::max(a, b) + eps))));
+        };
+        unsigned bx_first, bx_last, by_first, by_last;
+        bin_range(x0, x1, nx, bx_first, bx_last);
+        bin_range(y0, y1, ny, by_first, by_last);
+        for(unsigned by=by_first;by<=by_last;by++) {
+            for(unsigned bx=bx_first;bx<=bx_last;bx++) {
+                if(SegmentTouchesBox(x0, y0, x1, y1, bx-eps, by-eps, bx+1+eps, by+1+eps))
+                    cells[by*nx+bx] = cell_t::Boundary;
+            }
+        }
+    }
+
+    // all other cells are either completely inside or outside,
+    // and neighbouring cells in a row only differ if there's a boundary cell between them
+    for(unsigned by=0;by<ny;by++) {
+        bool known = false;
+        cell_t status = cell_t::Outside;
+        for(unsigned bx=0;bx<nx;bx++) {
+            cell_t& cell = cells[by*nx+bx];
+            if(cell == cell_t::Boundary) {
+                known = false;
+                continue;
+            }
+            if(!known) {
+                const double x = xmin + (bx+0.5)/xscale;
+                const double y = ymin + (by+0.5)/yscale;
+                status = IsInsideExact(x, y) ? cell_t::Inside : cell_t::Outside;
+                known = true;
+            }
+            cell = status;
+        }
+    }
+}
+
+double RasterizedCut::BoundaryFraction() const
+{
+    const auto nBoundary = std::count(cells.begin(), cells.end(), cell_t::Boundary);
+    return double(nBoundary)/cells.size();
+}
+
+bool RasterizedCut::IsInsideExact(double x, double y) const
+{
+    return cut->IsInside(x, y);
+}
+
 BasicParticleID::BasicParticleID() {}
 
 BasicParticleID::~BasicParticleID()
@@ -60,16 +191,41 @@ BasicParticleID::~BasicParticleID()
 
 }
 
-bool TestCut(const std::shared_ptr<TCutG>& cut, const double& x, const double& y) {
-    return (cut) && cut->IsInside(x,y);
+void BasicParticleID::Rasterize(unsigned resolution)
+{
+    auto make_raster = [resolution] (const std::shared_ptr<TCutG>& cut) {
+        std::shared_ptr<const RasterizedCut> raster;
+        if(cut && resolution > 0) {
+            raster = std::make_shared<RasterizedCut>(cut, resolution, resolution);
+            VLOG(7) << "Rasterized cut " << cut->GetName() << ", fraction of boundary cells "
+                    << raster->BoundaryFraction();
+        }
+        return raster;
+    };
+    raster_dEE_proton   = make_raster(dEE_proton);
+    raster_dEE_pion     = make_raster(dEE_pion);
+    raster_dEE_electron = make_raster(dEE_electron);
+    raster_tof          = make_raster(tof);
+    raster_size         = make_raster(size);
+}
+
+bool TestCut(const std::shared_ptr<TCutG>& cut, const std::shared_ptr<const RasterizedCut>& raster,
+             const double& x, const double& y) {
+    if(!cut)
+        return false;
+    // use raster only if cut was not replaced since rasterization,
+    // in-place changes need a new Rasterize call (checking the points would cost as much as the exact test)
+    if(raster && raster->GetCut() == cut.get())
+        return raster->IsInside(x,y);
+    return cut->IsInside(x,y);
 }
 
 
 
 const ParticleTypeDatabase::Type* BasicParticleID::Identify(const TCandidatePtr& cand) const
 {
-    const bool hadronic =    TestCut(tof,  cand->CaloEnergy, cand->Time)
-                  || TestCut(size, cand->CaloEnergy, cand->ClusterSize);
+    const bool hadronic =    TestCut(tof, raster_tof,  cand->CaloEnergy, cand->Time)
+                  || TestCut(size, raster_size, cand->CaloEnergy, cand->ClusterSize);
 
     const bool hadronic_enabled = (tof) || (size);
 
@@ -89,19 +245,19 @@ const ParticleTypeDatabase::Type* BasicParticleID::Identify(const TCandidatePtr&
 
         if(
            (hadronic_enabled && hadronic)
-           || (TestCut(dEE_proton, cand->CaloEnergy, cand->VetoEnergy))
+           || (TestCut(dEE_proton, raster_dEE_proton, cand->CaloEnergy, cand->VetoEnergy))
            ) {
             return addressof(ParticleTypeDatabase::Proton);
         }
 
         if(
-           TestCut(dEE_pion, cand->CaloEnergy, cand->VetoEnergy)
+           TestCut(dEE_pion, raster_dEE_pion, cand->CaloEnergy, cand->VetoEnergy)
            ) {
             return addressof(ParticleTypeDatabase::PiCharged);
         }
 
         if(
-           TestCut(dEE_electron, cand->CaloEnergy, cand->VetoEnergy)
+           TestCut(dEE_electron, raster_dEE_electron, cand->CaloEnergy, cand->VetoEnergy)
            ) {
             return addressof(ParticleTypeDatabase::eCharged);
         }
@@ -113,7 +269,7 @@ const ParticleTypeDatabase::Type* BasicParticleID::Identify(const TCandidatePtr&
 
 
 
-CBTAPSBasicParticleID::CBTAPSBasicParticleID(const string& pidcutsdir)
+CBTAPSBasicParticleID::CBTAPSBasicParticleID(const string& pidcutsdir, unsigned resolution)
 {
     try {
         WrapTFileInput cuts;
@@ -128,6 +284,8 @@ CBTAPSBasicParticleID::CBTAPSBasicParticleID(const string& pidcutsdir)
             }
         }
         LoadFrom(cuts);
+        cb.Rasterize(resolution);
+        taps.Rasterize(resolution);
     } catch (const std::runtime_error& e) {
         LOG(INFO) << "Failed to load cuts: " << e.what();
     }
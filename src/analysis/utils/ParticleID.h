@@ -4,6 +4,8 @@
 #include "base/ParticleType.h"
 
 #include <memory>
+#include <vector>
+#include <cstdint>
 
 class TCutG;
 
@@ -22,6 +24,15 @@ public:
     virtual const ParticleTypeDatabase::Type* Identify(const TCandidatePtr& cand) const =0;
     virtual TParticlePtr Process(const TCandidatePtr& cand) const;
 
+    using types_t = std::vector<const ParticleTypeDatabase::Type*>;
+
+    /**
+     * @brief Identify all candidates at once
+     * @param cands candidates to identify
+     * @param types filled with the type of each candidate in the same order, nullptr if unidentified
+     */
+    virtual void Identify(const TCandidateList& cands, types_t& types) const;
+
     static const ParticleID& GetDefault();
     static void SetDefault(std::unique_ptr<const ParticleID> id);
 private:
@@ -35,10 +46,60 @@ public:
     virtual ~SimpleParticleID();
 
     virtual const ParticleTypeDatabase::Type* Identify(const TCandidatePtr& cand) const override;
+    using ParticleID::Identify;
 };
 
 
 
+/**
+ * @brief The RasterizedCut class precomputes TCutG::IsInside on a grid over the cut's bounding box
+ *
+ * Grid cells not touched by any edge of the polygon are entirely inside or outside,
+ * so only points in cells touched by an edge need the exact test of the polygon.
+ * The raster does not follow changes of the cut's points (e.g. by TCutG::SetPoint),
+ * build a new one after changing the cut.
+ */
+class RasterizedCut {
+public:
+    RasterizedCut(const std::shared_ptr<TCutG>& cut_, unsigned nBinsX, unsigned nBinsY);
+
+    bool IsInside(double x, double y) const {
+        const double fx = (x - xmin)*xscale;
+        const double fy = (y - ymin)*yscale;
+        // also false for NaN
+        if(!(fx >= 0 && fx < nx && fy >= 0 && fy < ny))
+            return false;
+        const cell_t cell = cells[static_cast<unsigned>(fy)*nx + static_cast<unsigned>(fx)];
+        if(cell == cell_t::Boundary)
+            return IsInsideExact(x, y);
+        return cell == cell_t::Inside;
+    }
+
+    const TCutG* GetCut() const { return cut.get(); }
+
+    /**
+     * @brief BoundaryFraction
+     * @return fraction of the grid cells which need the exact test
+     */
+    double BoundaryFraction() const;
+
+protected:
+    enum class cell_t : std::uint8_t {
+        Outside, Inside, Boundary
+    };
+
+    std::shared_ptr<TCutG> cut;
+    double xmin;
+    double ymin;
+    double xscale; // number of bins per unit
+    double yscale;
+    unsigned nx;
+    unsigned ny;
+    std::vector<cell_t> cells;
+
+    bool IsInsideExact(double x, double y) const;
+};
+
 class BasicParticleID: public ParticleID {
 public:
     BasicParticleID();
@@ -52,7 +113,24 @@ public:
 
     std::shared_ptr<TCutG> size;
 
+    /**
+     * @brief Rasterize the currently set cuts, a cut replaced afterwards is tested exactly again
+     * @param resolution number of grid cells along each axis, zero uses the exact cuts again
+     *
+     * Changing the points of a set cut in place is not detected, call Rasterize again afterwards.
+     */
+    void Rasterize(unsigned resolution);
+
     virtual const ParticleTypeDatabase::Type* Identify(const TCandidatePtr& cand) const override;
+    using ParticleID::Identify;
+
+protected:
+    // rasterized versions of the cuts above, only used as long as the cut is not replaced
+    std::shared_ptr<const RasterizedCut> raster_dEE_proton;
+    std::shared_ptr<const RasterizedCut> raster_dEE_pion;
+    std::shared_ptr<const RasterizedCut> raster_dEE_electron;
+    std::shared_ptr<const RasterizedCut> raster_tof;
+    std::shared_ptr<const RasterizedCut> raster_size;
 };
 
 class CBTAPSBasicParticleID: public ParticleID {
@@ -62,10 +140,16 @@ protected:
     virtual void LoadFrom(WrapTFile& file);
 
 public:
-    CBTAPSBasicParticleID(const std::string& pidcutsdir);
+    /**
+     * @brief CBTAPSBasicParticleID loads the cuts from the given directory
+     * @param pidcutsdir the directory to look for *.root files containing the cuts
+     * @param resolution the cuts are rasterized with this number of cells along each axis, zero disables it
+     */
+    CBTAPSBasicParticleID(const std::string& pidcutsdir, unsigned resolution = 512);
     virtual ~CBTAPSBasicParticleID();
 
     virtual const ParticleTypeDatabase::Type* Identify(const TCandidatePtr& cand) const override;
+    using ParticleID::Identify;
 };
 
 }
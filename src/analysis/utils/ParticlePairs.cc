@@ -0,0 +1,44 @@
+#include "ParticlePairs.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::utils;
+
+void ParticlePairs::Set(const vector<LorentzVec>& lvs_)
+{
+    lvs = lvs_;
+    Fill();
+}
+
+void ParticlePairs::Set(const TParticleList& particles)
+{
+    lvs.clear();
+    for(const auto& p : particles)
+        lvs.emplace_back(*p);
+    Fill();
+}
+
+void ParticlePairs::SetPhotons(const TCandidateList& cands)
+{
+    lvs.clear();
+    for(const auto& c : cands)
+        lvs.emplace_back(c.Direction*c.CaloEnergy, c.CaloEnergy);
+    Fill();
+}
+
+void ParticlePairs::Fill()
+{
+    n = lvs.size();
+    angles.resize(n*n);
+    ims.resize(n*n);
+    for(unsigned i=0;i<n;i++) {
+        angles[i*n+i] = 0;
+        ims[i*n+i] = lvs[i].M();
+        for(unsigned j=i+1;j<n;j++) {
+            const double angle = lvs[i].Angle(lvs[j]);
+            const double im = (lvs[i] + lvs[j]).M();
+            angles[i*n+j] = angles[j*n+i] = angle;
+            ims[i*n+j] = ims[j*n+i] = im;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "tree/TCandidate.h"
+#include "tree/TParticle.h"
+
+#include "base/vec/LorentzVec.h"
+
+#include <vector>
+
+namespace ant {
+namespace analysis {
+namespace utils {
+
+/**
+ * @brief The ParticlePairs class holds the opening angles and invariant masses of all pairs of an event
+ *
+ * Each pair is computed once in Set(), so analyses can query combinations repeatedly
+ * without redoing the trigonometry. The buffers are kept between events,
+ * so use one instance per physics class and call Set() for each event.
+ */
+class ParticlePairs {
+public:
+
+    void Set(const std::vector<LorentzVec>& lvs);
+    void Set(const TParticleList& particles);
+
+    /**
+     * @brief SetPhotons uses the candidates as photons with their cached directions
+     */
+    void SetPhotons(const TCandidateList& cands);
+
+    unsigned Size() const noexcept { return n; }
+
+    const LorentzVec& operator[](unsigned i) const noexcept { return lvs[i]; }
+
+    /**
+     * @brief OpeningAngle between i and j
+     * @return (radians), 0 for i==j
+     */
+    double OpeningAngle(unsigned i, unsigned j) const noexcept { return angles[i*n+j]; }
+
+    /**
+     * @brief IM of the sum of i and j
+     * @return invariant mass, for i==j the mass of i
+     */
+    double IM(unsigned i, unsigned j) const noexcept { return ims[i*n+j]; }
+
+protected:
+    unsigned n = 0;
+    std::vector<LorentzVec> lvs;
+    // symmetric n*n matrices
+    std::vector<double> angles;
+    std::vector<double> ims;
+
+    void Fill();
+};
+
+}}} // namespace ant::analysis::utils
@@ -3,6 +3,9 @@
 #include "base/Logger.h"
 #include "base/std_ext/map.h"
 
+#include <algorithm>
+#include <iterator>
+
 using namespace std;
 using namespace ant;
 using namespace ant::analysis::utils;
@@ -101,14 +104,74 @@ APLCON::Result_t KinFitter::DoFit(double ebeam, const TParticlePtr& proton, cons
 
     const auto& r = aplcon.DoFit(BeamE, Proton, Photons, Z_Vertex, constraintEnergyMomentum);
 
-    // tell the particles the z-vertex after fit
     if (r.Status==APLCON::Result_Status_t::Success && !isfinite( Z_Vertex.Value))
         throw Exception("Fitted Z-vertex not finite!");
+    FinishFit(r);
+
+    return r;
+}
+
+void KinFitter::PrepareEvent()
+{
+    eventPrepared = true;
+    preparedParticles.clear();
+    warmstarts.clear();
+}
+
+void KinFitter::FinishFit(const APLCON::Result_t& result)
+{
+    // tell the particles the z-vertex after fit
     Proton.SetFittedZVertex(Z_Vertex.Value);
     for(auto& photon : Photons)
         photon.SetFittedZVertex(Z_Vertex.Value);
 
-    return r;
+    // the next fit of this combination in this event starts from here
+    if(eventPrepared && result.Status == APLCON::Result_Status_t::Success) {
+        auto it = FindWarmstart();
+        if(it == warmstarts.end()) {
+            warmstart_t warmstart;
+            warmstart.Proton = Proton.Particle.get();
+            for(const auto& photon : Photons)
+                warmstart.Photons.push_back(photon.Particle.get());
+            warmstarts.emplace_back(move(warmstart));
+            it = std::prev(warmstarts.end());
+        }
+        it->Z_Vertex = Z_Vertex.Value;
+    }
+}
+
+std::vector<KinFitter::warmstart_t>::iterator KinFitter::FindWarmstart()
+{
+    // only the very same particles in the same order, fitted for another beam energy,
+    // may start from a previous fit, otherwise the results depend on the order of the fits
+    return std::find_if(warmstarts.begin(), warmstarts.end(), [this] (const warmstart_t& w) {
+        if(w.Proton != Proton.Particle.get() || w.Photons.size() != Photons.size())
+            return false;
+        for(size_t i=0;i<Photons.size();i++) {
+            if(w.Photons[i] != Photons[i].Particle.get())
+                return false;
+        }
+        return true;
+    });
+}
+
+void KinFitter::SetParticle(FitParticle& fitparticle, const TParticlePtr& particle)
+{
+    if(!eventPrepared) {
+        fitparticle.Set(particle, *Model);
+        return;
+    }
+
+    // the same particles are fitted again and again for each tagger hit (and permutation),
+    // the prepared ones hold the values just after Set() was called
+    auto it = std::find_if(preparedParticles.begin(), preparedParticles.end(),
+                           [&particle] (const FitParticle& p) { return p.Particle == particle; });
+    if(it != preparedParticles.end()) {
+        fitparticle = *it;
+        return;
+    }
+    fitparticle.Set(particle, *Model);
+    preparedParticles.emplace_back(fitparticle);
 }
 
 std::array<double, 4> KinFitter::constraintEnergyMomentum(
@@ -127,19 +190,20 @@ std::array<double, 4> KinFitter::constraintEnergyMomentum(
     return {diff.E, diff.p.x, diff.p.y, diff.p.z};
 }
 
-void KinFitter::PrepareFit(double ebeam, const TParticlePtr& proton, const TParticleList& photons)
+void KinFitter::PrepareFit(double ebeam, const TParticlePtr& proton, const TParticleList& photons,
+                           bool warmstart)
 {
     if(!Model) {
         throw Exception("No uncertainty provided in ctor or set with SetUncertaintyModel");
     }
 
     BeamE.SetValueSigma(ebeam, Model->GetBeamEnergySigma(ebeam));
-    Proton.Set(proton, *Model);
+    SetParticle(Proton, proton);
 
     Photons.resize(photons.size());
     LorentzVec photon_sum; // for proton's missing_E calculation later
     for ( unsigned i = 0 ; i < Photons.size() ; ++ i) {
-        Photons[i].Set(photons[i], *Model);
+        SetParticle(Photons[i], photons[i]);
         photon_sum += *photons[i];
     }
 
@@ -151,8 +215,10 @@ void KinFitter::PrepareFit(double ebeam, const TParticlePtr& proton, const TPart
 
         // if target length was set, calculate starting point for z vertex if parameter is unmeasured
         if(std::isfinite(Target.length)) {
-            if(IsZVertexUnmeasured())
-                Z_Vertex.Value = CalcZVertexStartingPoint();
+            if(IsZVertexUnmeasured()) {
+                auto it = warmstart ? FindWarmstart() : warmstarts.end();
+                Z_Vertex.Value = it != warmstarts.end() ? it->Z_Vertex : CalcZVertexStartingPoint();
+            }
         }
     }
 
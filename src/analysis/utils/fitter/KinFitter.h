@@ -38,15 +38,30 @@ public:
 
     APLCON::Result_t DoFit(double ebeam, const TParticlePtr& proton, const TParticleList& photons);
 
+    /**
+     * @brief PrepareEvent starts a new event for the following fits, typically called once before the tagger hit loop.
+     * Each particle is then set up only once (uncertainties, starting values), and fitting the very same
+     * proton and photons (in the same order) again for a further beam energy starts from their previously fitted z vertex.
+     * The particles must not be changed until the next call.
+     * @note without calling it once, every fit is set up from scratch
+     */
+    void PrepareEvent();
+
     void SetUncertaintyModel(const UncertaintyModelPtr& uncertainty_model) {
         Model = uncertainty_model;
+        preparedParticles.clear();
     }
 
 protected:
 
+    // warmstart=false always calculates the z vertex starting point from scratch
     void PrepareFit(double ebeam,
                     const TParticlePtr& proton,
-                    const TParticleList& photons);
+                    const TParticleList& photons,
+                    bool warmstart = true);
+
+    // tells the particles the fitted z vertex
+    void FinishFit(const APLCON::Result_t& result);
 
 
     struct BeamE_t : V_S_P_t {
@@ -86,6 +101,21 @@ protected:
 
 private:
     UncertaintyModelPtr Model;
+
+    void SetParticle(FitParticle& fitparticle, const TParticlePtr& particle);
+
+    // used after PrepareEvent was called
+    bool eventPrepared = false;
+    std::vector<FitParticle> preparedParticles;
+
+    // fitted z vertex for each combination of proton and photons in this event
+    struct warmstart_t {
+        const TParticle* Proton;
+        std::vector<const TParticle*> Photons;
+        double Z_Vertex;
+    };
+    std::vector<warmstart_t> warmstarts;
+    std::vector<warmstart_t>::iterator FindWarmstart();
 };
 
 }}} // namespace ant::analysis::utils
\ No newline at end of file
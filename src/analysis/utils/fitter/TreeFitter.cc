@@ -103,7 +103,7 @@ void TreeFitter::PrepareFits(double ebeam,
     // prepare the underlying kinematic fit
     // this may also set the proton's kinetic energy to missing E
     // do some more checks
-    KinFitter::PrepareFit(ebeam, proton, photons);
+    KinFitter::PrepareFit(ebeam, proton, photons, false);
 
     // iterations should normally be empty at this point,
     // but the user might call PrepareFits multiple times before running NextFit
@@ -127,7 +127,9 @@ void TreeFitter::PrepareFits(double ebeam,
 
     for(auto& it : iterations) {
 
-        PrepareFit(it);
+        // the filter must only depend on the given particles,
+        // so never start from previous fits here
+        PrepareFit(it, false);
 
         // after PrepareFit, we can obtain the initial LVSum now from GetLorentzVec
         do_sum_daughters();
@@ -147,7 +149,7 @@ void TreeFitter::PrepareFits(double ebeam,
     }
 }
 
-void TreeFitter::PrepareFit(const TreeFitter::iteration_t& it)
+void TreeFitter::PrepareFit(const TreeFitter::iteration_t& it, bool warmstart)
 {
     // update the current leave index,
     // gather the photons (in the right permuation!)
@@ -160,7 +162,7 @@ void TreeFitter::PrepareFit(const TreeFitter::iteration_t& it)
         photons.emplace_back(p.Particle);
     }
 
-    KinFitter::PrepareFit(BeamE.Value_before, Proton.Particle, photons);
+    KinFitter::PrepareFit(BeamE.Value_before, Proton.Particle, photons, warmstart);
 }
 
 void TreeFitter::do_sum_daughters() const
@@ -202,10 +204,7 @@ bool TreeFitter::NextFit(APLCON::Result_t& fit_result)
                               wrap_constraintIMatNodes
                               );
 
-    // tell the particles the fitted Z_Vertex
-    Proton.SetFittedZVertex(Z_Vertex.Value);
-    for(auto& photon : Photons)
-        photon.SetFittedZVertex(Z_Vertex.Value);
+    FinishFit(fit_result);
 
     iterations.pop_front();
     return true;
@@ -142,7 +142,7 @@ protected:
 
     std::list<iteration_t> iterations;
 
-    void PrepareFit(const iteration_t& it);
+    void PrepareFit(const iteration_t& it, bool warmstart = true);
 
     unsigned           max_iterations = 0; // 0 means no filtering
     iteration_filter_t iteration_filter;
@@ -0,0 +1,49 @@
+#include "AliasTable.h"
+
+#include <cmath>
+
+using namespace std;
+using namespace ant;
+
+AliasTable::AliasTable(const vector<double>& weights) :
+    prob(weights.size()),
+    alias(weights.size())
+{
+    for(auto w : weights) {
+        if(!(w >= 0) || !isfinite(w))
+            throw Exception("Weights must be finite and non-negative");
+        total += w;
+    }
+    if(!(total > 0))
+        throw Exception("At least one weight must be positive");
+
+    const auto n = weights.size();
+
+    // scaled probabilities have mean one,
+    // split them into too small and too large ones
+    vector<size_t> small, large;
+    for(size_t i=0;i<n;i++) {
+        prob[i] = weights[i]*n/total;
+        alias[i] = i;
+        (prob[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    // fill up each small one with a large one
+    while(!small.empty() && !large.empty()) {
+        const auto s = small.back();
+        small.pop_back();
+        const auto l = large.back();
+        alias[s] = l;
+        prob[l] -= 1.0 - prob[s];
+        if(prob[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+
+    // remaining ones are one up to rounding errors
+    for(auto i : large)
+        prob[i] = 1.0;
+    for(auto i : small)
+        prob[i] = 1.0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+namespace ant {
+
+/**
+ * @brief The AliasTable class samples indices with probabilities proportional to given weights
+ *
+ * Walker's alias method as constructed by Vose, needs one uniform random number and
+ * constant time per sample, independent of the number of weights.
+ */
+class AliasTable {
+public:
+    AliasTable() = default;
+
+    /**
+     * @brief AliasTable builds the table
+     * @param weights non-negative weights, at least one must be positive
+     */
+    explicit AliasTable(const std::vector<double>& weights);
+
+    /**
+     * @brief Sample returns index i with probability weights[i]/Total()
+     * @param u uniformly distributed in [0,1)
+     */
+    std::size_t Sample(double u) const noexcept {
+        const double x = u*prob.size();
+        auto i = static_cast<std::size_t>(x);
+        if(i >= prob.size()) // guard against u==1
+            i = prob.size()-1;
+        return x - i < prob[i] ? i : alias[i];
+    }
+
+    double Total() const noexcept { return total; }
+    std::size_t size() const noexcept { return prob.size(); }
+    bool empty() const noexcept { return prob.empty(); }
+
+    struct Exception : std::runtime_error {
+        using std::runtime_error::runtime_error; // use base class constructor
+    };
+
+protected:
+    std::vector<double>      prob;
+    std::vector<std::size_t> alias;
+    double total = 0;
+};
+
+}
@@ -142,26 +142,11 @@ void Array2DBase::FloodFillAverages()
     auto setVal = [this] (int i, double v) {
         Set(i % Width(), i / Width(), v);
     };
-    auto getNeighbours = [this] (int i) {
-        const int x = i % Width();
-        const int y = i / Width();
-        vector<int> neighbours;
-        for(auto& dir : vector<pair<int,int>>{{+1,0},{-1,0},{0,+1},{0,-1}}) {
-            const auto bx = x + dir.first;
-            const auto by = y + dir.second;
-            if(bx<0 || bx >= int(Width()))
-                continue;
-            if(by<0 || by >= int(Height()))
-                continue;
-            neighbours.push_back(bx + by*Width());
-        }
-        return neighbours;
-    };
     auto getValid = [getVal] (int i) {
         return isfinite(getVal(i));
     };
 
-    floodFillAverages(Size(), getVal, setVal, getNeighbours, getValid);
+    FloodFill::Grid({Width(), Height()}).Fill(getVal, setVal, getValid);
 }
 
 void Array2DBase::RemoveOutliers(double IQR_factor_lo, double IQR_factor_hi)
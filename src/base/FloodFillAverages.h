@@ -2,114 +2,205 @@
 
 #include <vector>
 #include <limits>
-#include <algorithm>
-
-#include "base/std_ext/container.h"
+#include <cmath>
+#include <stdexcept>
 
 namespace ant {
 
-// suppose you have N elements
-// getVal        = double(int i)
-// setVal        = void(int i, double newval)
-// getNeighbours = vector<int>(int i)
-// getValid      = bool(int i)
-template<typename GetVal_t, typename SetVal_t, typename GetNeighbours_t, typename GetValid_t>
-inline void floodFillAverages(int N, GetVal_t getVal, SetVal_t setVal,
-                              GetNeighbours_t getNeighbours, GetValid_t getValid)
-{
-    struct invalid_t {
-        int Index;
-        explicit invalid_t(int i) : Index(i) {}
-        int ValidNeighbours = 0;
-        std::vector<int> InvalidNeighbours;
-        double Value = std::numeric_limits<double>::quiet_NaN();
-        bool Visited = false;
-    };
-
-    std::vector<invalid_t> invalids;
-
-    for(int i=0;i<N;i++) {
-        if(getValid(i))
-            continue;
-        invalids.emplace_back(i);
-        for(auto j : getNeighbours(i)) {
-            if(getValid(j))
-                invalids.back().ValidNeighbours++;
-            else
-                invalids.back().InvalidNeighbours.push_back(j);
+/**
+ * @brief The FloodFill class fills invalid elements with the average of their valid neighbours
+ *
+ * The neighbours of the N elements are stored once in compressed sparse row format,
+ * so the same instance can fill many value sets (calibration maps, histogram contents, ...).
+ * The invalid elements with the most valid neighbours are filled first, already filled
+ * elements count as valid for the remaining ones. Each invalid element is visited exactly once,
+ * the ones without any valid neighbour (even after filling all others) become NaN.
+ * Neighbour relations need not be reflexive.
+ */
+class FloodFill {
+protected:
+    // neighbours of element i are Neighbours[Offsets[i]] ... Neighbours[Offsets[i+1]-1]
+    std::vector<int> Offsets{0};
+    std::vector<int> Neighbours;
+
+public:
+
+    FloodFill() = default;
+
+    /**
+     * @brief FromNeighbours builds the neighbour storage from a callback
+     * @param N number of elements
+     * @param getNeighbours container of neighbour indices (int or unsigned) for element i
+     */
+    template<typename GetNeighbours_t>
+    static FloodFill FromNeighbours(int N, GetNeighbours_t getNeighbours) {
+        FloodFill f;
+        f.Offsets.reserve(N+1);
+        for(int i=0;i<N;i++) {
+            for(auto j : getNeighbours(i)) {
+                if(int(j) < 0 || int(j) >= N)
+                    throw std::out_of_range("Neighbour index out of range");
+                f.Neighbours.push_back(j);
+            }
+            f.Offsets.push_back(f.Neighbours.size());
         }
+        return f;
     }
 
-    // average calculation takes into account already set invalids
-    auto getAvg = [&invalids, getNeighbours, getVal, getValid] (int i) {
-        double sum = 0;
-        int n = 0;
-        // average over valid neighbours
-        for(int j : getNeighbours(i)) {
-            if(getValid(j)) {
-                sum += getVal(j);
-                n++;
-            }
-            else {
-                // and possibly visited invalids
-                auto it = std::find_if(invalids.begin(), invalids.end(), [j] (const invalid_t& i) {
-                    return j == i.Index && i.Visited;
-                });
-                if(it != invalids.end()) {
-                    sum += it->Value;
-                    n++;
-                }
+    /**
+     * @brief Grid builds the neighbours of a regular grid, the direct neighbours along each axis
+     * @param dims number of elements along each axis, the first one runs fastest
+     */
+    static FloodFill Grid(const std::vector<unsigned>& dims) {
+        FloodFill f;
+        int N = 1;
+        for(auto d : dims)
+            N *= d;
+        f.Offsets.reserve(N+1);
+        f.Neighbours.reserve(2*dims.size()*N);
+        for(int i=0;i<N;i++) {
+            int stride = 1;
+            for(auto d : dims) {
+                const int k = (i / stride) % d;
+                if(k+1 < int(d))
+                    f.Neighbours.push_back(i + stride);
+                if(k > 0)
+                    f.Neighbours.push_back(i - stride);
+                stride *= d;
             }
+            f.Offsets.push_back(f.Neighbours.size());
         }
-        return sum/n;
-    };
-
-    while(true) {
-        std::sort(invalids.begin(), invalids.end(),
-                  [] (const invalid_t& a, const invalid_t& b) {
-            return a.ValidNeighbours > b.ValidNeighbours;
-        });
-        // find the first unvisited item (if any left)
-        // with the highest number of ValidNeighbours
-        auto it = std::find_if(invalids.begin(), invalids.end(), [] (const invalid_t& i) {
-            return !i.Visited;
-        });
-        if(it == invalids.end())
-            break;
-
-        // there might be more than one unvisited invalid
-        // with same number of valid neighbours
-        std::vector<decltype(it)> unvisited{it++};
-        for(; it != invalids.end(); ++it) {
-            if(it->ValidNeighbours < unvisited.front()->ValidNeighbours)
-                break; // stop immediately as invalids are sorted
-            if(it->Visited)
-                continue; // skip visited
-            unvisited.emplace_back(it);
+        return f;
+    }
+
+    int Size() const { return Offsets.size()-1; }
+
+    /**
+     * @brief Fill fills all invalid elements
+     * @param getVal        double(int i), only called once for valid elements
+     * @param setVal        void(int i, double newval), called once for each invalid element
+     * @param getValid      bool(int i)
+     */
+    template<typename GetVal_t, typename SetVal_t, typename GetValid_t>
+    void Fill(GetVal_t getVal, SetVal_t setVal, GetValid_t getValid) const {
+        const int N = Size();
+
+        std::vector<double> values(N, std::numeric_limits<double>::quiet_NaN());
+        std::vector<bool> known(N, false); // valid or already filled
+
+        for(int i=0;i<N;i++) {
+            if(getValid(i)) {
+                known[i] = true;
+                values[i] = getVal(i);
+            }
         }
 
-        for(const auto& it : unvisited) {
+        // invalid elements having i as neighbour, again in CSR format
+        std::vector<int> rev_offsets(N+1, 0);
+        for(int i=0;i<N;i++) {
+            if(known[i])
+                continue;
+            for(int k=Offsets[i];k<Offsets[i+1];k++)
+                rev_offsets[Neighbours[k]+1]++;
+        }
+        for(int i=0;i<N;i++)
+            rev_offsets[i+1] += rev_offsets[i];
+        std::vector<int> rev_neighbours(rev_offsets.back());
+        {
+            auto pos = rev_offsets;
+            for(int i=0;i<N;i++) {
+                if(known[i])
+                    continue;
+                for(int k=Offsets[i];k<Offsets[i+1];k++)
+                    rev_neighbours[pos[Neighbours[k]]++] = i;
+            }
+        }
 
-            // important to set the value for getAvg in next iteration
-            it->Value = getAvg(it->Index);
-            setVal(it->Index, it->Value);
+        // bucket queue ordered by number of known neighbours,
+        // outdated entries are skipped when the count has changed meanwhile
+        std::vector<int> nKnown(N, 0);
+        std::vector<std::vector<int>> buckets;
+        auto push = [&buckets, &nKnown] (int i) {
+            const auto n = nKnown[i];
+            if(unsigned(n) >= buckets.size())
+                buckets.resize(n+1);
+            buckets[n].push_back(i);
+        };
+
+        int nInvalid = 0;
+        for(int i=0;i<N;i++) {
+            if(known[i])
+                continue;
+            nInvalid++;
+            for(int k=Offsets[i];k<Offsets[i+1];k++)
+                if(known[Neighbours[k]])
+                    nKnown[i]++;
+            push(i);
+        }
 
-            // neighbour relatings might not be reflexive
-            // so we cannot iterate over getNeighbours(i.Index),
-            // but need to check if it->Index is neighbour of all other invalids
-            for(auto& invalid : invalids) {
-                if(invalid.Index == it->Index)
-                    continue;
+        std::vector<int> current;
+        while(nInvalid > 0) {
+            // take all waiting elements with the highest count at once,
+            // elements reaching that count meanwhile are handled in the next round
+            int level = buckets.size()-1;
+            current.clear();
+            for(; level >= 0 && current.empty(); level--) {
+                for(auto i : buckets[level])
+                    if(!known[i] && nKnown[i] == level)
+                        current.push_back(i);
+                buckets[level].clear();
+            }
 
-                if(std_ext::contains(invalid.InvalidNeighbours, it->Index)) {
-                    invalid.ValidNeighbours++;
+            for(auto i : current) {
+                // average over known neighbours, which includes the ones filled so far
+                double sum = 0;
+                int n = 0;
+                for(int k=Offsets[i];k<Offsets[i+1];k++) {
+                    const auto j = Neighbours[k];
+                    if(known[j]) {
+                        sum += values[j];
+                        n++;
+                    }
+                }
+                values[i] = sum/n;
+                known[i] = true;
+                nInvalid--;
+                setVal(i, values[i]);
+
+                for(int k=rev_offsets[i];k<rev_offsets[i+1];k++) {
+                    const auto j = rev_neighbours[k];
+                    if(known[j])
+                        continue;
+                    nKnown[j]++;
+                    push(j);
                 }
             }
-
-            it->Visited = true;
-
         }
     }
+
+    /**
+     * @brief Fill fills the non-finite values
+     * @param values of size Size()
+     */
+    void Fill(std::vector<double>& values) const {
+        if(values.size() != unsigned(Size()))
+            throw std::invalid_argument("Number of values does not match number of elements");
+        Fill([&values] (int i) { return values[i]; },
+             [&values] (int i, double v) { values[i] = v; },
+             [&values] (int i) { return std::isfinite(values[i]); });
+    }
+};
+
+// suppose you have N elements
+// getVal        = double(int i)
+// setVal        = void(int i, double newval)
+// getNeighbours = vector<int>(int i)
+// getValid      = bool(int i)
+template<typename GetVal_t, typename SetVal_t, typename GetNeighbours_t, typename GetValid_t>
+inline void floodFillAverages(int N, GetVal_t getVal, SetVal_t setVal,
+                              GetNeighbours_t getNeighbours, GetValid_t getValid)
+{
+    FloodFill::FromNeighbours(N, getNeighbours).Fill(getVal, setVal, getValid);
 }
 
-}
\ No newline at end of file
+}
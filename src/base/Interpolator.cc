@@ -1,54 +1,242 @@
 #include "Interpolator.h"
 
-extern "C" {
-#include "interp2d/interp2d_spline.h"
-}
+#include "base/std_ext/math.h"
+
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 using namespace ant;
 
-struct Interpolator2D::interp2d : ::interp2d {};
-struct Interpolator2D::gsl_interp_accel : ::gsl_interp_accel {};
+namespace {
+
+/**
+ * @brief spline_derivatives computes the first derivatives at the nodes
+ *        of the natural cubic spline through the points (x[i], y[i*stride]),
+ *        as gsl_spline_eval_deriv does for gsl_interp_cspline
+ */
+vector<double> spline_derivatives(const vector<double>& x, const double* y, size_t stride)
+{
+    const size_t n = x.size();
+    auto y_ = [y, stride] (size_t i) { return y[i*stride]; };
+
+    // half of the second derivatives, zero at both ends,
+    // by solving the tridiagonal system (Thomas algorithm)
+    vector<double> c(n, 0.0);
+    if(n > 2) {
+        const size_t sys_size = n - 2;
+        vector<double> diag(sys_size), offdiag(sys_size), rhs(sys_size);
+        for(size_t i=0;i<sys_size;i++) {
+            const double h_i   = x[i+1] - x[i];
+            const double h_ip1 = x[i+2] - x[i+1];
+            offdiag[i] = h_ip1;
+            diag[i]    = 2.0*(h_ip1 + h_i);
+            rhs[i]     = 3.0*((y_(i+2) - y_(i+1))/h_ip1 - (y_(i+1) - y_(i))/h_i);
+        }
+        for(size_t i=1;i<sys_size;i++) {
+            const double w = offdiag[i-1]/diag[i-1];
+            diag[i] -= w*offdiag[i-1];
+            rhs[i]  -= w*rhs[i-1];
+        }
+        c[sys_size] = rhs[sys_size-1]/diag[sys_size-1];
+        for(size_t i=sys_size-1;i>0;i--)
+            c[i] = (rhs[i-1] - offdiag[i-1]*c[i+1])/diag[i-1];
+    }
 
-const interp2d_type* getType(Interpolator2D::Type type) {
-    switch(type) {
-    case Interpolator2D::Type::Bilinear:
-        return interp2d_bilinear;
-    case Interpolator2D::Type::Bicubic:
-        return interp2d_bicubic;
+    vector<double> d(n);
+    for(size_t i=0;i<n-1;i++) {
+        const double h = x[i+1] - x[i];
+        d[i] = (y_(i+1) - y_(i))/h - h*(c[i+1] + 2.0*c[i])/3.0;
     }
-    return nullptr;
+    // last node is evaluated at the end of the last interval
+    {
+        const size_t i = n-2;
+        const double h = x[i+1] - x[i];
+        const double b = (y_(i+1) - y_(i))/h - h*(c[i+1] + 2.0*c[i])/3.0;
+        const double e = (c[i+1] - c[i])/(3.0*h);
+        d[n-1] = b + h*(2.0*c[i] + 3.0*e*h);
+    }
+    return d;
+}
+
 }
 
+Interpolator2D::axis_t::axis_t(const vector<double>& nodes, unsigned min_size) :
+    Nodes(nodes), Equidistant(false), Step_inv(0)
+{
+    if(Nodes.size() < min_size)
+        throw Exception("Insufficient number of points for interpolation type");
+    for(size_t i=1;i<Nodes.size();i++) {
+        if(!(Nodes[i-1] < Nodes[i]))
+            throw Exception("Grid values must be strictly increasing");
+    }
+
+    const double step = (Nodes.back() - Nodes.front())/(Nodes.size()-1);
+    Equidistant = true;
+    for(size_t i=1;i<Nodes.size()-1;i++) {
+        if(std::abs(Nodes[i] - (Nodes.front() + i*step)) > 1e-9*step) {
+            Equidistant = false;
+            break;
+        }
+    }
+    Step_inv = 1.0/step;
+}
+
+unsigned Interpolator2D::axis_t::FindCell(double v) const
+{
+    const unsigned last = Nodes.size()-2;
+    if(Equidistant) {
+        const double u = (v - Nodes.front())*Step_inv;
+        unsigned i = u > 0 ? std::min(unsigned(u), last) : 0;
+        // correct for rounding, such that Nodes[i] <= v < Nodes[i+1]
+        if(i > 0 && v < Nodes[i])
+            --i;
+        else if(i < last && v >= Nodes[i+1])
+            ++i;
+        return i;
+    }
+    const auto it = std::upper_bound(Nodes.begin(), Nodes.end(), v);
+    const unsigned i = std::distance(Nodes.begin(), it);
+    return i > 0 ? std::min(i-1, last) : 0;
+}
 
 Interpolator2D::Interpolator2D(const std::vector<double>& x,
                                const std::vector<double>& y,
                                const std::vector<double>& z,
-                               Type type) :
-    X(x), Y(y), Z(z),
-    interp(static_cast<interp2d*>(
-               interp2d_alloc(getType(type), X.size(), Y.size())
-               ), interp2d_free),
-    xa(static_cast<gsl_interp_accel*>(gsl_interp_accel_alloc()), gsl_interp_accel_free),
-    ya(static_cast<gsl_interp_accel*>(gsl_interp_accel_alloc()), gsl_interp_accel_free)
-{
-    if(X.size()*Y.size() != Z.size())
+                               Type type_) :
+    type(type_),
+    X(x, type == Type::Bicubic ? 4 : 2),
+    Y(y, type == Type::Bicubic ? 4 : 2)
+{
+    if(X.Nodes.size()*Y.Nodes.size() != z.size())
         throw Exception("X*Y grid must match to Z values");
-    interp2d_init(interp.get(), X.data(), Y.data(), Z.data(), X.size(), Y.size());
+
+    if(type == Type::Bicubic)
+        MakeBicubic(z);
+    else
+        MakeBilinear(z);
+}
+
+void Interpolator2D::MakeBilinear(const vector<double>& z)
+{
+    const auto nx = X.Nodes.size();
+    const auto ny = Y.Nodes.size();
+    Coefficients.reserve((nx-1)*(ny-1)*nCoefficients());
+    for(size_t j=0;j<ny-1;j++) {
+        for(size_t i=0;i<nx-1;i++) {
+            const double z00 = z[j*nx+i];
+            const double z10 = z[j*nx+i+1];
+            const double z01 = z[(j+1)*nx+i];
+            const double z11 = z[(j+1)*nx+i+1];
+            Coefficients.insert(Coefficients.end(), {z00, z10-z00, z01-z00, z11-z10-z01+z00});
+        }
+    }
+}
+
+void Interpolator2D::MakeBicubic(const vector<double>& z)
+{
+    const auto nx = X.Nodes.size();
+    const auto ny = Y.Nodes.size();
+
+    // derivatives at the nodes, along x for each row, along y for each column,
+    // and the cross derivative as the x derivative of the y derivatives
+    vector<double> zx(nx*ny), zy(nx*ny), zxy(nx*ny);
+    for(size_t j=0;j<ny;j++) {
+        const auto d = spline_derivatives(X.Nodes, &z[j*nx], 1);
+        std::copy(d.begin(), d.end(), &zx[j*nx]);
+    }
+    for(size_t i=0;i<nx;i++) {
+        const auto d = spline_derivatives(Y.Nodes, &z[i], nx);
+        for(size_t j=0;j<ny;j++)
+            zy[j*nx+i] = d[j];
+    }
+    for(size_t j=0;j<ny;j++) {
+        const auto d = spline_derivatives(X.Nodes, &zy[j*nx], 1);
+        std::copy(d.begin(), d.end(), &zxy[j*nx]);
+    }
+
+    Coefficients.reserve((nx-1)*(ny-1)*nCoefficients());
+    for(size_t j=0;j<ny-1;j++) {
+        for(size_t i=0;i<nx-1;i++) {
+            const double dx = X.Nodes[i+1] - X.Nodes[i];
+            const double dy = Y.Nodes[j+1] - Y.Nodes[j];
+
+            // values and derivatives in units of the cell size at the corners,
+            // index 0 is the lower, 1 the upper node (first x, then y)
+            const size_t k00 = j*nx+i, k10 = k00+1, k01 = k00+nx, k11 = k01+1;
+            const double f00 = z[k00], f10 = z[k10], f01 = z[k01], f11 = z[k11];
+            const double fx00 = zx[k00]*dx, fx10 = zx[k10]*dx, fx01 = zx[k01]*dx, fx11 = zx[k11]*dx;
+            const double fy00 = zy[k00]*dy, fy10 = zy[k10]*dy, fy01 = zy[k01]*dy, fy11 = zy[k11]*dy;
+            const double fxy00 = zxy[k00]*dx*dy, fxy10 = zxy[k10]*dx*dy, fxy01 = zxy[k01]*dx*dy, fxy11 = zxy[k11]*dx*dy;
+
+            // coefficients of t^p*u^q as in interp2d's bicubic_eval
+            Coefficients.insert(Coefficients.end(), {
+                // p=0
+                f00,
+                fy00,
+                -3*f00 + 3*f01 - 2*fy00 - fy01,
+                2*f00 - 2*f01 + fy00 + fy01,
+                // p=1
+                fx00,
+                fxy00,
+                -3*fx00 + 3*fx01 - 2*fxy00 - fxy01,
+                2*fx00 - 2*fx01 + fxy00 + fxy01,
+                // p=2
+                -3*f00 + 3*f10 - 2*fx00 - fx10,
+                -3*fy00 + 3*fy10 - 2*fxy00 - fxy10,
+                9*f00 - 9*f10 + 9*f11 - 9*f01 + 6*fx00 + 3*fx10 - 3*fx11 - 6*fx01
+                + 6*fy00 - 6*fy10 - 3*fy11 + 3*fy01 + 4*fxy00 + 2*fxy10 + fxy11 + 2*fxy01,
+                -6*f00 + 6*f10 - 6*f11 + 6*f01 - 4*fx00 - 2*fx10 + 2*fx11 + 4*fx01
+                - 3*fy00 + 3*fy10 + 3*fy11 - 3*fy01 - 2*fxy00 - fxy10 - fxy11 - 2*fxy01,
+                // p=3
+                2*f00 - 2*f10 + fx00 + fx10,
+                2*fy00 - 2*fy10 + fxy00 + fxy10,
+                -6*f00 + 6*f10 - 6*f11 + 6*f01 - 3*fx00 - 3*fx10 + 3*fx11 + 3*fx01
+                - 4*fy00 + 4*fy10 + 2*fy11 - 2*fy01 - 2*fxy00 - 2*fxy10 - fxy11 - fxy01,
+                4*f00 - 4*f10 + 4*f11 - 4*f01 + 2*fx00 + 2*fx10 - 2*fx11 - 2*fx01
+                + 2*fy00 - 2*fy10 - 2*fy11 + 2*fy01 + fxy00 + fxy10 + fxy11 + fxy01
+            });
+        }
+    }
 }
 
 double Interpolator2D::GetPoint(double x, double y) const
 {
-    return interp2d_eval(interp.get(), X.data(), Y.data(), Z.data(), x, y,
-                         xa.get(), ya.get());
+    if(!X.Contains(x) || !Y.Contains(y))
+        return std_ext::NaN;
+
+    const unsigned i = X.FindCell(x);
+    const unsigned j = Y.FindCell(y);
+    const double t = (x - X.Nodes[i])/(X.Nodes[i+1] - X.Nodes[i]);
+    const double u = (y - Y.Nodes[j])/(Y.Nodes[j+1] - Y.Nodes[j]);
+    const double* a = &Coefficients[(j*(X.Nodes.size()-1) + i)*nCoefficients()];
+
+    if(type == Type::Bilinear)
+        return a[0] + a[1]*t + u*(a[2] + a[3]*t);
+
+    double z = 0;
+    for(int p=3;p>=0;p--) {
+        const double* a_p = &a[4*p];
+        z = z*t + (((a_p[3]*u + a_p[2])*u + a_p[1])*u + a_p[0]);
+    }
+    return z;
+}
+
+void Interpolator2D::GetPoints(const vector<double>& x, const vector<double>& y, vector<double>& z) const
+{
+    if(x.size() != y.size())
+        throw Exception("X and Y coordinates differ in size");
+    z.resize(x.size());
+    for(size_t k=0;k<x.size();k++)
+        z[k] = GetPoint(x[k], y[k]);
 }
 
 interval<double> Interpolator2D::getXRange() const
 {
-    return { interp->xmin, interp->xmax };
+    return { X.Nodes.front(), X.Nodes.back() };
 }
 
 interval<double> Interpolator2D::getYRange() const
 {
-    return { interp->ymin, interp->ymax };
+    return { Y.Nodes.front(), Y.Nodes.back() };
 }
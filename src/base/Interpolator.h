@@ -2,25 +2,51 @@
 
 #include <vector>
 #include <stdexcept>
-#include <memory>
-#include <functional>
 #include "base/interval.h"
 
 namespace ant {
 
+/**
+ * @brief The Interpolator2D class interpolates z values given on a rectilinear x/y grid
+ *
+ * The polynomial coefficients of each grid cell are computed once in the constructor,
+ * for the bicubic type from the derivatives of natural cubic splines through the grid
+ * (the same as the interp2d/GSL implementation). Evaluation is const and does not
+ * modify any state, so one instance can be shared between threads.
+ * For equidistant grids, the cell is found in constant time.
+ */
 class Interpolator2D {
 public:
     enum class Type {
         Bilinear, Bicubic
     };
 
+    /**
+     * @brief Interpolator2D
+     * @param x strictly increasing grid nodes, at least 2 (bilinear) or 4 (bicubic)
+     * @param y strictly increasing grid nodes, at least 2 (bilinear) or 4 (bicubic)
+     * @param z values at the nodes, x runs fastest (z[j*x.size()+i] belongs to x[i], y[j])
+     * @param type of interpolation
+     */
     Interpolator2D(const std::vector<double>& x,
                    const std::vector<double>& y,
                    const std::vector<double>& z,
                    Type type = Type::Bicubic);
 
+    /**
+     * @brief GetPoint interpolates at the given point
+     * @return interpolated value, or NaN if outside of the grid
+     */
     double GetPoint(double x, double y) const;
 
+    /**
+     * @brief GetPoints interpolates many points in one go
+     * @param x x coordinates
+     * @param y y coordinates, same size as x
+     * @param z is resized and filled with the values
+     */
+    void GetPoints(const std::vector<double>& x, const std::vector<double>& y, std::vector<double>& z) const;
+
     struct Exception : std::runtime_error {
         using std::runtime_error::runtime_error; // use base class constructor
     };
@@ -31,19 +57,29 @@ public:
 
 private:
 
-    const std::vector<double> X;
-    const std::vector<double> Y;
-    const std::vector<double> Z;
+    struct axis_t {
+        std::vector<double> Nodes;
+        bool   Equidistant;
+        double Step_inv;
+
+        axis_t(const std::vector<double>& nodes, unsigned min_size);
+
+        // index of the cell containing v, the last node belongs to the last cell
+        unsigned FindCell(double v) const;
+        bool Contains(double v) const { return v >= Nodes.front() && v <= Nodes.back(); }
+    };
 
-    template<typename T>
-    using deleted_unique_ptr = std::unique_ptr<T, std::function<void(T*)>>;
+    const Type type;
+    const axis_t X;
+    const axis_t Y;
 
-    struct interp2d;
-    deleted_unique_ptr<interp2d> interp;
+    // polynomial coefficients for each cell in t and u, running from 0 to 1 within the cell,
+    // for bicubic the coefficient of t^p*u^q is at 4*p+q
+    std::vector<double> Coefficients;
+    unsigned nCoefficients() const { return type == Type::Bicubic ? 16 : 4; }
 
-    struct gsl_interp_accel;
-    deleted_unique_ptr<gsl_interp_accel> xa;
-    deleted_unique_ptr<gsl_interp_accel> ya;
+    void MakeBilinear(const std::vector<double>& z);
+    void MakeBicubic(const std::vector<double>& z);
 };
 
 }
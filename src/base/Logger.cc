@@ -3,6 +3,8 @@
 #include "TError.h"
 #include "gsl/gsl_errno.h"
 #include <sstream>
+#include <list>
+#include <mutex>
 
 // setup the logger, will be compiled as a little library
 INITIALIZE_EASYLOGGINGPP
@@ -74,3 +76,26 @@ void SetupLogger() {
 long long DebugInfo::nProcessedEvents = -1;
 int DebugInfo::nUnpackedBuffers = -1;
 
+static std::list<Aggregator::site_t>& aggregator_sites() {
+    // function static avoids initialization order problems
+    static std::list<Aggregator::site_t> sites;
+    return sites;
+}
+
+Aggregator::site_t& Aggregator::Register(const char* file, int line, unsigned long long limit) {
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& sites = aggregator_sites();
+    sites.emplace_back(file, line, limit);
+    return sites.back();
+}
+
+void Aggregator::PrintSummary() {
+    for(const auto& site : aggregator_sites()) {
+        const auto count = site.count.load();
+        if(count <= site.limit)
+            continue;
+        LOG(WARNING) << "Suppressed " << count - site.limit << " of " << count
+                     << " messages from " << site.file << ":" << site.line;
+    }
+}
@@ -20,9 +20,37 @@
 #endif
 #pragma GCC diagnostic pop
 
+#include <atomic>
+
 void SetupLogger(int argc, char* argv[]);
 void SetupLogger();
 
+// VLOG statements with a level above ANT_MAX_VLOG_LEVEL are removed at compile time,
+// see Ant_MAX_VLOG_LEVEL in cmake/settings.cmake
+#ifndef ANT_MAX_VLOG_LEVEL
+#define ANT_MAX_VLOG_LEVEL 9
+#endif
+
+#undef VLOG
+#define VLOG(vlevel) if((vlevel) <= ANT_MAX_VLOG_LEVEL) CVLOG(vlevel, ELPP_CURR_FILE_LOGGER_ID)
+#undef VLOG_IF
+#define VLOG_IF(condition, vlevel) if((vlevel) <= ANT_MAX_VLOG_LEVEL) CVLOG_IF(condition, vlevel, ELPP_CURR_FILE_LOGGER_ID)
+#undef VLOG_N_TIMES
+#define VLOG_N_TIMES(n, vlevel) if((vlevel) <= ANT_MAX_VLOG_LEVEL) CVLOG_N_TIMES(n, vlevel, ELPP_CURR_FILE_LOGGER_ID)
+
+// LOG_AGGREGATED logs only the first n messages of this call site,
+// the number of suppressed messages is reported by ant::logger::Aggregator::PrintSummary()
+#define LOG_AGGREGATED(n, LEVEL) \
+    if(::ant::logger::Aggregator::Allow(LOG_AGGREGATED_SITE(n))) LOG(LEVEL)
+
+// LOG_AGGREGATED_SITE returns the aggregator site of this call site, with a limit of n messages,
+// useful to pass it on to helpers which log on behalf of their caller
+#define LOG_AGGREGATED_SITE(n) \
+    ([&] () -> ::ant::logger::Aggregator::site_t& { \
+        static auto& site = ::ant::logger::Aggregator::Register(__FILE__, __LINE__, n); \
+        return site; \
+    }())
+
 
 // Please see
 // https://github.com/easylogging/easyloggingpp
@@ -36,5 +64,30 @@ struct DebugInfo {
     static long long nProcessedEvents;
 };
 
+/**
+ * @brief The Aggregator struct counts messages of LOG_AGGREGATED call sites
+ */
+struct Aggregator {
+    struct site_t {
+        site_t(const char* file_, int line_, unsigned long long limit_) :
+            file(file_), line(line_), limit(limit_) {}
+        const char* const file;
+        const int line;
+        const unsigned long long limit;
+        std::atomic<unsigned long long> count{0};
+    };
+
+    static site_t& Register(const char* file, int line, unsigned long long limit);
+
+    static bool Allow(site_t& site) noexcept {
+        return site.count.fetch_add(1, std::memory_order_relaxed) < site.limit;
+    }
+
+    /**
+     * @brief PrintSummary logs the number of suppressed messages per call site
+     */
+    static void PrintSummary();
+};
+
 }}
 
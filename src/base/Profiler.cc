@@ -0,0 +1,75 @@
+#include "Profiler.h"
+
+#include "WrapTTree.h"
+
+#include <iomanip>
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+
+bool Profiler::Enabled = false;
+list<Profiler::Stage_t> Profiler::stages;
+thread_local unsigned long long Profiler::nAllocations = 0;
+unsigned long long Profiler::nEvents = 0;
+
+Profiler::Stage_t& Profiler::GetStage(const string& name)
+{
+    auto it = find_if(stages.begin(), stages.end(), [&name] (const Stage_t& s) {
+        return s.Name == name;
+    });
+    if(it != stages.end())
+        return *it;
+    stages.emplace_back(name);
+    return stages.back();
+}
+
+void Profiler::Print(ostream& s)
+{
+    const auto events = max<double>(nEvents, 1);
+
+    size_t width = 5;
+    for(const auto& stage : stages)
+        width = max(width, stage.Name.size());
+
+    s << left << setw(width) << "Stage" << right
+      << setw(14) << "ns/event"
+      << setw(14) << "calls/event"
+      << setw(14) << "allocs/event" << '\n';
+
+    for(const auto& stage : stages) {
+        if(stage.Calls == 0)
+            continue;
+        s << left << setw(width) << stage.Name << right << fixed << setprecision(1)
+          << setw(14) << stage.Time.count()/events
+          << setw(14) << stage.Calls/events
+          << setw(14) << stage.Allocations/events << '\n';
+    }
+    s << "Events: " << nEvents << '\n';
+}
+
+void Profiler::Write()
+{
+    struct tree_t : WrapTTree {
+        ADD_BRANCH_T(std::string,        Stage)
+        ADD_BRANCH_T(unsigned long long, Events)
+        ADD_BRANCH_T(unsigned long long, Calls)
+        ADD_BRANCH_T(unsigned long long, Allocations)
+        ADD_BRANCH_T(double,             NsPerEvent)
+    };
+
+    tree_t t;
+    t.CreateBranches(new TTree("AntProfiler", "Ant Profiler stages"));
+
+    const auto events = max<double>(nEvents, 1);
+    for(const auto& stage : stages) {
+        if(stage.Calls == 0)
+            continue;
+        t.Stage = stage.Name;
+        t.Events = nEvents;
+        t.Calls = stage.Calls;
+        t.Allocations = stage.Allocations;
+        t.NsPerEvent = stage.Time.count()/events;
+        t.Tree->Fill();
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <list>
+#include <ostream>
+
+namespace ant {
+
+/**
+ * @brief The Profiler struct collects the time and allocations spent in stages of the event loop
+ *
+ * Profiling is disabled by default, a Scope then costs a single branch.
+ * Obtain the stage once outside the event loop, since GetStage searches by name:
+ *
+ *     auto& stage = Profiler::GetStage("Unpacker");
+ *     ...
+ *     {
+ *         Profiler::Scope p(stage);
+ *         // do the work
+ *     }
+ *
+ * Stages may be nested, their time then includes the time of the inner stages.
+ * Allocations are only counted if the executable reports them via CountAllocation(),
+ * a Scope sees the allocations of its own thread only.
+ */
+struct Profiler {
+
+    /**
+     * @brief Enabled switches on the measurement, should be set before the event loop starts
+     */
+    static bool Enabled;
+
+    struct Stage_t {
+        explicit Stage_t(const std::string& name) : Name(name) {}
+        const std::string Name;
+        unsigned long long Calls = 0;
+        unsigned long long Allocations = 0;
+        std::chrono::nanoseconds Time{0};
+    };
+
+    /**
+     * @brief GetStage finds or creates the stage with the given name
+     * @param name the name of the stage, use '/' to indicate nesting
+     * @return reference to the stage, stays valid until program exit
+     */
+    static Stage_t& GetStage(const std::string& name);
+
+    class Scope {
+        using clock_t = std::chrono::steady_clock;
+        Stage_t* const stage;
+        clock_t::time_point start;
+        unsigned long long allocations = 0;
+    public:
+        explicit Scope(Stage_t& stage_) noexcept :
+            stage(Enabled ? &stage_ : nullptr)
+        {
+            if(stage) {
+                allocations = nAllocations;
+                start = clock_t::now();
+            }
+        }
+        ~Scope() {
+            if(stage) {
+                stage->Time += clock_t::now() - start;
+                stage->Allocations += nAllocations - allocations;
+                stage->Calls++;
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    /**
+     * @brief CountAllocation should be called by a replaced global operator new, from any thread
+     */
+    static void CountAllocation() noexcept {
+        if(Enabled)
+            nAllocations++;
+    }
+
+    /**
+     * @brief CountEvent should be called once per event by the event loop
+     */
+    static void CountEvent() noexcept {
+        if(Enabled)
+            nEvents++;
+    }
+
+    static unsigned long long GetEvents() { return nEvents; }
+
+    /**
+     * @brief Print writes a table with ns/event, calls/event and allocations/event of each stage
+     * @param s stream to print to
+     */
+    static void Print(std::ostream& s);
+
+    /**
+     * @brief Write creates the tree "AntProfiler" with one entry per stage in the current gDirectory
+     */
+    static void Write();
+
+protected:
+    static std::list<Stage_t> stages;
+    // per thread, as operator new is called from all threads
+    static thread_local unsigned long long nAllocations;
+    static unsigned long long nEvents;
+};
+
+}
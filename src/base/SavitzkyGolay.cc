@@ -2,6 +2,8 @@
 
 #include "base/std_ext/string.h"
 
+#include <algorithm>
+
 extern "C" {
 #include <gsl/gsl_linalg.h>
 #include <gsl/gsl_blas.h>
@@ -25,7 +27,8 @@ SavitzkyGolay::SavitzkyGolay(int window_left, int window_right, int polynom_orde
     n_l(window_left),
     n_r(window_right),
     m(polynom_order),
-    h(MakeH(n_l,n_r,m))
+    h(MakeH(n_l,n_r,m)),
+    coefficients(GetRow(h, n_l))
 {
 }
 
@@ -90,33 +93,62 @@ SavitzkyGolay::gsl_unique_ptr<SavitzkyGolay::gsl_matrix> SavitzkyGolay::MakeH(in
 vector<double> SavitzkyGolay::Smooth(const vector<double>& y) const
 {
     const int points = n_l + n_r + 1;
+    const double* c = coefficients.data();
 
     // for edge cases, mirror the input y as follows:
-    // ... y[2] y[1] y[0] y[1] .... y[n-2] y[n-1] y[n] y[n+1] ...
-    auto get_y = [&y] (const int i) {
-        if(i<0)
-            return y.at(-i);
-        if(unsigned(i)>=y.size()) {
-            const auto i_ = y.size()-(i-y.size())-2;
-            return y.at(i_);
-        }
-        return y[i];
-    };
-
+    // ... y[2] y[1] y[0] y[1] .... y[n-2] y[n-1] y[n-2] y[n-3] ...
     const int d_n = y.size();
     vector<double> result(d_n);
-    for (int i = 0; i < d_n; i++){
+    auto convolute_edge = [this, &y, &result, c, points, d_n] (const int i) {
+        double convolution = 0.0;
+        for (int k = 0; k < points; k++)
+            convolution += c[k] * y[mirror(i - n_l + k, d_n)];
+        result[i] = convolution;
+    };
+
+    // the interior does not need any mirroring
+    const int interior_start = min(n_l, d_n);
+    const int interior_stop  = max(interior_start, d_n - n_r);
+
+    for (int i = 0; i < interior_start; i++)
+        convolute_edge(i);
+
+    for (int i = interior_start; i < interior_stop; i++) {
+        const double* y_i = &y[i - n_l];
         double convolution = 0.0;
         for (int k = 0; k < points; k++)
-            convolution += gsl_matrix_get(h, n_l, k) * get_y(i - n_l + k);
+            convolution += c[k] * y_i[k];
         result[i] = convolution;
     }
 
+    for (int i = interior_stop; i < d_n; i++)
+        convolute_edge(i);
+
     return result;
 }
 
-double SavitzkyGolay::gsl_matrix_get(const gsl_matrix* m, const size_t i, const size_t j)
+void SavitzkyGolay::Convolute(const vector<const double*>& ys, int i, size_t n, double* result) const
+{
+    if(ys.empty())
+        throw Exception("Cannot convolute empty sequence");
+
+    std::fill(result, result+n, 0.0);
+
+    // the mirroring is done once per tap, the arrays are then added element by element
+    const int points = n_l + n_r + 1;
+    for (int k = 0; k < points; k++) {
+        const double c = coefficients[k];
+        const double* y = ys[mirror(i - n_l + k, ys.size())];
+        for (size_t j = 0; j < n; j++)
+            result[j] += c * y[j];
+    }
+}
+
+vector<double> SavitzkyGolay::GetRow(const gsl_matrix* m, const size_t i)
 {
-    return ::gsl_matrix_get(m, i, j);
+    vector<double> row(m->size2);
+    for(size_t j=0;j<row.size();j++)
+        row[j] = ::gsl_matrix_get(m, i, j);
+    return row;
 }
 
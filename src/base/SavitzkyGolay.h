@@ -26,16 +26,22 @@ struct SavitzkyGolay {
             auto i = k - n_l; // i runs from -n_l to n_r (inclusive), -n_l <= i <= n_r
 
             // do some wrap around to keep it in range
-            if(i<range.Start())
-                i = range.Start() + (range.Start() - i);
-            else if(i>range.Stop())
-                i = range.Stop()  - (i - range.Stop() );
+            i = range.Start() + mirror(i - range.Start(), range.Length()+1);
 
-            convolution += gsl_matrix_get(h, n_l, k) * getY(i);
+            convolution += coefficients[k] * getY(i);
         }
         setY(convolution); // implicitly assume i=0
     }
 
+    /**
+     * @brief Convolute smoothes item i of a sequence of equally sized arrays, element by element
+     * @param ys the arrays, mirrored at both ends of the sequence as in Smooth()
+     * @param i index of the item to be smoothed
+     * @param n size of each array
+     * @param result array of size n, overwritten with the smoothed item
+     */
+    void Convolute(const std::vector<const double*>& ys, int i, std::size_t n, double* result) const;
+
     struct Exception : std::runtime_error {
         using std::runtime_error::runtime_error;
     };
@@ -57,8 +63,20 @@ protected:
     const gsl_unique_ptr<gsl_matrix> h;
     static gsl_unique_ptr<gsl_matrix> MakeH(int n_l, int n_r, int m);
 
-    // define wrapper for above templated Convolute method
-    static double gsl_matrix_get(const gsl_matrix* m, const size_t i, const size_t j);
+    // the row of h which smoothes the central point, copied once
+    const std::vector<double> coefficients;
+    static std::vector<double> GetRow(const gsl_matrix* m, const std::size_t i);
+
+    // mirrors index i into [0,n) as ... y[2] y[1] y[0] y[1] ... y[n-2] y[n-1] y[n-2] ...
+    static int mirror(int i, int n) {
+        if(n<2)
+            return 0;
+        const int period = 2*(n-1);
+        i %= period;
+        if(i<0)
+            i += period;
+        return i<n ? i : period - i;
+    }
 };
 
 }
\ No newline at end of file
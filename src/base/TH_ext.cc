@@ -2,6 +2,7 @@
 
 #include "TDirectory.h"
 #include "base/std_ext/string.h"
+#include "base/FloodFillAverages.h"
 #include <iomanip>
 
 using namespace std;
@@ -222,6 +223,26 @@ TH2D* GetSlice(const TH3& hist, const char* name, const char* title, const int b
     return res;
 }
 
+void FloodFillAverages(TH1& hist)
+{
+    const int nx = hist.GetNbinsX();
+    const int ny = hist.GetNbinsY();
+    const int nz = hist.GetNbinsZ();
+
+    // element index runs over x fastest, as the grid of FloodFill
+    auto bin = [&hist, nx, ny] (int i) {
+        return hist.GetBin(1 + i % nx, 1 + (i / nx) % ny, 1 + i / (nx*ny));
+    };
+
+    FloodFill::Grid({unsigned(nx), unsigned(ny), unsigned(nz)}).Fill(
+                [&hist, bin] (int i) { return hist.GetBinContent(bin(i)); },
+                [&hist, bin] (int i, double v) { hist.SetBinContent(bin(i), v); },
+                [&hist, bin] (int i) { return std::isfinite(hist.GetBinContent(bin(i))); }
+                );
+
+    hist.ResetStats();
+}
+
 }
 
 }
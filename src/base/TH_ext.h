@@ -211,6 +211,13 @@ TH2D* GetSlice(const TH3& hist,
                const TAxis* const axis1,
                const TAxis* const axis2);
 
+/**
+ * @brief FloodFillAverages fills non-finite bin contents of a 1D, 2D or 3D histogram
+ *        with the average of their direct neighbours, see ant::FloodFill
+ * @param hist histogram to fill, under- and overflow bins are not touched
+ */
+void FloodFillAverages(TH1& hist);
+
 }
 
 
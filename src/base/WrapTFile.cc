@@ -12,6 +12,10 @@
 #include "TH3D.h"
 #include "Compression.h"
 #include "TClass.h"
+#include "TTree.h"
+#include "TTreeCache.h"
+#include "TEnv.h"
+#include "TROOT.h"
 
 #include <stdexcept>
 #include <string>
@@ -189,6 +193,10 @@ void WrapTFileInput::OpenFile(const string& filename)
     if(!hasROOTmagic(filename))
         throw ENotARootFile(filename+" is not a ROOT file");
 
+    // needs to be set before opening
+    if(ReadCache.Prefetch)
+        gEnv->SetValue("TFile.AsyncPrefetching", 1);
+
     SavedDirectory_t d;
     auto file = openFile(filename, "READ");
     VLOG(5) << "Opened file " << filename << " for reading";
@@ -215,3 +223,29 @@ string WrapTFileInput::FileNames() const
     s<< ")";
     return s.str();
 }
+
+WrapTFileInput::ReadCache_t WrapTFileInput::ReadCache;
+
+void WrapTFileInput::SetupReadCache(TTree* tree)
+{
+    if(tree == nullptr)
+        return;
+
+    // learning phase figures out the branches which are actually read
+    TTreeCache::SetLearnEntries(ReadCache.LearnEntries);
+    if(ReadCache.CacheSize>0)
+        tree->SetCacheSize(ReadCache.CacheSize);
+
+#ifdef R__USE_IMT
+    if(ReadCache.ImplicitMTThreads>0) {
+        if(!ROOT::IsImplicitMTEnabled())
+            ROOT::EnableImplicitMT(ReadCache.ImplicitMTThreads);
+        tree->SetImplicitMT(true);
+    }
+#else
+    LOG_IF(ReadCache.ImplicitMTThreads>0, WARNING) << "ROOT was built without implicit multi-threading support";
+#endif
+
+    VLOG(5) << "Tree " << tree->GetName() << " read with cache size " << tree->GetCacheSize()
+            << (ReadCache.Prefetch ? ", prefetching" : "");
+}
@@ -19,6 +19,7 @@
 #include <functional>
 
 class TH1;
+class TTree;
 class TH1D;
 class TH2D;
 class TH3D;
@@ -216,6 +217,37 @@ public:
 
     std::string FileNames() const;
 
+    /**
+     * @brief The ReadCache_t struct configures how trees of input files are read sequentially
+     *
+     * Set it before opening any input file, as the prefetching is decided upon opening.
+     */
+    struct ReadCache_t {
+        /**
+         * @brief CacheSize in bytes of the TTreeCache, zero keeps ROOT's default
+         */
+        long long CacheSize = 0;
+        /**
+         * @brief LearnEntries number of entries used to learn which branches are actually read
+         */
+        int LearnEntries = 100;
+        /**
+         * @brief Prefetch enables asynchronous prefetching of the baskets
+         */
+        bool Prefetch = false;
+        /**
+         * @brief ImplicitMTThreads if non-zero, decompress baskets in that many threads
+         */
+        unsigned ImplicitMTThreads = 0;
+    };
+    static ReadCache_t ReadCache;
+
+    /**
+     * @brief SetupReadCache applies ReadCache to the given tree
+     * @param tree tree which is read entry by entry, may be nullptr
+     */
+    static void SetupReadCache(TTree* tree);
+
     WrapTFileInput(const WrapTFileInput&) = delete;
     WrapTFileInput& operator= (const WrapTFileInput&) = delete;
 
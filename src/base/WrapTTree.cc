@@ -116,6 +116,21 @@ void WrapTTree::LinkBranches(bool requireOptional)
     LinkBranches(nullptr, requireOptional);
 }
 
+void WrapTTree::ActivateBranches()
+{
+    if(!Tree)
+        throw Exception("Set the Tree pointer before calling ActivateBranches");
+
+    for(const auto& b : branches) {
+        // skip optional branches which were not found
+        if(b.OptionalIsPresent && !*b.OptionalIsPresent)
+            continue;
+        // ROOT activates the size branch of arrays as well
+        const auto& fullbranchname = branchNamePrefix+b.Name;
+        Tree->SetBranchStatus(fullbranchname.c_str(), true);
+    }
+}
+
 bool WrapTTree::Matches(TTree* tree, bool exact, bool nowarn) const {
     if(tree == nullptr)
         tree = Tree;
@@ -69,6 +69,12 @@ public:
     // to avoid bogus LinkBranchs(nullptr, true) call
     void LinkBranches(bool requireOptional);
 
+    /**
+     * @brief ActivateBranches switches on reading of the linked branches (including their size branches)
+     * @note use together with Tree->SetBranchStatus("*", false) to read only the linked branches on GetEntry
+     */
+    void ActivateBranches();
+
     /**
      * @brief Matches checks if the branch names are all available
      * @param tree the tree to check
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+namespace ant {
+namespace std_ext {
+
+/**
+ * @brief The arena class is a chunked memory pool for many small, short-lived objects
+ *
+ * Memory is handed out by bumping a pointer inside the current chunk. Each chunk counts
+ * its live allocations and is recycled as a whole once all of them have been released,
+ * which happens naturally when the events holding the objects are dropped. Objects outliving
+ * their event simply keep their chunk alive, so handles never dangle. Only a few recycled
+ * chunks are kept for reuse, the others are returned to the heap.
+ *
+ * Each thread allocates from its own arena, see Get(). Objects may be released from any thread.
+ */
+class arena {
+    struct chunk_t {
+        std::size_t used = 0;
+        // the arena holds one reference while the chunk is its current one
+        std::atomic<std::size_t> live{1};
+        arena* const owner;
+        explicit chunk_t(arena* owner_) : owner(owner_) {}
+    };
+
+    // each allocation is preceded by the chunk it came from, nullptr if from the heap
+    static constexpr std::size_t align  = alignof(std::max_align_t);
+    static constexpr std::size_t header = (sizeof(chunk_t*) + align - 1) / align * align;
+    static constexpr std::size_t offset = (sizeof(chunk_t) + align - 1) / align * align;
+
+    const std::size_t chunksize;
+    const std::size_t maxUnused;
+
+    // only used by the thread owning the arena
+    chunk_t* current = nullptr;
+
+    // chunks are released from any thread
+    std::mutex mutex;
+    std::vector<chunk_t*> unused;
+    std::size_t nChunks = 0;
+    bool orphaned = false;
+    bool abandoned = false;
+
+    static char* data(chunk_t* chunk) noexcept {
+        return reinterpret_cast<char*>(chunk) + offset;
+    }
+
+    chunk_t* new_chunk() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!unused.empty()) {
+            auto chunk = unused.back();
+            unused.pop_back();
+            chunk->used = 0;
+            chunk->live.store(1, std::memory_order_relaxed);
+            return chunk;
+        }
+        auto chunk = new (::operator new(offset + chunksize)) chunk_t(this);
+        ++nChunks;
+        return chunk;
+    }
+
+    static void release(chunk_t* chunk) noexcept {
+        if(chunk->live.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        // the last reference is never the current chunk of its arena
+        chunk->owner->recycle(chunk);
+    }
+
+    void recycle(chunk_t* chunk) noexcept {
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // unused has reserved space for maxUnused chunks
+            if(!orphaned && unused.size() < maxUnused) {
+                unused.push_back(chunk);
+                return;
+            }
+            --nChunks;
+            ::operator delete(chunk);
+            last = abandoned && nChunks == 0;
+        }
+        if(last)
+            delete this;
+    }
+
+    // the arena of a finished thread deletes itself once its last chunk is released
+    void abandon() noexcept {
+        Orphan();
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            abandoned = true;
+            last = nChunks == 0;
+        }
+        if(last)
+            delete this;
+    }
+
+public:
+    explicit arena(std::size_t chunksize_ = 64*1024, std::size_t maxUnused_ = 16) :
+        chunksize(chunksize_), maxUnused(maxUnused_)
+    {
+        unused.reserve(maxUnused);
+    }
+
+    // all objects must have been released before
+    ~arena() {
+        Orphan();
+    }
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    void* allocate(std::size_t n) {
+        n = (n + align - 1) / align * align + header;
+
+        // large objects are not worth pooling
+        if(n > chunksize/4) {
+            auto p = static_cast<char*>(::operator new(n));
+            *reinterpret_cast<chunk_t**>(p) = nullptr;
+            return p + header;
+        }
+
+        // a full chunk is recycled once its last object is released
+        if(!current || current->used + n > chunksize) {
+            auto chunk = new_chunk();
+            if(current)
+                release(current);
+            current = chunk;
+        }
+
+        auto p = data(current) + current->used;
+        current->used += n;
+        current->live.fetch_add(1, std::memory_order_relaxed);
+        *reinterpret_cast<chunk_t**>(p) = current;
+        return p + header;
+    }
+
+    static void deallocate(void* ptr) noexcept {
+        auto p = static_cast<char*>(ptr) - header;
+        auto chunk = *reinterpret_cast<chunk_t**>(p);
+        if(chunk)
+            release(chunk);
+        else
+            ::operator delete(p);
+    }
+
+    /**
+     * @brief EndEvent rewinds the current chunk if all its objects have been released,
+     * call it from the allocating thread at event boundaries
+     */
+    void EndEvent() noexcept {
+        // only this thread adds objects to the current chunk
+        if(current && current->live.load(std::memory_order_acquire) == 1)
+            current->used = 0;
+    }
+
+    /**
+     * @brief Orphan gives up the current chunk and frees the unused ones,
+     * the arena must not allocate anymore afterwards
+     */
+    void Orphan() noexcept {
+        if(current)
+            release(current);
+        current = nullptr;
+        std::lock_guard<std::mutex> lock(mutex);
+        orphaned = true;
+        for(auto chunk : unused)
+            ::operator delete(chunk);
+        nChunks -= unused.size();
+        unused.clear();
+    }
+
+    /**
+     * @brief Chunks number of chunks currently allocated from the heap, in use or kept for reuse
+     */
+    std::size_t Chunks() noexcept {
+        std::lock_guard<std::mutex> lock(mutex);
+        return nChunks;
+    }
+
+    /**
+     * @brief Get returns the arena of the calling thread used for the event objects
+     */
+    static arena& Get() {
+        // the arena outlives its thread as long as objects in static storage or
+        // handed to other threads are not released
+        struct holder_t {
+            arena* instance = new arena();
+            ~holder_t() { instance->abandon(); }
+        };
+        thread_local holder_t holder;
+        return *holder.instance;
+    }
+};
+
+/**
+ * @brief The arena_allocator struct allocates from arena::Get(), usable with std::allocate_shared
+ */
+template<class T>
+struct arena_allocator {
+    using value_type = T;
+
+    arena_allocator() noexcept = default;
+    template<class U>
+    arena_allocator(const arena_allocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(arena::Get().allocate(n*sizeof(T)));
+    }
+    void deallocate(T* p, std::size_t) noexcept {
+        arena::deallocate(p);
+    }
+
+    template<class U>
+    bool operator==(const arena_allocator<U>&) const noexcept { return true; }
+    template<class U>
+    bool operator!=(const arena_allocator<U>&) const noexcept { return false; }
+};
+
+/**
+ * @brief make_arena_shared is the drop-in replacement of std::make_shared for event objects,
+ * object and control block share one allocation from the arena
+ */
+template<class T, class... Args>
+std::shared_ptr<T> make_arena_shared(Args&&... args) {
+    return std::allocate_shared<T>(arena_allocator<T>(), std::forward<Args>(args)...);
+}
+
+}} // namespace ant::std_ext
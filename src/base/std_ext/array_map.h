@@ -0,0 +1,152 @@
+#pragma once
+
+#include "base/std_ext/mapped_vectors.h" // to_integral
+
+#include <array>
+#include <bitset>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace ant {
+namespace std_ext {
+
+/**
+ * @brief The array_map class is a std::map replacement for small enum-like keys
+ *
+ * All N slots live in a fixed array indexed by the key, so lookup and insertion
+ * never allocate. Iteration visits only the present keys in ascending order, just like std::map.
+ * clear() keeps the mapped values (and their capacity) for reuse, hence T must provide clear().
+ */
+template<typename Key, typename T, std::size_t N>
+class array_map {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+
+private:
+    std::array<value_type, N> slots;
+    std::bitset<N> present;
+
+    static std::size_t index(const Key& key) {
+        return static_cast<std::size_t>(to_integral(key));
+    }
+
+    static std::size_t checked_index(const Key& key) {
+        const auto i = index(key);
+        if(i>=N)
+            throw std::out_of_range("Key exceeds array_map size");
+        return i;
+    }
+
+    std::size_t next(std::size_t i) const {
+        while(i<N && !present.test(i))
+            ++i;
+        return i;
+    }
+
+public:
+
+    template<bool Const>
+    class iterator_t : public std::iterator<std::forward_iterator_tag, value_type> {
+        using map_t = typename std::conditional<Const, const array_map, array_map>::type;
+        map_t* m;
+        std::size_t i;
+    public:
+        using reference = typename std::conditional<Const, const value_type&, value_type&>::type;
+        using pointer = typename std::conditional<Const, const value_type*, value_type*>::type;
+
+        iterator_t(map_t* m_, std::size_t i_) : m(m_), i(i_) {}
+
+        // iterator converts to const_iterator
+        operator iterator_t<true>() const { return {m, i}; }
+
+        std::size_t pos() const { return i; }
+
+        reference operator*() const { return m->slots[i]; }
+        pointer operator->() const { return &m->slots[i]; }
+
+        iterator_t& operator++() { i = m->next(i+1); return *this; }
+        iterator_t operator++(int) { auto tmp = *this; ++(*this); return tmp; }
+
+        template<bool C>
+        bool operator==(const iterator_t<C>& rhs) const { return i == rhs.pos(); }
+        template<bool C>
+        bool operator!=(const iterator_t<C>& rhs) const { return i != rhs.pos(); }
+    };
+
+    using iterator = iterator_t<false>;
+    using const_iterator = iterator_t<true>;
+
+    array_map() {
+        for(std::size_t i=0;i<N;i++)
+            slots[i].first = static_cast<Key>(i);
+    }
+
+    iterator begin() { return {this, next(0)}; }
+    iterator end() { return {this, N}; }
+    const_iterator begin() const { return {this, next(0)}; }
+    const_iterator end() const { return {this, N}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    std::size_t size() const { return present.count(); }
+    bool empty() const { return present.none(); }
+
+    iterator find(const Key& key) {
+        const auto i = index(key);
+        return {this, i<N && present.test(i) ? i : N};
+    }
+
+    const_iterator find(const Key& key) const {
+        const auto i = index(key);
+        return {this, i<N && present.test(i) ? i : N};
+    }
+
+    std::size_t count(const Key& key) const {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    T& operator[](const Key& key) {
+        const auto i = checked_index(key);
+        present.set(i);
+        return slots[i].second;
+    }
+
+    /**
+     * @brief insert moves the value into its slot, unless the key is already present (same as std::map)
+     * @return iterator to the element with the key and true if inserted
+     */
+    std::pair<iterator, bool> insert(value_type&& value) {
+        const auto i = checked_index(value.first);
+        if(present.test(i))
+            return {{this, i}, false};
+        present.set(i);
+        slots[i].second = std::move(value.second);
+        return {{this, i}, true};
+    }
+
+    // the hint is not needed, but kept for std::map compatibility
+    iterator insert(const_iterator, value_type&& value) {
+        return insert(std::move(value)).first;
+    }
+
+    std::size_t erase(const Key& key) {
+        const auto i = index(key);
+        if(i>=N || !present.test(i))
+            return 0;
+        slots[i].second.clear();
+        present.reset(i);
+        return 1;
+    }
+
+    void clear() {
+        for(std::size_t i=next(0);i<N;i=next(i+1))
+            slots[i].second.clear();
+        present.reset();
+    }
+};
+
+}} // namespace ant::std_ext
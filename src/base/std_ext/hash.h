@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <type_traits>
+
+namespace ant {
+namespace std_ext {
+
+/**
+ * @brief The fnv1a_t struct computes the 64bit FNV-1a hash of everything added
+ *
+ * Not suited for anything cryptographic, but fast and stable across platforms
+ * (as long as the byte order is the same), so it can be used for file names and keys.
+ */
+struct fnv1a_t {
+    std::uint64_t Value = 14695981039346656037ull;
+
+    fnv1a_t& Add(const void* data, std::size_t size) {
+        auto bytes = reinterpret_cast<const unsigned char*>(data);
+        for(std::size_t i=0;i<size;i++) {
+            Value ^= bytes[i];
+            Value *= 1099511628211ull;
+        }
+        return *this;
+    }
+
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value, fnv1a_t&>::type
+    Add(const T& t) {
+        return Add(&t, sizeof(T));
+    }
+
+    fnv1a_t& Add(const std::string& s) {
+        // include size such that concatenations differ
+        Add(s.size());
+        return Add(s.data(), s.size());
+    }
+
+    std::string AsHex() const {
+        std::stringstream ss;
+        ss << std::hex << std::setw(16) << std::setfill('0') << Value;
+        return ss.str();
+    }
+};
+
+}} // namespace ant::std_ext
@@ -5,6 +5,8 @@
 #include <functional>
 #include <algorithm>
 
+#include "arena.h"
+
 namespace ant {
 namespace std_ext {
 
@@ -196,7 +198,7 @@ public:
     template<class... Args>
     void emplace_back(Args&&... args)
     {
-        c.emplace_back(std::make_shared<T>(std::forward<Args>(args)...));
+        c.emplace_back(make_arena_shared<T>(std::forward<Args>(args)...));
     }
 
     template<class it_t>
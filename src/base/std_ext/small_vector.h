@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+namespace ant {
+namespace std_ext {
+
+/**
+ * @brief The small_vector class keeps up to N elements inline, only larger sizes allocate from the heap
+ *
+ * Useful for many tiny containers, such as the raw data of each detector hit.
+ * Only supports trivial types, they are copied as plain memory.
+ */
+template<typename T, std::size_t N>
+class small_vector {
+    static_assert(std::is_trivial<T>::value, "small_vector only supports trivial types");
+    static_assert(N > 0, "small_vector needs some inline capacity");
+
+    std::uint32_t n = 0;
+    std::uint32_t cap = N;
+    std::unique_ptr<T[]> heap;
+    T local[N];
+
+    void steal(small_vector& o) noexcept {
+        if(o.heap) {
+            heap = std::move(o.heap);
+            cap = o.cap;
+        }
+        else {
+            std::memcpy(local, o.local, o.n*sizeof(T));
+        }
+        n = o.n;
+        o.n = 0;
+        o.cap = N;
+    }
+
+public:
+    using value_type      = T;
+    using size_type       = std::size_t;
+    using iterator        = T*;
+    using const_iterator  = const T*;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reference       = T&;
+    using const_reference = const T&;
+
+    small_vector() noexcept {}
+
+    small_vector(std::initializer_list<T> l) {
+        assign(l.begin(), l.end());
+    }
+
+    template<typename It, typename = typename std::enable_if<!std::is_integral<It>::value>::type>
+    small_vector(It first, It last) {
+        assign(first, last);
+    }
+
+    small_vector(const small_vector& o) {
+        assign(o.begin(), o.end());
+    }
+
+    small_vector& operator=(const small_vector& o) {
+        if(this != std::addressof(o))
+            assign(o.begin(), o.end());
+        return *this;
+    }
+
+    small_vector(small_vector&& o) noexcept {
+        steal(o);
+    }
+
+    small_vector& operator=(small_vector&& o) noexcept {
+        if(this != std::addressof(o)) {
+            heap.reset();
+            cap = N;
+            steal(o);
+        }
+        return *this;
+    }
+
+    template<typename It>
+    void assign(It first, It last) {
+        clear();
+        for(; first != last; ++first)
+            push_back(*first);
+    }
+
+    T*       data()       noexcept { return heap ? heap.get() : local; }
+    const T* data() const noexcept { return heap ? heap.get() : local; }
+
+    size_type size()     const noexcept { return n; }
+    size_type capacity() const noexcept { return cap; }
+    bool      empty()    const noexcept { return n == 0; }
+
+    iterator       begin()       noexcept { return data(); }
+    iterator       end()         noexcept { return data()+n; }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end()   const noexcept { return data()+n; }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend()   const noexcept { return const_reverse_iterator(begin()); }
+
+    T&       operator[](size_type i)       noexcept { return data()[i]; }
+    const T& operator[](size_type i) const noexcept { return data()[i]; }
+    T&       front()       noexcept { return data()[0]; }
+    const T& front() const noexcept { return data()[0]; }
+    T&       back()        noexcept { return data()[n-1]; }
+    const T& back()  const noexcept { return data()[n-1]; }
+
+    void reserve(size_type k) {
+        if(k <= cap)
+            return;
+        std::unique_ptr<T[]> p(new T[k]);
+        std::memcpy(p.get(), data(), n*sizeof(T));
+        heap = std::move(p);
+        cap = static_cast<std::uint32_t>(k);
+    }
+
+    // new elements are value-initialized, as for std::vector
+    void resize(size_type k) {
+        reserve(k);
+        if(k > n)
+            std::fill(data()+n, data()+k, T());
+        n = static_cast<std::uint32_t>(k);
+    }
+
+    void push_back(const T& v) {
+        // v might refer to an element of this
+        const T copy = v;
+        if(n == cap)
+            reserve(2*cap);
+        data()[n++] = copy;
+    }
+
+    // keeps the capacity
+    void clear() noexcept { n = 0; }
+
+    friend bool operator==(const small_vector& a, const small_vector& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    friend bool operator!=(const small_vector& a, const small_vector& b) {
+        return !(a == b);
+    }
+};
+
+}} // namespace ant::std_ext
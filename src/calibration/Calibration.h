@@ -3,8 +3,10 @@
 #include "reconstruct/Reconstruct_traits.h"
 #include "calibration/gui/Manager_traits.h"
 #include "base/OptionsList.h"
+#include "tree/TDetectorReadHit.h"
 
 #include <vector>
+#include <cstdint>
 
 namespace ant {
 
@@ -19,14 +21,14 @@ public:
     };
 
     /**
-     * @brief The Converter struct handles the transition from raw bytes
+     * @brief The Converter struct handles the transition from raw data
      * to somewhat meaningful values (not necessarily with physically meaningful units)
      *
      */
     struct Converter {
         using ptr_t = std::shared_ptr<const Converter>;
 
-        virtual std::vector<double> Convert(const std::vector<uint8_t>& rawData) const = 0;
+        virtual std::vector<double> Convert(const TDetectorReadHit::RawData_t& rawData) const = 0;
         virtual ~Converter() = default;
     };
 
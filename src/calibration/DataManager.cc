@@ -6,6 +6,7 @@
 #include "base/Logger.h"
 #include "base/std_ext/memory.h"
 #include "base/interval.h"
+#include "base/std_ext/hash.h"
 #include "tree/TCalibrationData.h"
 
 //ROOT
@@ -59,9 +60,82 @@ bool DataManager::GetData(const string& calibrationID, const TID& eventID, TCali
 
 bool DataManager::GetData(const string& calibrationID,
                           const TID& eventID, TCalibrationData& cdata, TID& nextChangePoint) const
+{
+    auto access = Query(calibrationID, eventID, cdata, nextChangePoint);
+    const bool found = access.Found;
+    if(recordAccesses)
+        accesses.emplace(accessKey_t{calibrationID, eventID.Flags, eventID.Timestamp, eventID.Lower}, move(access));
+    return found;
+}
+
+bool DataManager::Access_t::operator==(const Access_t& other) const
+{
+    return CalibrationID == other.CalibrationID &&
+            EventID == other.EventID &&
+            Found == other.Found &&
+            TimeStamp == other.TimeStamp &&
+            FirstID == other.FirstID &&
+            LastID == other.LastID &&
+            NextChangePoint == other.NextChangePoint &&
+            DataHash == other.DataHash;
+}
+
+uint64_t DataManager::HashData(const TCalibrationData& cdata)
+{
+    std_ext::fnv1a_t hash;
+    for(const auto& entry : cdata.Data)
+        hash.Add(entry.Key).Add(entry.Value);
+    for(const auto& params : cdata.FitParameters) {
+        hash.Add(params.Key).Add(params.Value.size());
+        for(auto v : params.Value)
+            hash.Add(v);
+    }
+    return hash.Value;
+}
+
+DataManager::Access_t DataManager::Query(const string& calibrationID, const TID& eventID,
+                                         TCalibrationData& cdata, TID& nextChangePoint) const
 {
     Init();
-    return dataBase->GetItem(calibrationID,eventID,cdata,nextChangePoint);
+    Access_t access;
+    access.CalibrationID = calibrationID;
+    access.EventID = eventID;
+    access.Found = dataBase->GetItem(calibrationID, eventID, cdata, nextChangePoint);
+    access.NextChangePoint = nextChangePoint;
+    if(access.Found) {
+        access.TimeStamp = cdata.TimeStamp;
+        access.FirstID = cdata.FirstID;
+        access.LastID = cdata.LastID;
+        access.DataHash = HashData(cdata);
+    }
+    return access;
+}
+
+void DataManager::RecordAccesses(bool v)
+{
+    recordAccesses = v;
+}
+
+DataManager::AccessLog_t DataManager::GetAccessLog() const
+{
+    AccessLog_t log;
+    log.reserve(accesses.size());
+    for(const auto& access : accesses)
+        log.emplace_back(access.second);
+    return log;
+}
+
+bool DataManager::ReproducesAccessLog(const AccessLog_t& log) const
+{
+    for(const auto& access : log) {
+        TCalibrationData cdata;
+        TID nextChangePoint;
+        if(Query(access.CalibrationID, access.EventID, cdata, nextChangePoint) != access) {
+            VLOG(5) << "Calibration data for " << access.CalibrationID << " at " << access.EventID << " has changed";
+            return false;
+        }
+    }
+    return true;
 }
 
 size_t DataManager::GetNumberOfCalibrationIDs() const
@@ -1,17 +1,21 @@
 #pragma once
 
 #include "Calibration.h"
+#include "tree/TID.h"
 
 //std
 #include <list>
 #include <string>
 #include <memory>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <cstdint>
 
 namespace ant
 {
 
 struct TCalibrationData;
-struct TID;
 
 namespace calibration
 {
@@ -55,6 +59,40 @@ private:
 
     bool override_as_default = false;
 
+public:
+
+    /**
+     * @brief The Access_t struct records one request to GetData and its answer
+     *
+     * The calibration data itself is only represented by its hash,
+     * see DataManager::RecordAccesses
+     */
+    struct Access_t {
+        std::string   CalibrationID;
+        TID           EventID;
+        bool          Found = false;
+        std::int64_t  TimeStamp = 0;
+        TID           FirstID;
+        TID           LastID;
+        TID           NextChangePoint;
+        std::uint64_t DataHash = 0;
+
+        bool operator==(const Access_t& other) const;
+        bool operator!=(const Access_t& other) const { return !(*this == other); }
+    };
+    using AccessLog_t = std::vector<Access_t>;
+
+private:
+
+    // repeated requests for the same ID and event are recorded once,
+    // the key is calibration ID and TID (Flags, Timestamp, Lower), as TID::operator< is not a strict ordering
+    using accessKey_t = std::tuple<std::string, std::uint32_t, std::uint32_t, std::uint32_t>;
+    bool recordAccesses = false;
+    mutable std::map<accessKey_t, Access_t> accesses;
+    static std::uint64_t HashData(const TCalibrationData& cdata);
+    Access_t Query(const std::string& calibrationID, const TID& eventID,
+                   TCalibrationData& cdata, TID& nextChangePoint) const;
+
 public:
     DataManager(const std::string& calibrationDataFolder_);
     virtual ~DataManager();
@@ -70,6 +108,24 @@ public:
                  TCalibrationData& cdata,
                  TID& nextChangePoint) const;
 
+    /**
+     * @brief RecordAccesses starts/stops recording the requests made by GetData
+     * @note off by default, as only needed to validate caches, see GetAccessLog
+     */
+    void RecordAccesses(bool v);
+
+    /**
+     * @brief GetAccessLog returns the distinct requests made by GetData while recording
+     */
+    AccessLog_t GetAccessLog() const;
+
+    /**
+     * @brief ReproducesAccessLog repeats the given requests
+     * @param log as obtained by GetAccessLog, possibly from an earlier run
+     * @return true if the database still answers every request with the same data
+     */
+    bool ReproducesAccessLog(const AccessLog_t& log) const;
+
     // the following methods are only useful for test cases
     std::list<std::string> GetCalibrationIDs() const;
     std::size_t GetNumberOfCalibrationIDs() const;
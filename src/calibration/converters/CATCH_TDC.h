@@ -15,7 +15,7 @@ struct CATCH_TDC : MultiHitReference<std::uint16_t> {
         MultiHitReference(referenceChannel, Gains::CATCH_TDC)
     {}
 
-    virtual std::vector<double> Convert(const std::vector<uint8_t>& rawData) const override
+    virtual std::vector<double> Convert(const TDetectorReadHit::RawData_t& rawData) const override
     {
         // we can only convert if we have exactly one reference hit timing
         if(ReferenceHits.size() != 1)
@@ -12,13 +12,13 @@ namespace converter {
 struct GeSiCa_SADC : Calibration::Converter {
 
 
-    virtual std::vector<double> Convert(const std::vector<uint8_t>& rawData) const override
+    virtual std::vector<double> Convert(const TDetectorReadHit::RawData_t& rawData) const override
     {
-        if(rawData.size() != 6) // expect three 16bit values
+        if(rawData.size() != 3) // expect three 16bit values
           return {};
 
-        const double pedestal = *reinterpret_cast<const uint16_t*>(&rawData[0]);
-        const double signal = *reinterpret_cast<const uint16_t*>(&rawData[2]);
+        const double pedestal = rawData[0];
+        const double signal = rawData[1];
 
         // return vector with size 1 and pedestal subtracted signal
         return {signal - pedestal};
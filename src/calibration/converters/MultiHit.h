@@ -4,6 +4,7 @@
 
 #include <vector>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 
 namespace ant {
@@ -14,7 +15,7 @@ template<typename T>
 struct MultiHit : Calibration::Converter {
 
 
-    virtual std::vector<double> Convert(const std::vector<uint8_t>& rawData) const override
+    virtual std::vector<double> Convert(const TDetectorReadHit::RawData_t& rawData) const override
     {
         // just convert T to double
         return ConvertRaw<double>(rawData);
@@ -22,15 +23,17 @@ struct MultiHit : Calibration::Converter {
 
 protected:
     template<typename U = T>
-    static std::vector<U> ConvertRaw(const std::vector<std::uint8_t>& rawData)
+    static std::vector<U> ConvertRaw(const TDetectorReadHit::RawData_t& rawData)
     {
-        constexpr std::size_t wordsize = sizeof(T)/sizeof(std::uint8_t);
+        static_assert(sizeof(T) % sizeof(std::uint16_t) == 0, "T must consist of 16bit words");
+        constexpr std::size_t wordsize = sizeof(T)/sizeof(std::uint16_t);
         if(rawData.size() % wordsize  != 0)
             return {};
         std::vector<U> ret(rawData.size()/wordsize);
         for(size_t i=0;i<ret.size();i++) {
-            const T* rawVal = reinterpret_cast<const T*>(std::addressof(rawData[wordsize*i]));
-            ret[i] = static_cast<U>(*rawVal);
+            T rawVal;
+            std::memcpy(std::addressof(rawVal), std::addressof(rawData[wordsize*i]), sizeof(T));
+            ret[i] = static_cast<U>(rawVal);
         }
         return ret;
     }
@@ -27,7 +27,7 @@ struct MultiHitReference : MultiHit<T>, ReconstructHook::DetectorReadHits {
         Gain(gain)
     {}
 
-    virtual std::vector<double> Convert(const std::vector<uint8_t>& rawData) const override
+    virtual std::vector<double> Convert(const TDetectorReadHit::RawData_t& rawData) const override
     {
         // we can only convert if we have a reference hit timing
         if(ReferenceHits.size() != 1)
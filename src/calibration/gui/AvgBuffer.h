@@ -3,6 +3,8 @@
 #include <memory>
 #include <list>
 #include <queue>
+#include <vector>
+#include <stdexcept>
 #include <cassert>
 
 #include "AvgBuffer_traits.h"
@@ -89,12 +91,23 @@ class AvgBuffer_SavitzkyGolay : public AvgBuffer_traits<AvgBufferItem> {
 protected:
     using Traits = AvgBufferItem_traits<AvgBufferItem>;
 
-    struct buffer_entry {
-        buffer_entry(const std::shared_ptr<AvgBufferItem>& h, const interval<TID>& ID) : hist(h), id(ID) {}
+    struct work_entry {
+        work_entry(const std::shared_ptr<AvgBufferItem>& h, const interval<TID>& ID) : hist(h), id(ID) {}
         std::shared_ptr<AvgBufferItem> hist;
         interval<TID> id;
     };
 
+    struct buffer_entry : work_entry {
+        buffer_entry(const std::shared_ptr<AvgBufferItem>& h, const interval<TID>& ID) : work_entry(h, ID) {
+            // copy the bin contents once, they are needed for smoothing all neighbours
+            const auto nBins = Traits::GetNBins(*h);
+            bins.reserve(nBins);
+            for(auto bin=0;bin<nBins;bin++)
+                bins.push_back(Traits::GetBin(*h, bin));
+        }
+        std::vector<double> bins;
+    };
+
 
     struct buffer_t : std::list<buffer_entry> {
         using std::list<buffer_entry>::list;
@@ -106,7 +119,8 @@ protected:
 
     buffer_t m_buffer; // buffered histograms for smoothing
 
-    std::queue<buffer_entry> worklist;
+    // the smoothed items, their bins are not needed anymore
+    std::queue<work_entry> worklist;
 
     bool startup_done = false;
     const std::size_t m_sum_length;
@@ -131,19 +145,18 @@ protected:
 
         // h is the destination of the smoothing
 
-        // range is relative to i and inclusive, so take distance-to-end-1
-        const interval<int> range(-std::distance(m_buffer.begin(), i),
-                                  std::distance(i, m_buffer.end())-1);
-
-        for(auto bin=0;bin<nBins;bin++) {
-            auto getY = [i,bin,normalization] (const int i_) {
-                return Traits::GetBin(*std::next(i, i_)->hist, bin)/normalization;
-            };
-            auto setY = [h,bin] (const double v) {
-                Traits::SetBin(*h, bin, v);
-            };
-            sg.Convolute(getY, setY, range);
+        // smooth all bins of the buffered items in one go
+        std::vector<const double*> ys;
+        for(const auto& entry : m_buffer) {
+            if(entry.bins.size() != std::size_t(nBins))
+                throw std::runtime_error("Buffered items must have equal number of bins for smoothing");
+            ys.push_back(entry.bins.data());
         }
+        std::vector<double> smoothed(nBins);
+        sg.Convolute(ys, std::distance(m_buffer.begin(), i), nBins, smoothed.data());
+
+        for(auto bin=0;bin<nBins;bin++)
+            Traits::SetBin(*h, bin, smoothed[bin]/normalization);
 
         return h;
     }
@@ -165,7 +178,7 @@ public:
     void Push(std::shared_ptr<AvgBufferItem> h, const interval<TID>& id) override
     {
         // add the item to the buffer
-        m_buffer.emplace_back(buffer_entry(h, id));
+        m_buffer.emplace_back(h, id);
 
 
         // pop elements from buffer
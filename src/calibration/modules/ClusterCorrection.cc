@@ -53,10 +53,9 @@ void ClusterCorrection::ApplyTo(clusters_t& clusters)
 
         if(entry != clusters.end()) {
 
-            for(auto& cluster : entry->second) {
-
-                ApplyTo(cluster);
+            ApplyToAll(entry->second);
 
+            for(auto& cluster : entry->second) {
                 if(cluster.Energy < 0.0)
                     cluster.Energy = 0.0;
             }
@@ -64,6 +63,22 @@ void ClusterCorrection::ApplyTo(clusters_t& clusters)
     }
 }
 
+void ClusterCorrection::ApplyToAll(TClusterList& clusters)
+{
+    for(auto& cluster : clusters)
+        ApplyTo(cluster);
+}
+
+void ClusterCorrection::InterpolateBatch()
+{
+    // same as ClippedInterpolatorWrapper::GetPoint for each point
+    for(auto& x : x_batch)
+        x = interpolator->xrange.clip(x);
+    for(auto& y : y_batch)
+        y = interpolator->yrange.clip(y);
+    interpolator->interp->GetPoints(x_batch, y_batch, z_batch);
+}
+
 
 std::list<Updateable_traits::Loader_t> ClusterCorrection::GetLoaders()
 {
@@ -105,12 +120,40 @@ void ClusterSmearing::ApplyTo(TCluster& cluster)
     cluster.Energy    = gRandom->Gaus(cluster.Energy, sigma);
 }
 
+void ClusterSmearing::ApplyToAll(TClusterList& clusters)
+{
+    x_batch.clear();
+    y_batch.clear();
+    for(const auto& cluster : clusters) {
+        x_batch.push_back(cluster.Energy);
+        y_batch.push_back(cos(cluster.Position.Theta()));
+    }
+    InterpolateBatch();
+    auto sigma = z_batch.begin();
+    for(auto& cluster : clusters)
+        cluster.Energy = gRandom->Gaus(cluster.Energy, *sigma++);
+}
+
 void ClusterECorr::ApplyTo(TCluster& cluster)
 {
     const auto factor  = interpolator->GetPoint(cluster.Energy, cluster.Hits.size());
     cluster.Energy    *= factor;
 }
 
+void ClusterECorr::ApplyToAll(TClusterList& clusters)
+{
+    x_batch.clear();
+    y_batch.clear();
+    for(const auto& cluster : clusters) {
+        x_batch.push_back(cluster.Energy);
+        y_batch.push_back(cluster.Hits.size());
+    }
+    InterpolateBatch();
+    auto factor = z_batch.begin();
+    for(auto& cluster : clusters)
+        cluster.Energy *= *factor++;
+}
+
 ClusterCorrectionManual::ClusterCorrectionManual(std::shared_ptr<ClusterDetector_t> det,
                                                  const std::string &Name, const Filter_t Filter,
                                                  std::shared_ptr<DataManager> calmgr
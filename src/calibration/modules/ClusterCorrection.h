@@ -8,6 +8,7 @@
 #include "tree/TID.h" // for TKeyValue, TID
 
 #include <memory>
+#include <vector>
 
 
 namespace ant {
@@ -37,6 +38,10 @@ public:
 
     virtual void ApplyTo(TCluster& cluster) =0;
 
+    // applies the correction to all clusters of the detector,
+    // override to evaluate the correction surface in one batch
+    virtual void ApplyToAll(TClusterList& clusters);
+
     // Updateable_traits interface
     virtual std::list<Loader_t> GetLoaders() override;
 
@@ -55,6 +60,13 @@ protected:
 
     std::unique_ptr<ClippedInterpolatorWrapper> interpolator;
 
+    // buffers for the batch evaluation
+    std::vector<double> x_batch;
+    std::vector<double> y_batch;
+    std::vector<double> z_batch;
+
+    // evaluates the clipped interpolator at x_batch/y_batch into z_batch
+    void InterpolateBatch();
 };
 
 /**
@@ -64,7 +76,8 @@ class ClusterSmearing : public ClusterCorrection {
 public:
     using ClusterCorrection::ClusterCorrection;
 
-    void ApplyTo(TCluster& cluster);
+    void ApplyTo(TCluster& cluster) override;
+    void ApplyToAll(TClusterList& clusters) override;
 };
 
 /**
@@ -74,7 +87,8 @@ class ClusterECorr : public ClusterCorrection {
 public:
     using ClusterCorrection::ClusterCorrection;
 
-    void ApplyTo(TCluster& cluster);
+    void ApplyTo(TCluster& cluster) override;
+    void ApplyToAll(TClusterList& clusters) override;
 };
 
 class ClusterCorrectionManual : public ClusterCorrection {
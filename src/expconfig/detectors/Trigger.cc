@@ -96,8 +96,8 @@ void ant::expconfig::detector::Trigger_2014::ApplyTo(const ReconstructHook::Base
         if(readhit.ChannelType != Channel_t::Type_t::BitPattern)
             continue;
         assert(readhit.Channel < patterns.size());
-        assert(readhit.RawData.size() == 2); // expect 2 bytes
-        patterns[readhit.Channel] = *reinterpret_cast<const uint16_t*>(addressof(readhit.RawData[0]));
+        assert(readhit.RawData.size() == 1); // expect one 16bit word
+        patterns[readhit.Channel] = readhit.RawData.front();
     }
 }
 
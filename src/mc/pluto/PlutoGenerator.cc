@@ -41,65 +41,68 @@ Cocktail::Cocktail(const string& outfile,
 
 void Cocktail::initLUT()
 {
-    // helpers:
-    double acc_E = 0;
-
     // -- Init outputfile and Tree --
     _data = _fileOutput.CreateInside<TTree>("data","Event data");
 
     // -- Init root - random engine ---
     _rndEngine = new TRandom3(0);
 
+    const auto channels = data::Query::GetProductionChannels(ChannelSelector);
+
+    std::vector<double> energyWeights;
+
     for(double energy : _energies)
     {
         BinContent currentBin;
         // -- Energy in MeV --
         currentBin.Energy = energy;
 
-        // -- Statistics for Energy --
-        //    p(E) = f(E) * totalXsection(E)
-        acc_E += _energyFunction(currentBin.Energy) * data::Query::TotalXsection(currentBin.Energy,ChannelSelector);
-        currentBin.AccProbability = acc_E;
-
         // -- Statistics for Channels in this energy bin --
-        //    Generate accumulated probabilities with PReaction(tm)
-        //    for all channels in at current energy
-        double acc_prob_channels = 0;
-        for ( auto& product: data::Query::GetProductionChannels(ChannelSelector))
+        //    tabulate the cross sections once and build the reactions
+        //    for all channels at current energy, in the same order as before,
+        //    since preheating the reactions draws random numbers
+        std::vector<double> xsections;
+        for ( auto& product: channels)
         {
             double xsection = data::Query::Xsection(product, currentBin.Energy);
 
             if ( xsection > 0)  // make sure channel is available
             {
-                acc_prob_channels += xsection;
-
-                currentBin.ReactionLUT.emplace_back(BinContent::Reaction_t(acc_prob_channels,
-                                                                           makeReaction(currentBin.Energy,product)));
+                currentBin.Reactions.emplace_back(makeReaction(currentBin.Energy,product));
+                xsections.push_back(xsection);
             }
         }
+
+        // -- Statistics for Energy --
+        //    p(E) = f(E) * totalXsection(E)
+        double totalXsection = 0;
+        for(auto xsection : xsections)
+            totalXsection += xsection;
+        energyWeights.push_back(_energyFunction(currentBin.Energy) * totalXsection);
+
+        if(!xsections.empty())
+            currentBin.ReactionTable = AliasTable(xsections);
+
         // -- fill --
-        _energyBins.emplace_back(currentBin);
+        _energyBins.emplace_back(move(currentBin));
     }
+
+    // without any available channel, the table stays empty
+    double totalWeight = 0;
+    for(auto weight : energyWeights)
+        totalWeight += weight;
+    if(totalWeight > 0)
+        _energyTable = AliasTable(energyWeights);
 }
 
 PReaction* Cocktail::getRandomReaction() const
 {
-    double rndEnergyBinValue = _rndEngine->Rndm() * _energyBins.back().AccProbability;
+    if(_energyTable.empty())
+        return nullptr;
 
-    for (auto& eBin: _energyBins)
-    {
-        if ( rndEnergyBinValue <= eBin.AccProbability )
-        {
-            double rndChannelValue = _rndEngine->Rndm() * eBin.ReactionLUT.back().AccProb;
-            for (auto& reactrion: eBin.ReactionLUT)
-            {
-                if ( rndChannelValue <= reactrion.AccProb ){
-                    return reactrion.PlutoReaction;
-                }
-            }
-        }
-    }
-    return nullptr;
+    // bins without any channel have zero weight and are never picked
+    auto& eBin = _energyBins[_energyTable.Sample(_rndEngine->Rndm())];
+    return eBin.Reactions[eBin.ReactionTable.Sample(_rndEngine->Rndm())];
 }
 
 
@@ -125,7 +128,12 @@ unsigned long Cocktail::Sample(const unsigned long &nevts) const
     unsigned long errors(0);
 
     for ( unsigned long evt = 0 ; evt < nevts ; ++evt){
-        errors += 1 - getRandomReaction()->Loop(1,0,0); // reminder: Loop(numEvents,weightFlag,verbose)....
+        auto reaction = getRandomReaction();
+        if(!reaction) { // no channel available at any energy
+            ++errors;
+            continue;
+        }
+        errors += 1 - reaction->Loop(1,0,0); // reminder: Loop(numEvents,weightFlag,verbose)....
                                                                                         //weight does nothing??!!
     }
     return errors;
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "base/WrapTFile.h"
+#include "base/AliasTable.h"
 
 #include "mc/database/Query.h"
 #include "PlutoFactory.h"
@@ -59,18 +60,9 @@ private:
      *        The data is provided by A2ChannelManager
      */
     struct BinContent{
-        struct Reaction_t{
-            const double AccProb;
-            PReaction*   PlutoReaction;
-            Reaction_t(double accProb, PReaction* pReaction):
-                AccProb(accProb),
-                PlutoReaction(pReaction){}
-        };
-
         double Energy; // in MeV
-        double AccProbability;
-        std::vector<std::string> DecayProducts;
-        std::vector<Reaction_t>  ReactionLUT;
+        std::vector<PReaction*> Reactions;
+        AliasTable ReactionTable; // weighted by cross section
     };
 
 
@@ -86,6 +78,7 @@ private:
 
     //-- data:
     std::vector<BinContent> _energyBins;
+    AliasTable _energyTable; // weighted by f(E) * total cross section, empty if no channel is available
 
     //-- Tools ---
     TRandom3* _rndEngine;
@@ -96,7 +89,7 @@ private:
 
     /**
      * @brief getRandomReaction
-     * @return pointer to randomly picked Pluto reaction from database
+     * @return pointer to randomly picked Pluto reaction from database, nullptr if no channel is available
      */
     PReaction* getRandomReaction() const;
 
@@ -9,6 +9,7 @@
 #include "tree/TEventData.h"
 
 #include "base/std_ext/container.h"
+#include "base/std_ext/string.h"
 #include "base/Logger.h"
 
 #include <algorithm>
@@ -16,6 +17,8 @@
 #include <iterator>
 #include <limits>
 #include <cassert>
+#include <cmath>
+#include <cxxabi.h>
 
 using namespace std;
 using namespace ant;
@@ -51,6 +54,21 @@ List getSortedHooks() {
     return hooks;
 }
 
+template<typename List>
+vector<Profiler::Stage_t*> getHookStages(const List& hooks) {
+    vector<Profiler::Stage_t*> stages;
+    for(const auto& hook : hooks) {
+        const auto& h = *hook;
+        unique_ptr<char, void(*)(void*)> demangled(
+                    abi::__cxa_demangle(typeid(h).name(), nullptr, nullptr, nullptr), free);
+        string name = demangled ? demangled.get() : typeid(h).name();
+        if(std_ext::string_starts_with(name, "ant::"))
+            name = name.substr(5);
+        stages.push_back(addressof(Profiler::GetStage("Reconstruct/Hook/"+name)));
+    }
+    return stages;
+}
+
 Reconstruct::sorted_detectors_t Reconstruct::sorted_detectors_t::Build()
 {
     sorted_detectors_t sorted_detectors;
@@ -72,7 +90,16 @@ Reconstruct::Reconstruct(clustering_t clustering_, candidatebuilder_t candidateb
     hooks_eventdata(getSortedHooks<decltype(hooks_eventdata)>()),
     clustering(move(clustering_)),
     candidatebuilder(move(candidatebuilder_)),
-    updateablemanager(std_ext::make_unique<UpdateableManager>(ExpConfig::Setup::Get().GetUpdateables()))
+    updateablemanager(std_ext::make_unique<UpdateableManager>(ExpConfig::Setup::Get().GetUpdateables())),
+    stages_readhits(getHookStages(hooks_readhits)),
+    stages_clusterhits(getHookStages(hooks_clusterhits)),
+    stages_clusters(getHookStages(hooks_clusters)),
+    stages_eventdata(getHookStages(hooks_eventdata)),
+    stage_reconstruct(Profiler::GetStage("Reconstruct")),
+    stage_updateables(Profiler::GetStage("Reconstruct/Updateables")),
+    stage_buildhits(Profiler::GetStage("Reconstruct/BuildHits")),
+    stage_clustering(Profiler::GetStage("Reconstruct/Clustering")),
+    stage_candidatebuilder(Profiler::GetStage("Reconstruct/CandidateBuilder"))
 {
 }
 
@@ -86,8 +113,13 @@ void Reconstruct::DoReconstruct(TEventData& reconstructed) const
     if(reconstructed.DetectorReadHits.empty())
         return;
 
+    Profiler::Scope p_total(stage_reconstruct);
+
     // update the updateables :)
-    updateablemanager->UpdateParameters(reconstructed.ID);
+    {
+        Profiler::Scope p(stage_updateables);
+        updateablemanager->UpdateParameters(reconstructed.ID);
+    }
 
     // apply the hooks for detector read hits (mostly calibrations),
     // note that this also changes the hits itself
@@ -100,25 +132,37 @@ void Reconstruct::DoReconstruct(TEventData& reconstructed) const
     // do the hit matching, which builds the TClusterHit's
     // put into the AdaptorTClusterHit to track Energy/Timing information
     // for subsequent clustering
-    sorted_bydetectortype_t<TClusterHit> sorted_clusterhits;
-    BuildHits(sorted_clusterhits, reconstructed.TaggerHits);
+    auto& sorted_clusterhits = reused_clusterhits;
+    sorted_clusterhits.clear();
+    {
+        Profiler::Scope p(stage_buildhits);
+        BuildHits(sorted_clusterhits, reconstructed.TaggerHits);
+    }
 
     // apply hooks which modify clusterhits
+    auto it_stage = stages_clusterhits.begin();
     for(const auto& hook : hooks_clusterhits) {
+        Profiler::Scope p(**it_stage++);
         hook->ApplyTo(sorted_clusterhits);
     }
 
     // then build clusters (at least for calorimeters this is not trivial)
     sorted_clusters_t sorted_clusters;
-    BuildClusters(move(sorted_clusterhits), sorted_clusters);
+    {
+        Profiler::Scope p(stage_clustering);
+        BuildClusters(sorted_clusterhits, sorted_clusters);
+    }
 
     // apply hooks which modify clusters
+    it_stage = stages_clusters.begin();
     for(const auto& hook : hooks_clusters) {
+        Profiler::Scope p(**it_stage++);
         hook->ApplyTo(sorted_clusters);
     }
 
     // do the candidate building (if available)
     if(candidatebuilder) {
+        Profiler::Scope p(stage_candidatebuilder);
         candidatebuilder->Build(move(sorted_clusters),
                                 reconstructed.Candidates, reconstructed.Clusters);
     }
@@ -132,7 +176,9 @@ void Reconstruct::DoReconstruct(TEventData& reconstructed) const
     }
 
     // apply hooks which may modify the whole event
+    it_stage = stages_eventdata.begin();
     for(const auto& hook : hooks_eventdata) {
+        Profiler::Scope p(**it_stage++);
         hook->ApplyTo(reconstructed);
     }
 
@@ -151,7 +197,9 @@ void Reconstruct::ApplyHooksToReadHits(std::vector<TDetectorReadHit>& detectorRe
 
     // apply calibration
     // this may change the given readhits
+    auto it_stage = stages_readhits.begin();
     for(const auto& hook : hooks_readhits) {
+        Profiler::Scope p(**it_stage++);
         hook->ApplyTo(sorted_readhits);
     }
 }
@@ -159,8 +207,6 @@ void Reconstruct::ApplyHooksToReadHits(std::vector<TDetectorReadHit>& detectorRe
 void Reconstruct::BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_clusterhits,
         vector<TTaggerHit>& taggerhits) const
 {
-    auto insert_hint = sorted_clusterhits.cbegin();
-
     for(const auto& it_hit : sorted_readhits) {
         const Detector_t::Type_t detectortype = it_hit.first;
         const auto& readhits = it_hit.second;
@@ -177,7 +223,7 @@ void Reconstruct::BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_cluster
             continue;
         }
 
-        map<unsigned, TClusterHit> hits;
+        used_channels.clear();
 
         for(const TDetectorReadHit& readhit : readhits) {
             if(!includeIgnoredElements && detector.Detector->IsIgnored(readhit.Channel))
@@ -187,8 +233,14 @@ void Reconstruct::BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_cluster
             if(readhit.Values.empty())
                 continue;
 
+            if(readhit.Channel >= clusterhit_slots.size())
+                clusterhit_slots.resize(readhit.Channel+1);
+
+            // slots in use have at least one datum
+            auto& clusterhit = clusterhit_slots[readhit.Channel];
+            if(clusterhit.Data.empty())
+                used_channels.push_back(readhit.Channel);
 
-            auto& clusterhit = hits[readhit.Channel];
             // copy over all readhit info to clusterhit
             // For example, CB_TimeWalk needs all timings here!
             for(auto& v : readhit.Values)
@@ -203,9 +255,17 @@ void Reconstruct::BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_cluster
                 clusterhit.Time = readhit.Values.front().Calibrated;
         }
 
-        TClusterHitList clusterhits;
-        for(auto& it_hit : hits) {
-            auto& hit = it_hit.second;
+        // The trigger or tagger detectors don't fill anything
+        // so skip it
+        if(used_channels.empty())
+            continue;
+
+        // keep the hits ordered by channel
+        sort(used_channels.begin(), used_channels.end());
+
+        TClusterHitList& clusterhits = sorted_clusterhits[detectortype];
+        for(auto channel : used_channels) {
+            auto& hit = clusterhit_slots[channel];
 
             // check for weird energies
             if(hit.IsSane() && hit.Energy<0) {
@@ -216,20 +276,21 @@ void Reconstruct::BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_cluster
                         << Detector_t::ToString(detectortype) << " Ch=" << hit.Channel;
                 hit.Energy = std_ext::NaN;
             }
-            clusterhits.emplace_back(move(it_hit.second));
-        }
-
-
-        // The trigger or tagger detectors don't fill anything
-        // so skip it
-        if(clusterhits.empty())
-            continue;
+            clusterhits.emplace_back(move(hit));
 
-        // insert the clusterhits
-        insert_hint =
-                sorted_clusterhits.insert(insert_hint,
-                                          make_pair(detectortype, move(clusterhits)));
+            // make the slot unused again
+            hit.Data.clear();
+            hit.Energy = std_ext::NaN;
+            hit.Time = std_ext::NaN;
+        }
     }
+
+    // order the tagger hits by time, so that window queries can bisect them
+    // (see PromptRandom::Switch::Select), hits without time go last
+    stable_sort(taggerhits.begin(), taggerhits.end(),
+                [] (const TTaggerHit& a, const TTaggerHit& b) {
+        return a.Time < b.Time || (!std::isnan(a.Time) && std::isnan(b.Time));
+    });
 }
 
 void Reconstruct::HandleTagger(const shared_ptr<TaggerDetector_t>& taggerdetector,
@@ -239,11 +300,7 @@ void Reconstruct::HandleTagger(const shared_ptr<TaggerDetector_t>& taggerdetecto
 {
 
     // gather electron hits by channel
-    struct taggerhit_t {
-        std::vector<TDetectorReadHit::Value_t> Timings;
-        std::vector<TDetectorReadHit::Value_t> Energies;
-    };
-    map<unsigned, taggerhit_t > hits;
+    used_channels.clear();
 
     for(const TDetectorReadHit& readhit : readhits) {
         if(!includeIgnoredElements && taggerdetector->IsIgnored(readhit.Channel))
@@ -253,7 +310,15 @@ void Reconstruct::HandleTagger(const shared_ptr<TaggerDetector_t>& taggerdetecto
         if(readhit.Values.empty())
             continue;
 
-        auto& item = hits[readhit.Channel];
+        if(readhit.Channel >= taggerhit_slots.size())
+            taggerhit_slots.resize(readhit.Channel+1);
+
+        auto& item = taggerhit_slots[readhit.Channel];
+        if(!item.Used) {
+            item.Used = true;
+            used_channels.push_back(readhit.Channel);
+        }
+
         if(readhit.ChannelType == Channel_t::Type_t::Timing) {
             std_ext::concatenate(item.Timings, readhit.Values);
         }
@@ -262,9 +327,10 @@ void Reconstruct::HandleTagger(const shared_ptr<TaggerDetector_t>& taggerdetecto
         }
     }
 
-    for(const auto& hit : hits) {
-        const auto channel = hit.first;
-        const auto& item = hit.second;
+    sort(used_channels.begin(), used_channels.end());
+
+    for(const auto channel : used_channels) {
+        auto& item = taggerhit_slots[channel];
         // create a taggerhit from each timing for now
         /// \todo handle double hits here?
         /// \todo handle energies here better? (actually test with appropiate QDC run)
@@ -276,6 +342,11 @@ void Reconstruct::HandleTagger(const shared_ptr<TaggerDetector_t>& taggerdetecto
                                     qdc_energy
                                     );
         }
+
+        // keeps the capacity for the next event
+        item.Used = false;
+        item.Timings.clear();
+        item.Energies.clear();
     }
 }
 
@@ -283,8 +354,6 @@ void Reconstruct::BuildClusters(
         const sorted_clusterhits_t& sorted_clusterhits,
         sorted_clusters_t& sorted_clusters) const
 {
-    auto insert_hint = sorted_clusters.begin();
-
     for(const auto& it_clusterhits : sorted_clusterhits) {
         const Detector_t::Type_t detectortype = it_clusterhits.first;
         const TClusterHitList& clusterhits = it_clusterhits.second;
@@ -327,11 +396,8 @@ void Reconstruct::BuildClusters(
         }
 
         // insert the clusters (if any)
-        if(!clusters.empty()) {
-            insert_hint =
-                    sorted_clusters.insert(insert_hint,
-                                           make_pair(detectortype, move(clusters)));
-        }
+        if(!clusters.empty())
+            sorted_clusters.insert(make_pair(detectortype, move(clusters)));
     }
 }
 
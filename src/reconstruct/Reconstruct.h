@@ -5,6 +5,11 @@
 
 #include "Reconstruct_traits.h"
 
+#include "tree/TCluster.h"
+#include "tree/TDetectorReadHit.h"
+
+#include "base/Profiler.h"
+
 namespace ant {
 
 struct TTaggerHit;
@@ -46,7 +51,7 @@ protected:
     void ApplyHooksToReadHits(std::vector<TDetectorReadHit>& detectorReadHits) const;
 
     template<typename T>
-    using sorted_bydetectortype_t = std::map<Detector_t::Type_t, std::vector< T > >;
+    using sorted_bydetectortype_t = bydetectortype_t< std::vector< T > >;
 
     void BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_clusterhits,
             std::vector<TTaggerHit>& taggerhits
@@ -58,6 +63,20 @@ protected:
 
     using sorted_clusterhits_t = ReconstructHook::Base::clusterhits_t;
     using sorted_clusters_t = ReconstructHook::Base::clusters_t;
+
+    // kept over events to avoid re-allocations, see BuildHits/HandleTagger
+    mutable sorted_clusterhits_t reused_clusterhits;
+
+    // hits are gathered in dense slots indexed by channel,
+    // the used channels are remembered to visit them in ascending order
+    struct taggerhit_t {
+        bool Used = false;
+        std::vector<TDetectorReadHit::Value_t> Timings;
+        std::vector<TDetectorReadHit::Value_t> Energies;
+    };
+    mutable std::vector<TClusterHit> clusterhit_slots;
+    mutable std::vector<taggerhit_t> taggerhit_slots;
+    mutable std::vector<unsigned>    used_channels;
     void BuildClusters(const sorted_clusterhits_t& sorted_clusterhits,
                        sorted_clusters_t& sorted_clusters) const;
 
@@ -101,6 +120,18 @@ protected:
     const clustering_t       clustering;
     const candidatebuilder_t candidatebuilder;
     const std::unique_ptr<reconstruct::UpdateableManager> updateablemanager;
+
+    // profiler stages, the hook stages are in the same order as the hooks
+    using hook_stages_t = std::vector<Profiler::Stage_t*>;
+    const hook_stages_t stages_readhits;
+    const hook_stages_t stages_clusterhits;
+    const hook_stages_t stages_clusters;
+    const hook_stages_t stages_eventdata;
+    Profiler::Stage_t& stage_reconstruct;
+    Profiler::Stage_t& stage_updateables;
+    Profiler::Stage_t& stage_buildhits;
+    Profiler::Stage_t& stage_clustering;
+    Profiler::Stage_t& stage_candidatebuilder;
 };
 
 }
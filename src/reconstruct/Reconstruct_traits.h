@@ -2,6 +2,7 @@
 
 #include "base/Detector_t.h"
 #include "base/std_ext/mapped_vectors.h"
+#include "base/std_ext/array_map.h"
 #include "base/std_ext/shared_ptr_container.h"
 
 #include <memory>
@@ -24,6 +25,13 @@ using TClusterList = std_ext::shared_ptr_container<TCluster>;
 struct TCandidate;
 using TCandidateList = std_ext::shared_ptr_container<TCandidate>;
 
+/**
+ * @brief bydetectortype_t maps each detector type to T without any allocation,
+ * sized like Detector_t::Any_t, which can hold 32 types at most
+ */
+template<typename T>
+using bydetectortype_t = std_ext::array_map<Detector_t::Type_t, T, 32>;
+
 struct Reconstruct_traits {
     /**
      * @brief DoReconstruct shall convert the given TDetectorRead to TEvent
@@ -52,8 +60,8 @@ struct ReconstructHook {
      */
     struct Base {
         using readhits_t = std_ext::mapped_vectors< Detector_t::Type_t, std::reference_wrapper<TDetectorReadHit> >;
-        using clusterhits_t = std::map< Detector_t::Type_t, TClusterHitList >;
-        using clusters_t = std::map< Detector_t::Type_t, TClusterList >;
+        using clusterhits_t = bydetectortype_t< TClusterHitList >;
+        using clusters_t = bydetectortype_t< TClusterList >;
         virtual ~Base() = default;
     };
 
@@ -117,7 +125,7 @@ struct Clustering_traits {
 };
 
 struct CandidateBuilder_traits {
-    using sorted_clusters_t = std::map<Detector_t::Type_t, TClusterList >;
+    using sorted_clusters_t = bydetectortype_t< TClusterList >;
     using candidates_t = TCandidateList;
     using clusters_t = TClusterList;
 
@@ -6,7 +6,15 @@
 #include "TH3.h"
 #include "TCut.h"
 #include "TDirectory.h"
+#include "TTreeFormula.h"
+#include "TTreeFormulaManager.h"
+#include "TROOT.h"
 #include "base/std_ext/string.h"
+#include "base/std_ext/memory.h"
+#include "base/Logger.h"
+
+#include <algorithm>
+#include <stdexcept>
 
 using namespace std;
 using namespace ant::std_ext;
@@ -54,3 +62,161 @@ TH3* Draw(TTree* tree, const string& formula, const TCut& cut, const ant::BinSet
     gDirectory->GetObject(hname, h);
     return h;
 }
+
+struct ant::TreeDrawer::item_t {
+    TH1* Hist;
+    unsigned NDim;
+    string Formula;
+    string Cut;
+    vector<unique_ptr<TTreeFormula>> Vars; // in axis order x, y, z
+    unique_ptr<TTreeFormula> Select;
+    TTreeFormulaManager* Manager = nullptr; // owned by the formulas
+};
+
+ant::TreeDrawer::TreeDrawer(TTree* tree_) : tree(tree_) {}
+
+ant::TreeDrawer::~TreeDrawer() {}
+
+void ant::TreeDrawer::AddItem(TH1* h, const string& formula, const TCut& cut, unsigned ndim)
+{
+    items.emplace_back(new item_t);
+    auto& item = items.back();
+    item->Hist = h;
+    item->NDim = ndim;
+    item->Formula = formula;
+    item->Cut = cut.GetTitle();
+    if(SplitFormula(formula).size() != ndim)
+        throw runtime_error(formatter() << "Formula '" << formula << "' does not have " << ndim << " dimensions");
+}
+
+TH1* ant::TreeDrawer::Add(const string& formula, const TCut& cut, const string& xtitle, const string& ytitle,
+                          const BinSettings& xbins, const string& name)
+{
+    TH1* h = new TH1D(name.c_str(),"",int(xbins.Bins()), xbins.Start(), xbins.Stop());
+    h->SetXTitle(xtitle.c_str());
+    h->SetYTitle(ytitle.c_str());
+    AddItem(h, formula, cut, 1);
+    return h;
+}
+
+TH2* ant::TreeDrawer::Add(const string& formula, const TCut& cut, const string& xtitle, const string& ytitle,
+                          const BinSettings& xbins, const BinSettings& ybins, const string& name)
+{
+    TH2* h = new TH2D(name.c_str(),"",int(xbins.Bins()), xbins.Start(), xbins.Stop(), int(ybins.Bins()), ybins.Start(), ybins.Stop());
+    h->SetXTitle(xtitle.c_str());
+    h->SetYTitle(ytitle.c_str());
+    AddItem(h, formula, cut, 2);
+    return h;
+}
+
+TH3* ant::TreeDrawer::Add(const string& formula, const TCut& cut,
+                          const BinSettings& xbins, const BinSettings& ybins, const BinSettings& zbins, const string& name)
+{
+    TH3* h = new TH3D(name.c_str(),"",
+                      int(xbins.Bins()), xbins.Start(), xbins.Stop(),
+                      int(ybins.Bins()), ybins.Start(), ybins.Stop(),
+                      int(zbins.Bins()), zbins.Start(), zbins.Stop());
+    AddItem(h, formula, cut, 3);
+    return h;
+}
+
+vector<string> ant::TreeDrawer::SplitFormula(const string& formula)
+{
+    vector<string> parts(1);
+    for(size_t i=0;i<formula.size();i++) {
+        const char c = formula[i];
+        const bool scope = (i>0 && formula[i-1] == ':') || (i+1<formula.size() && formula[i+1] == ':');
+        if(c == ':' && !scope)
+            parts.emplace_back();
+        else
+            parts.back() += c;
+    }
+    // TTree::Draw convention: last part is x axis
+    reverse(parts.begin(), parts.end());
+    return parts;
+}
+
+long long ant::TreeDrawer::Run(unsigned threads)
+{
+    if(tree->LoadTree(0) < 0)
+        return 0;
+
+#ifdef R__USE_IMT
+    if(threads>0) {
+        if(!ROOT::IsImplicitMTEnabled())
+            ROOT::EnableImplicitMT(threads);
+        tree->SetImplicitMT(true);
+    }
+#else
+    LOG_IF(threads>0, WARNING) << "ROOT was built without implicit multi-threading support";
+#endif
+
+    // compile all formulas once, formulas of one histogram share a manager
+    // to agree on the number of array instances per entry
+    unsigned n = 0;
+    for(auto& item : items) {
+        item->Manager = new TTreeFormulaManager();
+        const auto parts = SplitFormula(item->Formula);
+        for(const auto& part : parts) {
+            item->Vars.emplace_back(new TTreeFormula(Form("TreeDrawer_%u", n++), part.c_str(), tree));
+            if(item->Vars.back()->GetNdim() == 0)
+                throw runtime_error(formatter() << "Cannot compile '" << part << "' of " << item->Hist->GetName());
+            item->Vars.back()->SetQuickLoad(true);
+            item->Manager->Add(item->Vars.back().get());
+        }
+        if(!item->Cut.empty()) {
+            item->Select = std_ext::make_unique<TTreeFormula>(Form("TreeDrawer_%u", n++), item->Cut.c_str(), tree);
+            if(item->Select->GetNdim() == 0)
+                throw runtime_error(formatter() << "Cannot compile cut '" << item->Cut << "' of " << item->Hist->GetName());
+            item->Select->SetQuickLoad(true);
+            item->Manager->Add(item->Select.get());
+        }
+        item->Manager->Sync();
+    }
+
+    int treenumber = -1;
+    long long entry = 0;
+    for(;entry<tree->GetEntriesFast();entry++) {
+        if(tree->LoadTree(entry) < 0)
+            break;
+        // chains need to update the leaves when switching to the next file
+        if(tree->GetTreeNumber() != treenumber) {
+            treenumber = tree->GetTreeNumber();
+            for(auto& item : items)
+                item->Manager->UpdateFormulaLeaves();
+        }
+
+        for(auto& item : items) {
+            const int ndata = item->Manager->GetNdata(true);
+            for(int i=0;i<ndata;i++) {
+                // always evaluate all formulas, as instance 0 loads the branches
+                const double w = item->Select ? item->Select->EvalInstance(i) : 1.0;
+                double v[3] = {};
+                for(unsigned d=0;d<item->NDim;d++)
+                    v[d] = item->Vars[d]->EvalInstance(i);
+                if(w == 0)
+                    continue;
+                switch(item->NDim) {
+                case 1:
+                    item->Hist->Fill(v[0], w);
+                    break;
+                case 2:
+                    static_cast<TH2*>(item->Hist)->Fill(v[0], v[1], w);
+                    break;
+                case 3:
+                    static_cast<TH3*>(item->Hist)->Fill(v[0], v[1], v[2], w);
+                    break;
+                }
+            }
+        }
+    }
+
+    // formulas are bound to the current tree, compile again for the next run
+    for(auto& item : items) {
+        item->Select = nullptr;
+        item->Vars.clear();
+        item->Manager = nullptr;
+    }
+
+    return entry;
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <memory>
 #include "analysis/plot/HistogramFactory.h"
 
 class TTree;
@@ -15,3 +17,51 @@ TH1* Draw(TTree* tree, const std::string& formula, const TCut& cut, const std::s
 TH2* Draw(TTree* tree, const std::string& formula, const TCut& cut, const std::string& xtitle, const std::string& ytitle, const ant::BinSettings& xbins, const ant::BinSettings& ybins, const std::string& name);
 
 TH3* Draw(TTree* tree, const std::string& formula, const TCut& cut, const ant::BinSettings& xbins, const ant::BinSettings& ybins, const ant::BinSettings& zbins);
+
+namespace ant {
+
+/**
+ * @brief The TreeDrawer class fills many histograms from one tree in a single pass
+ *
+ * Register the histograms with Add, using the same formula syntax as TTree::Draw
+ * ("y:x" for 2D, cut used as weight), then call Run once. Each formula is compiled only
+ * once and the tree is read only once for all histograms, instead of once per TTree::Draw.
+ */
+class TreeDrawer {
+public:
+    explicit TreeDrawer(TTree* tree);
+    ~TreeDrawer();
+
+    TH1* Add(const std::string& formula, const TCut& cut, const std::string& xtitle, const std::string& ytitle,
+             const BinSettings& xbins, const std::string& name);
+    TH2* Add(const std::string& formula, const TCut& cut, const std::string& xtitle, const std::string& ytitle,
+             const BinSettings& xbins, const BinSettings& ybins, const std::string& name);
+    TH3* Add(const std::string& formula, const TCut& cut,
+             const BinSettings& xbins, const BinSettings& ybins, const BinSettings& zbins, const std::string& name);
+
+    /**
+     * @brief Run fills all added histograms
+     * @param threads if non-zero, decompress the baskets in that many threads
+     * @return number of entries read
+     */
+    long long Run(unsigned threads = 0);
+
+    /**
+     * @brief SplitFormula splits "z:y:x" into its parts, keeping "::" of scopes intact
+     * @return parts in axis order x, y, z
+     */
+    static std::vector<std::string> SplitFormula(const std::string& formula);
+
+    TreeDrawer(const TreeDrawer&) = delete;
+    TreeDrawer& operator=(const TreeDrawer&) = delete;
+
+protected:
+    TTree* const tree;
+
+    struct item_t;
+    std::vector<std::unique_ptr<item_t>> items;
+
+    void AddItem(TH1* h, const std::string& formula, const TCut& cut, unsigned ndim);
+};
+
+}
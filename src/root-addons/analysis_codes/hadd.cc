@@ -3,6 +3,7 @@
 #include "hstack.h"
 #include "tree/TAntHeader.h"
 #include "base/ProgressCounter.h"
+#include "base/std_ext/memory.h"
 
 #include "TDirectory.h"
 #include "TFile.h"
@@ -10,9 +11,24 @@
 #include "TKey.h"
 #include "TClass.h"
 #include "TH1.h"
+#include "TH1D.h"
+#include "TH1F.h"
+#include "TH2D.h"
+#include "TH2F.h"
+#include "TH3D.h"
+#include "TH3F.h"
 #include "TFileMergeInfo.h"
 
 #include <algorithm>
+#include <unordered_map>
+#include <deque>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdio>
+
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace std;
 using namespace ant;
@@ -25,19 +41,155 @@ struct pair_t {
     T Item;
 };
 
-template<typename C, typename... Args>
-void add_by_name(C& c, const string& name, Args&&... args) {
-    using T = typename C::value_type;
-    auto it = std::find_if(c.begin(), c.end(), [name] (const T& item) {
-        return item.Name == name;
-    });
-    if(it == c.end()) {
-        c.emplace_back(name);
-        c.back().Item.emplace_back(std::forward<Args>(args)...);
+namespace {
+
+// maps the object names to their keys in the sources, in order of first appearance,
+// the objects themselves are only read when they are merged
+struct manifest_t {
+    vector<pair_t<vector<TKey*>>> Entries;
+
+    void Add(const string& name, TKey* key) {
+        auto it = index.find(name);
+        if(it == index.end()) {
+            index.emplace(name, Entries.size());
+            Entries.emplace_back(name);
+            Entries.back().Item.push_back(key);
+        }
+        else {
+            Entries[it->second].Item.push_back(key);
+        }
+    }
+
+private:
+    unordered_map<string, size_t> index;
+};
+
+template<typename T>
+unique_ptr<T> read(TKey* key) {
+    return unique_ptr<T>(dynamic_cast<T*>(key->ReadObj()));
+}
+
+template<typename T>
+hadd::unique_ptrs_t<T> read_all(const vector<TKey*>& keys) {
+    hadd::unique_ptrs_t<T> items;
+    for(auto key : keys)
+        items.emplace_back(read<T>(key));
+    return items;
+}
+
+// histograms storing their bins plainly in TArrayD or TArrayF
+bool is_plain(const TH1& h) {
+    const auto cl = h.IsA();
+    return cl == TH1D::Class() || cl == TH2D::Class() || cl == TH3D::Class() ||
+           cl == TH1F::Class() || cl == TH2F::Class() || cl == TH3F::Class();
+}
+
+bool same_axis(const TAxis& a, const TAxis& b) {
+    if(a.GetNbins() != b.GetNbins() || a.GetXmin() != b.GetXmin() || a.GetXmax() != b.GetXmax())
+        return false;
+    if(a.GetLabels() || b.GetLabels())
+        return false;
+    const auto& edges_a = *a.GetXbins();
+    const auto& edges_b = *b.GetXbins();
+    return edges_a.GetSize() == edges_b.GetSize() &&
+           std::equal(edges_a.GetArray(), edges_a.GetArray()+edges_a.GetSize(), edges_b.GetArray());
+}
+
+// identically binned histograms can be summed bin by bin,
+// anything special (labels, averages, profiles, ...) is left to TH1::Add
+bool can_add_bins(const TH1& a, const TH1& b) {
+    return a.IsA() == b.IsA() && is_plain(a) &&
+           !a.TestBit(TH1::kIsAverage) && !b.TestBit(TH1::kIsAverage) &&
+           a.GetBufferLength() == 0 && b.GetBufferLength() == 0 &&
+           (a.GetSumw2N() == 0) == (b.GetSumw2N() == 0) &&
+           same_axis(*a.GetXaxis(), *b.GetXaxis()) &&
+           same_axis(*a.GetYaxis(), *b.GetYaxis()) &&
+           same_axis(*a.GetZaxis(), *b.GetZaxis());
+}
+
+template<typename Array>
+void add_array(Array& a, const Array& b) {
+    const auto n = a.GetSize();
+    auto pa = a.GetArray();
+    const auto pb = b.GetArray();
+    for(Int_t i=0;i<n;i++)
+        pa[i] += pb[i];
+}
+
+// does what TH1::Add(b) does for such histograms
+void add_bins(TH1& a, const TH1& b) {
+    // get stats before touching the bins, they might be computed from them
+    double stats_a[TH1::kNstat] = {};
+    double stats_b[TH1::kNstat] = {};
+    a.GetStats(stats_a);
+    b.GetStats(stats_b);
+
+    if(auto bins_a = dynamic_cast<TArrayD*>(addressof(a)))
+        add_array(*bins_a, dynamic_cast<const TArrayD&>(b));
+    else
+        add_array(dynamic_cast<TArrayF&>(a), dynamic_cast<const TArrayF&>(b));
+    if(a.GetSumw2N() > 0)
+        add_array(*a.GetSumw2(), *b.GetSumw2());
+
+    for(int i=0;i<TH1::kNstat;i++)
+        stats_a[i] += stats_b[i];
+    const auto entries = a.GetEntries() + b.GetEntries();
+    a.PutStats(stats_a);
+    a.SetEntries(entries);
+}
+
+void merge_hists(TDirectory& target, const vector<TKey*>& keys)
+{
+    // stream through the hists, only the ones which cannot be added bin-wise are kept
+    hadd::unique_ptrs_t<TH1> items;
+    items.emplace_back(read<TH1>(keys.front()));
+    auto& first = items.front();
+    for(auto it = next(keys.begin()); it != keys.end(); ++it) {
+        auto h = read<TH1>(*it);
+        if(can_add_bins(*first, *h))
+            add_bins(*first, *h);
+        else
+            items.emplace_back(move(h));
+    }
+
+    // check if at least one hist has labels,
+    // the others could be never filled (so ROOT treats them as normal hists)
+    const auto hasLabels = [] (const unique_ptr<TH1>& h) {
+        return h->GetXaxis()->GetLabels() != nullptr;
+    };
+    const auto it_h_withLabels = std::find_if(items.begin(), items.end(), hasLabels);
+
+    if(it_h_withLabels != items.end()) {
+
+        // again, scan the histograms for empty hists without labels
+        // IMHO, this is a bug in ROOT that empty hists cannot be merged with labeled hists
+        auto& h_withLabels = *it_h_withLabels;
+        for(auto& h : items) {
+            if(hasLabels(h))
+                continue;
+            for(int bin=0;bin<h->GetNbinsX()+1;bin++)
+                if(h->GetBinContent(bin) != 0)
+                    throw std::runtime_error("Found non-empty unlabeled hist "
+                                             + string(h->GetDirectory()->GetPath()));
+            // prepare the axis labels of the empty hist, labeled hist should have at least
+            // one bin filled
+            h->Fill(h_withLabels->GetXaxis()->GetBinLabel(1), 0.0);
+        }
+
+        TList c;
+        for(auto it = next(items.begin()); it != items.end(); ++it) {
+            c.Add(it->get());
+        }
+        first->Merge(addressof(c));
     }
     else {
-        it->Item.emplace_back(std::forward<Args>(args)...);
+        for(auto it = next(items.begin()); it != items.end(); ++it) {
+            first->Add(it->get());
+        }
     }
+    target.WriteTObject(first.get());
+}
+
 }
 
 void hadd::MergeRecursive(TDirectory& target, const hadd::sources_t& sources, unsigned& nPaths)
@@ -46,11 +198,10 @@ void hadd::MergeRecursive(TDirectory& target, const hadd::sources_t& sources, un
         nPaths++;
         ProgressCounter::Tick();
 
-        vector<pair_t<sources_t>> dirs;
-
-        vector<pair_t<unique_ptrs_t<TH1>>>    hists;
-        vector<pair_t<unique_ptrs_t<hstack>>> stacks;
-        vector<pair_t<unique_ptrs_t<TAntHeader>>> headers;
+        manifest_t dirs;
+        manifest_t hists;
+        manifest_t stacks;
+        manifest_t headers;
 
         for(auto& source : sources) {
             TList* keys = source->GetListOfKeys();
@@ -69,81 +220,37 @@ void hadd::MergeRecursive(TDirectory& target, const hadd::sources_t& sources, un
                 prev_keyname = keyname;
 
                 auto cl = TClass::GetClass(key->GetClassName());
+                if(!cl)
+                    continue;
 
-                if(cl->InheritsFrom(TDirectory::Class())) {
-                    auto dir = dynamic_cast<TDirectory*>(key->ReadObj());
-                    add_by_name(dirs, keyname, dir);
-                }
-                else if(cl->InheritsFrom(TH1::Class())) {
-                    auto obj = dynamic_cast<TH1*>(key->ReadObj());
-                    add_by_name(hists, keyname, obj);
-                }
-                else if(cl->InheritsFrom(hstack::Class())) {
-                    auto obj = dynamic_cast<hstack*>(key->ReadObj());
-                    add_by_name(stacks, keyname, obj);
-                }
-                else if(cl->InheritsFrom(TAntHeader::Class())) {
-                    auto obj = dynamic_cast<TAntHeader*>(key->ReadObj());
-                    add_by_name(headers, keyname, obj);
-                }
+                if(cl->InheritsFrom(TDirectory::Class()))
+                    dirs.Add(keyname, key);
+                else if(cl->InheritsFrom(TH1::Class()))
+                    hists.Add(keyname, key);
+                else if(cl->InheritsFrom(hstack::Class()))
+                    stacks.Add(keyname, key);
+                else if(cl->InheritsFrom(TAntHeader::Class()))
+                    headers.Add(keyname, key);
             }
         }
 
-
-
-        for(const auto& it_dirs : dirs) {
+        for(const auto& it_dirs : dirs.Entries) {
+            sources_t subdirs;
+            for(auto key : it_dirs.Item)
+                subdirs.emplace_back(read<TDirectory>(key));
             auto newdir = target.mkdir(it_dirs.Name.c_str());
-            MergeRecursive(*newdir, it_dirs.Item, nPaths);
+            MergeRecursive(*newdir, subdirs, nPaths);
         }
 
         target.cd();
         TFileMergeInfo info(addressof(target)); // for calling Merge
 
-        for(const auto& it_hists : hists) {
-            auto& items = it_hists.Item;
-
-            // check if at least one hist has labels,
-            // the others could be never filled (so ROOT treats them as normal hists)
-            const auto hasLabels = [] (const unique_ptr<TH1>& h) {
-                return h->GetXaxis()->GetLabels() != nullptr;
-            };
-            const auto it_h_withLabels = std::find_if(items.begin(), items.end(), hasLabels);
-
-            auto& first = items.front();
-            if(it_h_withLabels != items.end()) {
-
-                // again, scan the histograms for empty hists without labels
-                // IMHO, this is a bug in ROOT that empty hists cannot be merged with labeled hists
-                auto& h_withLabels = *it_h_withLabels;
-                for(auto& h : items) {
-                    if(hasLabels(h))
-                        continue;
-                    for(int bin=0;bin<h->GetNbinsX()+1;bin++)
-                        if(h->GetBinContent(bin) != 0)
-                            throw std::runtime_error("Found non-empty unlabeled hist "
-                                                     + string(h->GetDirectory()->GetPath()));
-                    // prepare the axis labels of the empty hist, labeled hist should have at least
-                    // one bin filled
-                    h->Fill(h_withLabels->GetXaxis()->GetBinLabel(1), 0.0);
-                }
-
-                auto& first = items.front();
-                TList c;
-                for(auto it = next(items.begin()); it != items.end(); ++it) {
-                    c.Add(it->get());
-                }
-                first->Merge(addressof(c));
-            }
-            else {
-                for(auto it = next(items.begin()); it != items.end(); ++it) {
-                    first->Add(it->get());
-                }
-            }
-            target.WriteTObject(first.get());
+        for(const auto& it_hists : hists.Entries) {
+            merge_hists(target, it_hists.Item);
         }
 
-        for(const auto& it : stacks) {
-            auto& items = it.Item;
+        for(const auto& it : stacks.Entries) {
+            auto items = read_all<hstack>(it.Item);
             auto& first = items.front();
             TList c;
             for(auto it = next(items.begin()); it != items.end(); ++it) {
@@ -153,8 +260,8 @@ void hadd::MergeRecursive(TDirectory& target, const hadd::sources_t& sources, un
             target.WriteTObject(first.get());
         }
 
-        for(const auto& it : headers) {
-            auto& items = it.Item;
+        for(const auto& it : headers.Entries) {
+            auto items = read_all<TAntHeader>(it.Item);
             auto& first = items.front();
             TList c;
             for(auto it = next(items.begin()); it != items.end(); ++it) {
@@ -165,3 +272,141 @@ void hadd::MergeRecursive(TDirectory& target, const hadd::sources_t& sources, un
         }
 
 }
+
+namespace {
+
+// merges the files into a new file, runs in the worker processes
+bool merge_group(const string& outputfile, const vector<string>& filenames) {
+    hadd::sources_t sources;
+    for(const auto& filename : filenames) {
+        auto file = std_ext::make_unique<TFile>(filename.c_str(), "READ");
+        if(file->IsZombie())
+            return false;
+        sources.emplace_back(move(file));
+    }
+    TFile output(outputfile.c_str(), "RECREATE");
+    if(output.IsZombie())
+        return false;
+    unsigned nPaths = 0;
+    hadd::MergeRecursive(output, sources, nPaths);
+    output.Write();
+    output.Close();
+    return true;
+}
+
+// intermediate file next to the final output, so it ends up on the same filesystem,
+// removed when destroyed
+struct temporary_t {
+    string filename;
+
+    explicit temporary_t(const string& directory) {
+        string name = directory + "/.Ant-hadd.XXXXXX";
+        const int fd = mkstemp(&name[0]);
+        if(fd < 0)
+            throw runtime_error("Cannot create temporary file in " + directory);
+        // only the name is needed, ROOT opens the file itself
+        close(fd);
+        filename = name;
+    }
+    ~temporary_t() {
+        std::remove(filename.c_str());
+    }
+
+    temporary_t(const temporary_t&) = delete;
+    temporary_t& operator=(const temporary_t&) = delete;
+};
+
+string directory_of(const TDirectory& target) {
+    const auto file = target.GetFile();
+    if(!file)
+        return ".";
+    const string filename = file->GetName();
+    const auto slash = filename.rfind('/');
+    if(slash == string::npos)
+        return ".";
+    return slash == 0 ? "/" : filename.substr(0, slash);
+}
+
+bool wait_for(pid_t pid) {
+    int status = 0;
+    while(waitpid(pid, addressof(status), 0) < 0 && errno == EINTR);
+    return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+}
+
+}
+
+void hadd::MergeFiles(TDirectory& target, const vector<string>& filenames, unsigned& nPaths,
+                      unsigned maxOpenFiles, unsigned nWorkers)
+{
+    if(maxOpenFiles < 2)
+        throw runtime_error("Merging needs at least two open files at once");
+
+    // the merged groups of one level are the inputs of the next,
+    // each level removes its inputs when done
+    vector<string> inputs = filenames;
+    vector<unique_ptr<temporary_t>> temporaries;
+    const auto tmpdir = directory_of(target);
+
+    while(inputs.size() > maxOpenFiles) {
+        // equally sized groups of contiguous files
+        const auto nGroups = (inputs.size() + maxOpenFiles - 1)/maxOpenFiles;
+        vector<vector<string>> groups(nGroups);
+        for(size_t i=0;i<inputs.size();i++)
+            groups[i*nGroups/inputs.size()].push_back(inputs[i]);
+
+        vector<unique_ptr<temporary_t>> outputs;
+        for(size_t g=0;g<nGroups;g++)
+            outputs.emplace_back(std_ext::make_unique<temporary_t>(tmpdir));
+
+        bool success = true;
+        if(nWorkers < 2) {
+            for(size_t g=0;g<nGroups && success;g++)
+                success = merge_group(outputs[g]->filename, groups[g]);
+        }
+        else {
+            // fork at most nWorkers processes at a time,
+            // they only write their own file and never return
+            deque<pid_t> running;
+            for(size_t g=0;g<nGroups;g++) {
+                if(running.size() >= nWorkers) {
+                    success &= wait_for(running.front());
+                    running.pop_front();
+                }
+                const pid_t pid = fork();
+                if(pid < 0) {
+                    success = false;
+                    break;
+                }
+                if(pid == 0) {
+                    ProgressCounter::Interval = 0;
+                    bool ok = false;
+                    try {
+                        ok = merge_group(outputs[g]->filename, groups[g]);
+                    }
+                    catch(...) {}
+                    _exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+                }
+                running.push_back(pid);
+            }
+            for(auto pid : running)
+                success &= wait_for(pid);
+        }
+
+        if(!success)
+            throw runtime_error("Merging group of files into temporary file failed");
+
+        inputs.clear();
+        for(auto& output : outputs)
+            inputs.push_back(output->filename);
+        temporaries = move(outputs);
+    }
+
+    sources_t sources;
+    for(const auto& filename : inputs) {
+        auto file = std_ext::make_unique<TFile>(filename.c_str(), "READ");
+        if(file->IsZombie())
+            throw runtime_error("Cannot open file " + filename);
+        sources.emplace_back(move(file));
+    }
+    MergeRecursive(target, sources, nPaths);
+}
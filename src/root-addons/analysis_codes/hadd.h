@@ -3,6 +3,7 @@
 #include "TDirectory.h"
 #include <memory>
 #include <vector>
+#include <string>
 
 namespace ant {
 
@@ -14,6 +15,17 @@ struct hadd {
 
     static void MergeRecursive(TDirectory& target, const sources_t& sources, unsigned& nPaths);
 
+    /**
+     * @brief MergeFiles merges the files by a tree reduction, opening at most maxOpenFiles at once
+     * @param target where the final merge is written to
+     * @param filenames input files
+     * @param nPaths counts the merged paths of the final merge
+     * @param maxOpenFiles groups of that many files are merged into temporary files until they can be opened at once
+     * @param nWorkers number of processes merging the groups in parallel
+     */
+    static void MergeFiles(TDirectory& target, const std::vector<std::string>& filenames, unsigned& nPaths,
+                           unsigned maxOpenFiles, unsigned nWorkers = 1);
+
 };
 
 }
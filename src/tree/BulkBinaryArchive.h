@@ -0,0 +1,264 @@
+#pragma once
+
+// ignore warnings from library
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnon-virtual-dtor"
+#include "cereal/cereal.hpp"
+#include "cereal/types/vector.hpp"
+#pragma GCC diagnostic pop
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <memory>
+#include <istream>
+#include <ostream>
+
+namespace ant {
+
+/**
+ * @brief The is_bulk_serializable trait marks plain data types
+ *
+ * Mark a type by adding the member "static constexpr bool bulk_serializable = true;".
+ * Its serialize method may only archive arithmetic types, enums and other such types,
+ * then vectors of it are written as one block by the BulkBinary archives.
+ */
+template<typename T, typename = void>
+struct is_bulk_serializable : std::false_type {};
+
+template<typename T>
+struct is_bulk_serializable<T, typename std::enable_if<T::bulk_serializable>::type> : std::true_type {};
+
+namespace bulk_detail {
+
+// visits all fields of T via its serialize method, in the order cereal writes them
+template<typename Op>
+struct fields_t {
+    Op op;
+
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type
+    process(T& t) { op(t); }
+
+    template<typename T>
+    typename std::enable_if<std::is_class<T>::value>::type
+    process(T& t) { t.serialize(*this); }
+
+    template<typename... Args>
+    void operator()(Args&... args) {
+        const int dummy[] = {0, (process(args), 0)...};
+        (void)dummy;
+    }
+};
+
+struct count_op {
+    std::size_t Size = 0;
+    template<typename T>
+    void operator()(T&) { Size += sizeof(T); }
+};
+
+struct save_op {
+    char* Pos;
+    template<typename T>
+    void operator()(const T& t) { std::memcpy(Pos, std::addressof(t), sizeof(T)); Pos += sizeof(T); }
+};
+
+struct load_op {
+    const char* Pos;
+    template<typename T>
+    void operator()(T& t) { std::memcpy(std::addressof(t), Pos, sizeof(T)); Pos += sizeof(T); }
+};
+
+// size of one element as written by the binary archive, without any padding
+template<typename T>
+std::size_t packed_size() {
+    static const std::size_t size = [] () {
+        T t = T();
+        fields_t<count_op> counter{};
+        counter.process(t);
+        return counter.op.Size;
+    }();
+    return size;
+}
+
+} // namespace bulk_detail
+
+/**
+ * @brief The BulkBinaryOutputArchive class writes the same bytes as cereal::BinaryOutputArchive
+ *
+ * Vectors of bulk serializable types are packed into one buffer and written at once
+ * instead of field by field. Shared pointers are tracked in a sorted vector instead of a hash map,
+ * which is faster for the few dozen pointers of an event.
+ */
+class BulkBinaryOutputArchive : public cereal::OutputArchive<BulkBinaryOutputArchive, cereal::AllowEmptyClassElision>
+{
+public:
+    explicit BulkBinaryOutputArchive(std::ostream& stream) :
+        cereal::OutputArchive<BulkBinaryOutputArchive, cereal::AllowEmptyClassElision>(this),
+        itsStream(stream)
+    {}
+
+    void saveBinary(const void* data, std::size_t size)
+    {
+        const auto writtenSize = static_cast<std::size_t>(itsStream.rdbuf()->sputn(reinterpret_cast<const char*>(data), size));
+        if(writtenSize != size)
+            throw cereal::Exception("Failed to write " + std::to_string(size) + " bytes to output stream! Wrote " + std::to_string(writtenSize));
+    }
+
+    template<typename T, typename A>
+    void saveBulk(const std::vector<T, A>& v)
+    {
+        buffer.resize(v.size()*bulk_detail::packed_size<T>());
+        bulk_detail::fields_t<bulk_detail::save_op> saver{{buffer.data()}};
+        for(auto& item : v)
+            saver.process(const_cast<T&>(item));
+        saveBinary(buffer.data(), buffer.size());
+    }
+
+    // hides OutputArchive::registerSharedPointer, same ids are assigned
+    std::uint32_t registerSharedPointer(const void* addr)
+    {
+        if(addr == nullptr)
+            return 0;
+        auto it = std::lower_bound(pointers.begin(), pointers.end(), std::make_pair(addr, std::uint32_t(0)));
+        if(it != pointers.end() && it->first == addr)
+            return it->second;
+        const std::uint32_t id = nextPointerId++;
+        pointers.emplace(it, addr, id);
+        return id | cereal::detail::msb_32bit;
+    }
+
+private:
+    std::ostream& itsStream;
+    std::vector<char> buffer;
+    std::vector<std::pair<const void*, std::uint32_t>> pointers; // sorted by address
+    std::uint32_t nextPointerId = 1;
+};
+
+/**
+ * @brief The BulkBinaryInputArchive class reads what cereal::BinaryOutputArchive wrote
+ *
+ * Vectors of bulk serializable types are read as one block.
+ * Shared pointers are looked up by their index.
+ */
+class BulkBinaryInputArchive : public cereal::InputArchive<BulkBinaryInputArchive, cereal::AllowEmptyClassElision>
+{
+public:
+    explicit BulkBinaryInputArchive(std::istream& stream) :
+        cereal::InputArchive<BulkBinaryInputArchive, cereal::AllowEmptyClassElision>(this),
+        itsStream(stream)
+    {}
+
+    void loadBinary(void* const data, std::size_t size)
+    {
+        const auto readSize = static_cast<std::size_t>(itsStream.rdbuf()->sgetn(reinterpret_cast<char*>(data), size));
+        if(readSize != size)
+            throw cereal::Exception("Failed to read " + std::to_string(size) + " bytes from input stream! Read " + std::to_string(readSize));
+    }
+
+    template<typename T, typename A>
+    void loadBulk(std::vector<T, A>& v)
+    {
+        buffer.resize(v.size()*bulk_detail::packed_size<T>());
+        loadBinary(buffer.data(), buffer.size());
+        bulk_detail::fields_t<bulk_detail::load_op> loader{{buffer.data()}};
+        for(auto& item : v)
+            loader.process(item);
+    }
+
+    // hide InputArchive's shared pointer map, ids are consecutive starting at 1
+    std::shared_ptr<void> getSharedPointer(const std::uint32_t id)
+    {
+        if(id == 0)
+            return nullptr;
+        if(id > pointers.size() || !pointers[id-1])
+            throw cereal::Exception("Error while trying to deserialize a smart pointer. Could not find id " + std::to_string(id));
+        return pointers[id-1];
+    }
+
+    void registerSharedPointer(const std::uint32_t id, std::shared_ptr<void> ptr)
+    {
+        const std::uint32_t stripped_id = id & ~cereal::detail::msb_32bit;
+        if(stripped_id == 0)
+            throw cereal::Exception("Invalid smart pointer id 0");
+        if(stripped_id > pointers.size())
+            pointers.resize(stripped_id);
+        pointers[stripped_id-1] = std::move(ptr);
+    }
+
+private:
+    std::istream& itsStream;
+    std::vector<char> buffer;
+    std::vector<std::shared_ptr<void>> pointers;
+};
+
+// same as for cereal's binary archives
+
+template<class T>
+inline typename std::enable_if<std::is_arithmetic<T>::value>::type
+CEREAL_SAVE_FUNCTION_NAME(BulkBinaryOutputArchive& ar, const T& t)
+{
+    ar.saveBinary(std::addressof(t), sizeof(t));
+}
+
+template<class T>
+inline typename std::enable_if<std::is_arithmetic<T>::value>::type
+CEREAL_LOAD_FUNCTION_NAME(BulkBinaryInputArchive& ar, T& t)
+{
+    ar.loadBinary(std::addressof(t), sizeof(t));
+}
+
+template<class Archive, class T>
+inline CEREAL_ARCHIVE_RESTRICT(BulkBinaryInputArchive, BulkBinaryOutputArchive)
+CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, cereal::NameValuePair<T>& t)
+{
+    ar(t.value);
+}
+
+template<class Archive, class T>
+inline CEREAL_ARCHIVE_RESTRICT(BulkBinaryInputArchive, BulkBinaryOutputArchive)
+CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, cereal::SizeTag<T>& t)
+{
+    ar(t.size);
+}
+
+template<class T>
+inline void CEREAL_SAVE_FUNCTION_NAME(BulkBinaryOutputArchive& ar, const cereal::BinaryData<T>& bd)
+{
+    ar.saveBinary(bd.data, static_cast<std::size_t>(bd.size));
+}
+
+template<class T>
+inline void CEREAL_LOAD_FUNCTION_NAME(BulkBinaryInputArchive& ar, cereal::BinaryData<T>& bd)
+{
+    ar.loadBinary(bd.data, static_cast<std::size_t>(bd.size));
+}
+
+// vectors of plain data, more specialized than cereal's generic vector overloads
+
+template<class T, class A>
+inline typename std::enable_if<is_bulk_serializable<T>::value>::type
+CEREAL_SAVE_FUNCTION_NAME(BulkBinaryOutputArchive& ar, const std::vector<T, A>& v)
+{
+    ar(cereal::make_size_tag(static_cast<cereal::size_type>(v.size())));
+    ar.saveBulk(v);
+}
+
+template<class T, class A>
+inline typename std::enable_if<is_bulk_serializable<T>::value>::type
+CEREAL_LOAD_FUNCTION_NAME(BulkBinaryInputArchive& ar, std::vector<T, A>& v)
+{
+    cereal::size_type size;
+    ar(cereal::make_size_tag(size));
+    v.resize(static_cast<std::size_t>(size));
+    ar.loadBulk(v);
+}
+
+} // namespace ant
+
+CEREAL_REGISTER_ARCHIVE(ant::BulkBinaryOutputArchive)
+CEREAL_REGISTER_ARCHIVE(ant::BulkBinaryInputArchive)
+
+CEREAL_SETUP_ARCHIVE_TRAITS(ant::BulkBinaryInputArchive, ant::BulkBinaryOutputArchive)
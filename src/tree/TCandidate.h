@@ -32,6 +32,10 @@ struct TCandidate
 
     TClusterList Clusters;
 
+    // unit vector along Theta/Phi, computed once on construction and loading,
+    // call UpdateDirection() after changing Theta or Phi
+    vec3 Direction;
+
     TCandidate(
             Detector_t::Any_t detector,
             double caloE,
@@ -51,15 +55,24 @@ struct TCandidate
         ClusterSize(clusterSize),
         VetoEnergy(vetoE),
         TrackerEnergy(trackerE),
-        Clusters(std::move(clusters))
+        Clusters(std::move(clusters)),
+        Direction(vec3::RThetaPhi(1.0, theta, phi))
     {}
 
     template<class Archive>
-    void serialize(Archive& archive) {
+    void save(Archive& archive) const {
+        archive(Detector, CaloEnergy, Theta, Phi, Time, ClusterSize, VetoEnergy, TrackerEnergy, Clusters);
+    }
+
+    template<class Archive>
+    void load(Archive& archive) {
         archive(Detector, CaloEnergy, Theta, Phi, Time, ClusterSize, VetoEnergy, TrackerEnergy, Clusters);
+        UpdateDirection();
     }
 
-    operator vec3() const { return vec3::RThetaPhi(1.0, Theta, Phi); }
+    void UpdateDirection() { Direction = vec3::RThetaPhi(1.0, Theta, Phi); }
+
+    operator vec3() const { return Direction; }
 
     TClusterPtr FindFirstCluster(Detector_t::Any_t detector) const {
         auto it = std::find_if(Clusters.begin(), Clusters.end(), [detector] (const TCluster& cl) {
@@ -86,7 +99,7 @@ struct TCandidate
                  << " VetoEnergy=" << o.VetoEnergy << " TrackerEnergy=" << o.TrackerEnergy;
     }
 
-    TCandidate() : Detector(Detector_t::Any_t::None) {}
+    TCandidate() : Detector(Detector_t::Any_t::None), Direction(0, 0, 1) {}
 };
 
 
@@ -48,6 +48,9 @@ struct TClusterHit
         }
 
         Datum() {}
+
+        // plain data, see BulkBinaryArchive.h
+        static constexpr bool bulk_serializable = true;
     };
 
     std::vector<Datum> Data;
@@ -1,8 +1,18 @@
 #pragma once
 
 #include "base/Detector_t.h"
+#include "base/std_ext/small_vector.h"
+
+// ignore warnings from library
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnon-virtual-dtor"
+#include "cereal/cereal.hpp"
+#pragma GCC diagnostic pop
+
 #include <iomanip>
 #include <sstream>
+#include <cstring>
+#include <stdexcept>
 
 namespace ant {
 
@@ -12,8 +22,11 @@ struct TDetectorReadHit
     Channel_t::Type_t  ChannelType;
     std::uint32_t      Channel;
 
-    // represents some arbitrary binary blob
-    std::vector<std::uint8_t> RawData;
+    // raw 16bit words as delivered by the unpacker,
+    // for example multiple TDC hits of one channel,
+    // a few of them are stored without allocation
+    using RawData_t = std_ext::small_vector<std::uint16_t, 4>;
+    RawData_t RawData;
 
     // encapsulates the possible outcomes of conversion
     // from RawData, including intermediate results (typically before calibration)
@@ -25,6 +38,9 @@ struct TDetectorReadHit
         double Uncalibrated; // converted value, for example useful for pedestals
         double   Calibrated; // final value, commonly used as timings or energy
 
+        // plain data, see BulkBinaryArchive.h
+        static constexpr bool bulk_serializable = true;
+
         template<class Archive>
         void serialize(Archive& archive) {
             archive(Uncalibrated, Calibrated);
@@ -46,11 +62,11 @@ struct TDetectorReadHit
 
     // RawData ctor
     TDetectorReadHit(const LogicalChannel_t& element,
-                     const std::vector<std::uint8_t>& rawData) :
+                     RawData_t rawData) :
         DetectorType(element.DetectorType),
         ChannelType(element.ChannelType),
         Channel(element.Channel),
-        RawData(rawData),
+        RawData(std::move(rawData)),
         Values(),
         ValueBits()
     {
@@ -70,9 +86,45 @@ struct TDetectorReadHit
 
     TDetectorReadHit() = default;
 
+    // the raw data is written with the same bytes as a std::vector,
+    // version 1 stores the 16bit words (before, see load_v5)
+    template<class Archive>
+    void save(Archive& archive, const std::uint32_t) const {
+        static_assert(!cereal::traits::is_text_archive<Archive>::value, "RawData is stored as binary data");
+        archive(DetectorType, ChannelType, Channel);
+        archive(cereal::make_size_tag(static_cast<cereal::size_type>(RawData.size())));
+        archive(cereal::binary_data(RawData.data(), RawData.size()*sizeof(std::uint16_t)));
+        archive(Values, ValueBits);
+    }
+
     template<class Archive>
-    void serialize(Archive& archive) {
-        archive(DetectorType, ChannelType, Channel, RawData, Values, ValueBits);
+    void load(Archive& archive, const std::uint32_t version) {
+        static_assert(!cereal::traits::is_text_archive<Archive>::value, "RawData is stored as binary data");
+        if(version != 1)
+            throw std::runtime_error("TDetectorReadHit version mismatch");
+        archive(DetectorType, ChannelType, Channel);
+        cereal::size_type size;
+        archive(cereal::make_size_tag(size));
+        RawData.resize(size);
+        archive(cereal::binary_data(RawData.data(), RawData.size()*sizeof(std::uint16_t)));
+        archive(Values, ValueBits);
+    }
+
+    /**
+     * @brief load_v5 reads a hit of TEvent version 5, which stored the raw data as bytes and no class version
+     */
+    template<class Archive>
+    void load_v5(Archive& archive) {
+        static_assert(!cereal::traits::is_text_archive<Archive>::value, "RawData is stored as binary data");
+        archive(DetectorType, ChannelType, Channel);
+        cereal::size_type size;
+        archive(cereal::make_size_tag(size));
+        // the bytes of the 16bit words in host order
+        RawData.resize((size+1)/2);
+        std::vector<std::uint8_t> bytes(size);
+        archive(cereal::binary_data(bytes.data(), bytes.size()));
+        std::memcpy(RawData.data(), bytes.data(), bytes.size());
+        archive(Values, ValueBits);
     }
 
     friend std::ostream& operator<<( std::ostream& s, const TDetectorReadHit& o) {
@@ -88,7 +140,7 @@ struct TDetectorReadHit
             std::ostringstream s_rawdata;
             s_rawdata << std::hex << std::uppercase << std::setfill('0');
             for(auto i = o.RawData.rbegin(); i != o.RawData.rend(); i++) {
-                s_rawdata << std::setw(2) << static_cast<int>(*i);
+                s_rawdata << std::setw(4) << *i;
             }
             s << " RawData=0x" << s_rawdata.str();
         }
@@ -111,3 +163,6 @@ struct TDetectorReadHit
 };
 
 }
+
+// stored since TEvent version 6
+CEREAL_CLASS_VERSION(ant::TDetectorReadHit, 1)
@@ -23,13 +23,49 @@ namespace cereal
   struct specialize<Archive, TParticle, cereal::specialization::member_load_save> {};
 }
 
+// version 5 did not store the class version of the DetectorReadHits either,
+// so the event data is read field by field as written back then
+namespace {
+
+template<class Archive>
+void load_eventdata_v5(Archive& archive, unique_ptr<TEventData>& eventdata)
+{
+    // the valid flag of cereal's unique_ptr
+    uint8_t valid;
+    archive(valid);
+    if(!valid) {
+        eventdata.reset();
+        return;
+    }
+    eventdata = std_ext::make_unique<TEventData>();
+    auto& d = *eventdata;
+    archive(d.ID);
+    cereal::size_type nHits;
+    archive(cereal::make_size_tag(nHits));
+    d.DetectorReadHits.resize(nHits);
+    for(auto& hit : d.DetectorReadHits)
+        hit.load_v5(archive);
+    archive(d.SlowControls, d.UnpackerMessages,
+            d.TaggerHits, d.Trigger, d.Target,
+            d.Clusters, d.Candidates, d.ParticleTree);
+}
+
+}
+
+template<class Archive>
+void TEvent::load_v5(Archive& archive)
+{
+    load_eventdata_v5(archive, reconstructed);
+    load_eventdata_v5(archive, mctrue);
+    archive(SavedForSlowControls);
+}
+
 // create some TBuffer to std::streambuf interface
 void TEvent::Streamer(TBuffer& R__b)
 {
     stream_TBuffer::DoBinary(R__b, *this);
 }
 
-
 // other stuff
 
 TEvent::TEvent() : reconstructed(), mctrue() {}
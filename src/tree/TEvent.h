@@ -5,9 +5,10 @@
 #ifndef __CINT__
 #include <memory>
 #include <stdexcept>
+#include <cstdint>
 #endif
 
-#define ANT_TEVENT_VERSION 5
+#define ANT_TEVENT_VERSION 6
 
 namespace ant {
 
@@ -35,12 +36,20 @@ struct TEvent
     bool SavedForSlowControls = false;
 
     template<class Archive>
-    void serialize(Archive& archive, const std::uint32_t version) {
-        if(version != ANT_TEVENT_VERSION)
-            throw std::runtime_error("TEvent version mismatch");
+    void save(Archive& archive, const std::uint32_t) const {
         archive(reconstructed, mctrue, SavedForSlowControls);
     }
 
+    template<class Archive>
+    void load(Archive& archive, const std::uint32_t version) {
+        if(version < 5 || version > ANT_TEVENT_VERSION)
+            throw std::runtime_error("TEvent version mismatch");
+        if(version == 5)
+            load_v5(archive);
+        else
+            archive(reconstructed, mctrue, SavedForSlowControls);
+    }
+
     friend std::ostream& operator<<( std::ostream& s, const TEvent& o);
 
     explicit TEvent(const TID& id_reconstructed);
@@ -51,6 +60,11 @@ struct TEvent
     TEvent& operator=(TEvent&&);
 
 protected:
+    // version 5 stored the raw data of the DetectorReadHits as bytes,
+    // only instantiated in TEvent.cc by the Streamer
+    template<class Archive>
+    void load_v5(Archive& archive);
+
     // exclamation mark at the beginning of the comment below tells ROOT
     // to exclude the data members from the Streamer (added because of ROOT6)
     std::unique_ptr<TEventData> reconstructed;  //! reconstructed detector information, either Geant or raw data
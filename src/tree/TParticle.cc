@@ -15,6 +15,14 @@ TParticle::TParticle(const ParticleTypeDatabase::Type& type_, mev_t Ek_, radian_
 {
 }
 
+TParticle::TParticle(const ParticleTypeDatabase::Type& type_, const TCandidatePtr& candidate) :
+  LorentzVec(candidate->Direction * sqrt( sqr(candidate->CaloEnergy + type_.Mass()) - sqr(type_.Mass())),
+             candidate->CaloEnergy + type_.Mass()),
+  Candidate(candidate),
+  type(std::addressof(type_))
+{
+}
+
 void TParticle::ChangeType(const ParticleTypeDatabase::Type& newtype)
 {
     // recalculate Lorentz vector
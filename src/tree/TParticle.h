@@ -38,11 +38,8 @@ struct TParticle : LorentzVec {
         type(std::addressof(type_))
     {}
 
-    TParticle(const ParticleTypeDatabase::Type& type_, const TCandidatePtr& candidate):
-        TParticle(type_, candidate->CaloEnergy, candidate->Theta, candidate->Phi)
-    {
-        Candidate = candidate;
-    }
+    // uses the cached direction of the candidate
+    TParticle(const ParticleTypeDatabase::Type& type_, const TCandidatePtr& candidate);
 
 
     mev_t Ek() const { return E - type->Mass(); }
@@ -27,6 +27,10 @@ struct TTaggerHit
         {}
 
         Electron_t() = default;
+
+        // plain data, see BulkBinaryArchive.h
+        static constexpr bool bulk_serializable = true;
+
         template<class Archive>
         void serialize(Archive& archive) {
             archive(Channel, Timing, QDCEnergy);
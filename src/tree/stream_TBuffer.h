@@ -13,6 +13,8 @@
 #include "cereal/types/bitset.hpp"
 #pragma GCC diagnostic pop
 
+#include "BulkBinaryArchive.h"
+
 #include "TBuffer.h"
 #include <streambuf>
 
@@ -32,18 +34,18 @@ public:
     }
 
     // little helper function to call the binary archiver
-    // on some class
+    // on some class, the bulk archives give the same bytes as cereal's binary archives
     template<class T>
     static void DoBinary(TBuffer& tbuffer, T& theClass) {
         stream_TBuffer buf(tbuffer);
         std::iostream inoutstream(addressof(buf));
 
         if (tbuffer.IsReading()) {
-            cereal::BinaryInputArchive ar(inoutstream);
+            BulkBinaryInputArchive ar(inoutstream);
             ar(theClass);
         }
         else {
-            cereal::BinaryOutputArchive ar(inoutstream);
+            BulkBinaryOutputArchive ar(inoutstream);
             ar(theClass);
         }
     }
@@ -96,6 +96,30 @@ public:
         p->reset();
     }
 
+    /**
+     * @brief compressed indicates if the bytes are decompressed on-the-fly
+     * @return true if file is xz or gz compressed
+     */
+    bool compressed() const {
+        return p->gcount_compressed() >= 0;
+    }
+
+    /**
+     * @brief pos current position within the file
+     * @return number of bytes read so far, refers to the compressed bytes for compressed files
+     */
+    std::streamsize pos() const {
+        return p->pos();
+    }
+
+    /**
+     * @brief filesize of the opened file
+     * @return size in bytes, refers to the compressed size for compressed files
+     */
+    std::streamsize filesize() const {
+        return p->filesize_total();
+    }
+
     class Exception : public std::runtime_error {
         using std::runtime_error::runtime_error; // use base class constructor
     };
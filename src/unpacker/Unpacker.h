@@ -48,6 +48,13 @@ public:
         virtual TEvent NextEvent() = 0;
         virtual double PercentDone() const = 0;
         virtual bool   ProvidesSlowControl() const = 0;
+        /**
+         * @brief InSplitRange tells if the event last returned by NextEvent should be analysed
+         *
+         * Modules which can process only a part of their input (see UnpackerAcqu::Split)
+         * may still emit events outside this part, which carry slow control information only.
+         */
+        virtual bool   InSplitRange() const { return true; }
     protected:
         friend class Unpacker;
         virtual bool OpenFile(const std::string& filename) = 0;
@@ -100,12 +100,14 @@ bool UnpackerA2Geant::OpenFile(const string& filename)
         return false;
 
     geantTree.LinkBranches();
+    WrapTFileInput::SetupReadCache(geantTree.Tree);
 
     if(inputfile->GetObject("h12_tid", tidTree.Tree)) {
         if(tidTree.Tree->GetEntries() != geantTree.Tree->GetEntries()) {
             throw Exception("Geant Tree and TID Tree size mismatch");
         }
         tidTree.LinkBranches();
+        WrapTFileInput::SetupReadCache(tidTree.Tree);
     } else {
         // think of some better timestamp?
         tidTree.tid = TID(static_cast<std::uint32_t>(std::time(nullptr)),
@@ -208,8 +210,8 @@ TEvent UnpackerA2Geant::NextEvent()
         const auto nCh = cb_detector->GetNChannels();
         if(oldTreeFormat) {
             if(t.icryst[i]<0 || t.icryst[i]>=static_cast<int>(nCh)) {
-                LOG_N_TIMES(10, WARNING) << "Ignoring CB index out of bounds: " << t.icryst[i]
-                                            << " i=" << i << " (max 10 times reported)";
+                LOG_AGGREGATED(10, WARNING) << "Ignoring CB index out of bounds: " << t.icryst[i]
+                                            << " i=" << i;
                 continue;
             }
         }
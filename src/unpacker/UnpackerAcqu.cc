@@ -2,13 +2,21 @@
 #include "detail/UnpackerAcqu_detail.h"
 
 #include "tree/TEvent.h"
+#include "tree/TEventData.h"
+#include "tree/TSlowControl.h"
 #include "base/Logger.h"
+#include "base/std_ext/string.h"
 
 #include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
 
 using namespace std;
 using namespace ant;
 
+UnpackerAcqu::Split_t UnpackerAcqu::Split;
+
 UnpackerAcqu::UnpackerAcqu() {}
 UnpackerAcqu::~UnpackerAcqu() {}
 
@@ -26,6 +34,17 @@ bool UnpackerAcqu::OpenFile(const std::string &filename)
     if(file == nullptr)
         return false;
 
+    if(Split.NParts>1) {
+        if(Split.Part >= Split.NParts)
+            throw Exception(std_ext::formatter() << "Split part " << Split.Part
+                            << " out of range, only " << Split.NParts << " parts");
+        const uint64_t nRecords = file->NumberOfRecords();
+        range_begin = nRecords*Split.Part/Split.NParts;
+        range_end   = nRecords*(Split.Part+1)/Split.NParts;
+        LOG(INFO) << "Analysing records [" << range_begin << ", " << range_end << ") of "
+                  << nRecords << " (part " << Split.Part+1 << " of " << Split.NParts << ")";
+    }
+
     LOG(INFO) << "Successfully opened " << filename;
     return true;
 }
@@ -33,11 +52,29 @@ bool UnpackerAcqu::OpenFile(const std::string &filename)
 TEvent UnpackerAcqu::NextEvent()
 {
     // check if we need to replenish the queue
-    if(queue.empty()) {
+    while(queue.empty()) {
+        if(finished)
+            return {};
+        const auto record = file->NextRecord();
+        // records outside the range are only needed for their slowcontrol information,
+        // so their other events are skipped without unpacking them
+        if(Split.NParts>1)
+            file->Skim(record < range_begin || record >= range_end);
         file->FillEvents(queue);
-        // still empty? Then the file is completely processed...
-        if(queue.empty())
+        // still empty? Then the file is completely processed,
+        // unless all events of a skimmed record were skipped
+        if(queue.empty()) {
+            if(file->NextRecord() != record)
+                continue;
             return {};
+        }
+        if(Split.NParts>1) {
+            queue_inrange = record >= range_begin && record < range_end;
+            if(queue_inrange)
+                keep_next = false;
+            else
+                SkimQueue(record >= range_end);
+        }
     }
 
     // std;:deque does not have a method to get and remove the element
@@ -50,3 +87,32 @@ TEvent UnpackerAcqu::NextEvent()
 
 
 
+
+void UnpackerAcqu::SkimQueue(bool after_range)
+{
+    // keep only events carrying slowcontrol information, and the event right after them,
+    // as this one is the first to see the changed slowcontrol values.
+    // Then the state of the slowcontrol processors at the start of the range
+    // is the same as if the file was processed from the beginning
+    auto it = queue.begin();
+    while(it != queue.end()) {
+        const auto& slowcontrols = it->Reconstructed().SlowControls;
+        const bool keep = keep_next || !slowcontrols.empty();
+        keep_next = !slowcontrols.empty();
+        if(!keep) {
+            it = queue.erase(it);
+            continue;
+        }
+        // behind the range, the next scaler read completes the backward valid
+        // slowcontrol of the events at the end of the range, nothing more is needed
+        const auto is_scaler = [] (const TSlowControl& sc) {
+            return sc.Type == TSlowControl::Type_t::AcquScaler;
+        };
+        if(after_range && any_of(slowcontrols.begin(), slowcontrols.end(), is_scaler)) {
+            queue.erase(next(it), queue.end());
+            finished = true;
+            break;
+        }
+        ++it;
+    }
+}
@@ -32,10 +32,34 @@ public:
 
     virtual double PercentDone() const override;
 
+    virtual bool InSplitRange() const override { return queue_inrange; }
+
+    /**
+     * @brief The Split_t struct selects a part of the file's data records to be analysed
+     *
+     * The file is split into NParts ranges of consecutive records, and only the events of
+     * range number Part are reported to be in range. All records are still unpacked to keep
+     * the event IDs the same as for the whole file, and the events before and after the range
+     * carrying slow control information are emitted as well. Set it before opening the file.
+     */
+    struct Split_t {
+        unsigned Part = 0;
+        unsigned NParts = 1;
+    };
+    static Split_t Split;
+
 private:
     std::list<TEvent> queue; // std::list supports splice
     std::unique_ptr<UnpackerAcquFileFormat> file;
 
+    // record range [begin, end) when splitting
+    unsigned range_begin = 0;
+    unsigned range_end = 0;
+    bool queue_inrange = true;
+    bool keep_next = false;
+    bool finished = false;
+
+    void SkimQueue(bool after_range);
 };
 
 // we define some methods here which
@@ -221,12 +221,28 @@ void acqu::FileFormatMk1::UnpackEvent(TEventData& eventdata, it_t& it, const it_
     }
 
     // hit_storage is member variable for better memory allocation performance
-    FillDetectorReadHits(hit_storage, hit_mappings_ptr, eventdata.DetectorReadHits);
+    hit_lookup.Fill(hit_storage, eventdata.DetectorReadHits);
     FillSlowControls(scalers, scaler_mappings, eventdata.SlowControls);
 
     ++it; // go to start word of next event (if any)
 }
 
+bool acqu::FileFormatMk1::SkipEvent(it_t& it, const it_t& it_endbuffer) const noexcept
+{
+    // hits don't have a marker, so the event ends at the first EEndEvent,
+    // events with scaler or error blocks are left to UnpackEvent
+    auto it_word = it;
+    while(it_word != it_endbuffer && *it_word != acqu::EEndEvent) {
+        if(*it_word == acqu::EScalerBuffer || *it_word == acqu::EReadError)
+            return false;
+        ++it_word;
+    }
+    if(it_word == it_endbuffer)
+        return false;
+    it = next(it_word);
+    return true;
+}
+
 void acqu::FileFormatMk1::HandleDAQError(vector<TDAQError>& errors,
                                          it_t& it, const it_t& it_end,
                                          bool& good) const noexcept
@@ -273,7 +289,7 @@ void acqu::FileFormatMk1::HandleScalerBuffer(
     if(nWordsRemaining < *it_scalerblock) {
         LogMessage(TUnpackerMessage::Level_t::DataError,
                    "Expected scaler block not completely present in event",
-                   true // emit warning
+                   &LOG_AGGREGATED_SITE(100) // emit warning
                    );
         return;
     }
@@ -297,7 +313,7 @@ void acqu::FileFormatMk1::HandleScalerBuffer(
             if(std::distance(it_endscaler, it_end) < nWords_error) {
                 LogMessage(TUnpackerMessage::Level_t::DataError,
                            "Scaler block had error marker but not completely present in event",
-                           true // emit warning
+                           &LOG_AGGREGATED_SITE(100) // emit warning
                            );
                 return;
             }
@@ -25,6 +25,7 @@ protected:
     virtual void FillInfo(reader_t& reader, buffer_t& buffer, Info& info) override;
     virtual void FillFirstDataBuffer(reader_t& reader, buffer_t& buffer) const override;
     virtual void UnpackEvent(TEventData& eventdata, it_t& it, const it_t& it_endbuffer, bool& good) noexcept override;
+    virtual bool SkipEvent(it_t& it, const it_t& it_endbuffer) const noexcept override;
 
     void FindScalerBlocks(const std::vector<Info::HardwareModule>& scalerinfos);
 
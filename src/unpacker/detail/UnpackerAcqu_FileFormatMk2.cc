@@ -11,6 +11,8 @@
 
 #include "base/Logger.h"
 
+#include <algorithm>
+
 using namespace std;
 using namespace ant;
 using namespace ant::unpacker;
@@ -224,12 +226,31 @@ void acqu::FileFormatMk2::UnpackEvent(
     }
 
     // hit_storage is member variable for better memory allocation performance
-    FillDetectorReadHits(hit_storage, hit_mappings_ptr, eventdata.DetectorReadHits);
+    hit_lookup.Fill(hit_storage, eventdata.DetectorReadHits);
     FillSlowControls(scalers, scaler_mappings, eventdata.SlowControls);
 
     it++; // go to start word of next event (if any)
 }
 
+bool acqu::FileFormatMk2::SkipEvent(it_t& it, const it_t& it_endbuffer) const noexcept
+{
+    // malformed events are left to UnpackEvent
+    const unsigned eventLength = *it/sizeof(decltype(*it));
+    if(std::distance(it, it_endbuffer) <= eventLength)
+        return false;
+    const auto it_endevent = next(it, eventLength);
+    if(*it_endevent != acqu::EEndEvent)
+        return false;
+    // the markers might also appear as data words, such events are simply unpacked
+    const auto is_slowcontrol = [] (uint32_t word) {
+        return word == acqu::EScalerBuffer || word == acqu::EEPICSBuffer;
+    };
+    if(any_of(next(it), it_endevent, is_slowcontrol))
+        return false;
+    it = next(it_endevent);
+    return true;
+}
+
 void acqu::FileFormatMk2::HandleScalerBuffer(
         scalers_t& scalers,
         it_t& it, const it_t& it_end,
@@ -23,6 +23,7 @@ protected:
     virtual void FillFirstDataBuffer(reader_t& reader, buffer_t& buffer) const override;
 
     virtual void UnpackEvent(TEventData& eventdata, it_t& it, const it_t& it_endbuffer, bool& good) noexcept override;
+    virtual bool SkipEvent(it_t& it, const it_t& it_endbuffer) const noexcept override;
     void HandleScalerBuffer(scalers_t& scalers,
                             it_t& it, const it_t& it_end, bool& good,
                             std::vector<TDAQError>& errors) const noexcept;
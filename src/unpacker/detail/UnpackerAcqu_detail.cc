@@ -118,19 +118,15 @@ void acqu::FileFormatBase::Setup(reader_t &&reader_, buffer_t &&buffer_) {
 
     // remember the record length size
     trueRecordLength = buffer.size();
+    // and where the data records start in the file,
+    // the first one was just read into the buffer
+    firstRecordOffset = reader->pos() - 4*trueRecordLength;
 
     // get the mappings once
     setup.BuildMappings(hit_mappings, scaler_mappings);
 
-    // and prepare the member variables for fast unpacking of hits
-    for(const UnpackerAcquConfig::hit_mapping_t& hit_mapping : hit_mappings) {
-        for(const UnpackerAcquConfig::RawChannel_t<uint16_t>& rawChannel : hit_mapping.RawChannels) {
-            const uint16_t ch = rawChannel.RawChannel;
-            if(hit_mappings_ptr.size()<=ch)
-                hit_mappings_ptr.resize(ch+1);
-            hit_mappings_ptr[ch].push_back(addressof(hit_mapping));
-        }
-    }
+    // and prepare the lookup table for fast unpacking of hits
+    hit_lookup.Build(hit_mappings);
 
 }
 
@@ -144,6 +140,20 @@ double acqu::FileFormatBase::PercentDone() const
     return reader->PercentDone();
 }
 
+unsigned acqu::FileFormatBase::NextRecord() const
+{
+    return nUnpackedBuffers;
+}
+
+unsigned acqu::FileFormatBase::NumberOfRecords() const
+{
+    if(reader->compressed())
+        throw UnpackerAcqu::Exception("Number of records unknown for compressed file, decompress it first");
+    if(trueRecordLength == 0)
+        return 0;
+    return (reader->filesize() - firstRecordOffset)/(4*trueRecordLength);
+}
+
 time_t acqu::FileFormatBase::GetTimeStamp()
 {
     // the following calculation assumes
@@ -202,7 +212,7 @@ time_t acqu::FileFormatBase::GetTimeStamp()
 void acqu::FileFormatBase::LogMessage(
         TUnpackerMessage::Level_t level,
         const string& msg,
-        bool emit_warning
+        logger::Aggregator::site_t* warning
         ) const
 {
 
@@ -220,13 +230,18 @@ void acqu::FileFormatBase::LogMessage(
         break;
     }
 
-    const string& msg_ = std_ext::formatter()
-                         << "(nUnpackedBuffers=" << nUnpackedBuffers << ", nEventsInBuffer=" << nEventsInBuffer << ")"
-                         << " [TUnpackerMessage] " << messages.back().Message;
-    if(emit_warning)
-        LOG(WARNING) << msg_;
-    else
-        VLOG(levelnum) << msg_;
+    // only format the message if it is really logged
+    if(warning) {
+        if(logger::Aggregator::Allow(*warning))
+            LOG(WARNING)
+                << "(nUnpackedBuffers=" << nUnpackedBuffers << ", nEventsInBuffer=" << nEventsInBuffer << ")"
+                << " [TUnpackerMessage] " << messages.back().Message;
+    }
+    else {
+        VLOG(levelnum)
+                << "(nUnpackedBuffers=" << nUnpackedBuffers << ", nEventsInBuffer=" << nEventsInBuffer << ")"
+                << " [TUnpackerMessage] " << messages.back().Message;
+    }
 }
 
 void acqu::FileFormatBase::AppendMessagesToEvent(TEvent& event) const
@@ -268,7 +283,7 @@ void acqu::FileFormatBase::FillEvents(queue_t& queue) noexcept
     queue_t queue_buffer;
     if(!UnpackDataBuffer(queue_buffer, it, buffer.cend())) {
         // handle errors on buffer scale
-        LOG(WARNING) << "Error while unpacking buffer n=" << nUnpackedBuffers
+        LOG_AGGREGATED(100, WARNING) << "Error while unpacking buffer n=" << nUnpackedBuffers
                      << ", discarding all unpacked data from buffer.";
 
         // add an datadiscard message to an empty event
@@ -567,13 +582,20 @@ bool acqu::FileFormatBase::UnpackDataBuffer(UnpackerAcquFileFormat::queue_t& que
             LogMessage(TUnpackerMessage::Level_t::DataError,
                        std_ext::formatter()
                        << "AcquID=" << acquID << " not consecutive from last AcquID=" << AcquID_last,
-                       true // emit warning
+                       &LOG_AGGREGATED_SITE(100) // emit warning
                        );
         }
 
         AcquID_last = acquID;
         ++it;
 
+        // when skimming, events are only counted, unless they or the event before carry slowcontrol information
+        if(skim && !slowcontrol_last && SkipEvent(it, it_endbuffer)) {
+            ++id;
+            ++nEventsInBuffer;
+            continue;
+        }
+
         queue.emplace_back(id);
         TEventData& eventdata = queue.back().Reconstructed();
 
@@ -585,11 +607,12 @@ bool acqu::FileFormatBase::UnpackDataBuffer(UnpackerAcquFileFormat::queue_t& que
             if(!good)
                 return false;
         }
+        slowcontrol_last = !eventdata.SlowControls.empty();
 
         if(eventdata.DetectorReadHits.empty()) {
             LogMessage(TUnpackerMessage::Level_t::Info,
                        "Unpacked event with completely empty DetectorReadHits",
-                       true // emit warning
+                       &LOG_AGGREGATED_SITE(100) // emit warning
                        );
         }
 
@@ -630,11 +653,38 @@ bool acqu::FileFormatBase::UnpackDataBuffer(UnpackerAcquFileFormat::queue_t& que
     return true;
 }
 
-void acqu::FileFormatBase::FillDetectorReadHits(const hit_storage_t& hit_storage,
-                                                const hit_mappings_ptr_t& hit_mappings_ptr,
-                                                vector<TDetectorReadHit>& hits) noexcept
+void acqu::hit_lookup_t::Build(const std::vector<UnpackerAcquConfig::hit_mapping_t>& hit_mappings)
+{
+    // collect the entries per raw channel first,
+    // a raw channel appearing twice in one mapping is registered once
+    std::vector<std::vector<entry_t>> entries;
+    for(const UnpackerAcquConfig::hit_mapping_t& hit_mapping : hit_mappings) {
+        const auto& rawChannels = hit_mapping.RawChannels;
+        using RawChannel_t = UnpackerAcquConfig::RawChannel_t<uint16_t>;
+        const bool simple = rawChannels.size() == 1 && rawChannels.front().Mask == RawChannel_t::NoMask();
+        for(unsigned i=0;i<rawChannels.size();i++) {
+            const uint16_t ch = rawChannels[i].RawChannel;
+            if(entries.size()<=ch)
+                entries.resize(ch+1);
+            auto& ch_entries = entries[ch];
+            if(!ch_entries.empty() && ch_entries.back().Mapping == addressof(hit_mapping))
+                continue;
+            ch_entries.push_back({addressof(hit_mapping), i, simple});
+        }
+    }
+
+    // then flatten them
+    Offsets.assign(1, 0);
+    Entries.resize(0);
+    for(const auto& ch_entries : entries) {
+        Entries.insert(Entries.end(), ch_entries.begin(), ch_entries.end());
+        Offsets.push_back(Entries.size());
+    }
+}
+
+void acqu::hit_lookup_t::Fill(const hit_storage_t& hit_storage,
+                              vector<TDetectorReadHit>& hits) const noexcept
 {
-    // the order of hits corresponds to the given mappings
     hits.reserve(2*hit_storage.size());
 
     for(const auto& it_hits : hit_storage) {
@@ -644,24 +694,33 @@ void acqu::FileFormatBase::FillDetectorReadHits(const hit_storage_t& hit_storage
         if(values.empty())
             continue;
 
-        if(ch>=hit_mappings_ptr.size())
+        if(ch+1u>=Offsets.size())
             continue;
 
-        for(const UnpackerAcquConfig::hit_mapping_t* mapping : hit_mappings_ptr[ch]) {
-            using RawChannel_t = UnpackerAcquConfig::RawChannel_t<uint16_t>;
-            if(mapping->RawChannels.size() != 1) {
-                LOG(ERROR) << "Not implemented";
+        for(auto i = Offsets[ch]; i < Offsets[ch+1]; i++) {
+            const entry_t& entry = Entries[i];
+            const auto& mapping = *entry.Mapping;
+
+            if(entry.Simple) {
+                hits.emplace_back(mapping.LogicalChannel,
+                                  TDetectorReadHit::RawData_t(values.begin(), values.end()));
                 continue;
             }
-            if(mapping->RawChannels[0].Mask != RawChannel_t::NoMask()) {
-                LOG(ERROR) << "Not implemented";
+
+            // skip if an earlier raw channel of the mapping has values, the hit was created already
+            const auto& rawChannels = mapping.RawChannels;
+            const auto it_first = rawChannels.begin() + entry.Index;
+            if(any_of(rawChannels.begin(), it_first, [&hit_storage] (const UnpackerAcquConfig::RawChannel_t<uint16_t>& rawChannel) {
+                      return !hit_storage.get_item(rawChannel.RawChannel).empty();
+            }))
                 continue;
-            }
-            std::vector<std::uint8_t> rawData(sizeof(uint16_t)*values.size());
-            std::copy(values.begin(), values.end(),
-                      reinterpret_cast<uint16_t*>(std::addressof(rawData[0])));
 
-            hits.emplace_back(mapping->LogicalChannel, move(rawData));
+            TDetectorReadHit::RawData_t rawData;
+            for(auto it_rawChannel = it_first; it_rawChannel != rawChannels.end(); ++it_rawChannel) {
+                for(const uint16_t value : hit_storage.get_item(it_rawChannel->RawChannel))
+                    rawData.push_back(value & it_rawChannel->Mask);
+            }
+            hits.emplace_back(mapping.LogicalChannel, move(rawData));
         }
     }
 }
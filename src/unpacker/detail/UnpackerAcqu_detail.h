@@ -4,9 +4,11 @@
 #include "UnpackerAcqu.h" // UnpackerAcquConfig
 
 #include "base/std_ext/mapped_vectors.h"
+#include "base/Logger.h"
 
 #include <cstdint>
 #include <ctime>
+#include <ios>
 #include <list>
 #include <memory>
 #include <string>
@@ -23,6 +25,7 @@ namespace ant {
 class RawFileReader;
 struct TEvent;
 struct TSlowControl;
+struct TDetectorReadHit;
 
 class UnpackerAcquFileFormat {
 public:
@@ -48,6 +51,24 @@ public:
 
     virtual double PercentDone() const =0;
 
+    /**
+      * @brief NextRecord returns the index of the data record which the next FillEvents unpacks
+      */
+    virtual unsigned NextRecord() const = 0;
+
+    /**
+      * @brief NumberOfRecords returns the total number of data records in the file
+      *
+      * Throws exception if the number cannot be determined without reading the whole file.
+      */
+    virtual unsigned NumberOfRecords() const = 0;
+
+    /**
+      * @brief Skim lets FillEvents only unpack events carrying slowcontrol information and the event right after them,
+      * all other events are counted, but skipped without unpacking their hits
+      */
+    virtual void Skim(bool skim) noexcept = 0;
+
 protected:
     virtual size_t SizeOfHeader() const = 0;
     virtual bool InspectHeader(const std::vector<uint32_t>& buffer) const = 0;
@@ -60,6 +81,34 @@ protected:
 namespace unpacker {
 namespace acqu {
 
+using hit_storage_t = std_ext::mapped_vectors<std::uint16_t, std::uint16_t>;
+
+/**
+ * @brief The hit_lookup_t struct is a dense lookup table from raw channel to hit mappings
+ *
+ * The mappings of raw channel ch are Entries[Offsets[ch]] to Entries[Offsets[ch+1]]. A mapping
+ * with several raw channels concatenates their masked values in the order of RawChannels,
+ * the hit is created only once when the first raw channel with values is encountered.
+ */
+struct hit_lookup_t {
+    struct entry_t {
+        const UnpackerAcquConfig::hit_mapping_t* Mapping;
+        unsigned Index; // of the raw channel within Mapping->RawChannels
+        bool Simple;    // single raw channel without mask
+    };
+    std::vector<std::uint32_t> Offsets;
+    std::vector<entry_t> Entries;
+
+    void Build(const std::vector<UnpackerAcquConfig::hit_mapping_t>& hit_mappings);
+
+    /**
+     * @brief Fill appends the hits for the given raw values
+     * @param hit_storage raw values by raw channel
+     * @param hits the detector read hits, in the order of hit_storage
+     */
+    void Fill(const hit_storage_t& hit_storage, std::vector<TDetectorReadHit>& hits) const noexcept;
+};
+
 // FileFormatBase provides a common class for Mk1/Mk2 formats
 class FileFormatBase : public UnpackerAcquFileFormat {
 public:
@@ -67,9 +116,15 @@ public:
 
     virtual double PercentDone() const override;
 
+    virtual unsigned NextRecord() const override;
+    virtual unsigned NumberOfRecords() const override;
+
+    virtual void Skim(bool skim_) noexcept override { skim = skim_; }
+
 private:
     std::unique_ptr<RawFileReader> reader;
     std::vector<std::uint32_t>     buffer;
+    std::streamsize firstRecordOffset;
     // messages must be buffered during event unpacking,
     // but in order to have LogMessage() const,
     // the storage must be mutable
@@ -77,6 +132,8 @@ private:
     signed trueRecordLength;
     unsigned nUnpackedBuffers;
     unsigned nEventsInBuffer;
+    bool skim = false;
+    bool slowcontrol_last = false;
     time_t GetTimeStamp();
 protected:
 
@@ -121,9 +178,7 @@ protected:
     // especially keeping storage_hits over multiple
     // events makes it considerably faster
     std::vector<UnpackerAcquConfig::hit_mapping_t> hit_mappings;
-    using hit_mappings_ptr_t = std::vector< std::vector< const UnpackerAcquConfig::hit_mapping_t* > >;
-    hit_mappings_ptr_t hit_mappings_ptr;
-    using hit_storage_t = std_ext::mapped_vectors<std::uint16_t, std::uint16_t>;
+    hit_lookup_t hit_lookup;
     hit_storage_t hit_storage;
 
     using scaler_mappings_t = std::vector<UnpackerAcquConfig::scaler_mapping_t>;
@@ -134,15 +189,19 @@ protected:
     void Setup(reader_t&& reader_, buffer_t&& buffer_) override;
     void FillEvents(queue_t& queue) noexcept override;
 
-    // unpacker messages handling
+    // unpacker messages handling,
+    // pass LOG_AGGREGATED_SITE(n) as warning to also log the message as warning, limited per call site
     void LogMessage(TUnpackerMessage::Level_t level,
-                    const std::string& msg, bool emit_warning = false) const;
+                    const std::string& msg, logger::Aggregator::site_t* warning = nullptr) const;
     void AppendMessagesToEvent(TEvent& event) const;
 
     // Mk1/Mk2 specific methods
     virtual void FillInfo(reader_t& reader, buffer_t& buffer, Info& info) = 0;
     virtual void FillFirstDataBuffer(reader_t& reader, buffer_t& buffer) const = 0;
     virtual void UnpackEvent(TEventData& eventdata, it_t& it, const it_t& it_endbuffer, bool& good) noexcept = 0;
+    // moves it to the next event if the event carries no slowcontrol information,
+    // returns false and leaves it unchanged if the event must be unpacked
+    virtual bool SkipEvent(it_t& it, const it_t& it_endbuffer) const noexcept = 0;
 
     // things shared by Mk1/Mk2
     bool UnpackDataBuffer(queue_t& queue, it_t& it, const it_t& it_endbuffer) noexcept;
@@ -152,8 +211,6 @@ protected:
     bool FindFirstDataBuffer(reader_t& reader, buffer_t& buffer,
                              const size_t max_multiplier = 32,
                              const bool assert_multiplicity = true) const;
-    static void FillDetectorReadHits(const hit_storage_t& hit_storage, const hit_mappings_ptr_t& hit_mappings_ptr,
-                                     std::vector<TDetectorReadHit>& hits) noexcept;
     static void FillSlowControls(const scalers_t& scalers, const scaler_mappings_t& scaler_mappings,
                                  std::vector<TSlowControl>& slowcontrols) noexcept;
 
@@ -3,20 +3,29 @@
 #include "expconfig_helpers.h"
 
 #include "analysis/input/ant/AntReader.h"
+#include "analysis/input/ant/ReconstructCache.h"
+#include "analysis/utils/TriggerSimulation.h"
 
 #include "tree/TEvent.h"
 #include "tree/TEventData.h"
+#include "tree/TParticle.h"
+#include "tree/stream_TBuffer.h"
+
+#include "expconfig/ExpConfig.h"
 
 #include "unpacker/Unpacker.h"
 #include "reconstruct/Reconstruct.h"
 
 #include "base/WrapTFile.h"
 #include "base/tmpfile_t.h"
+#include "base/std_ext/arena.h"
 
 #include "TTree.h"
 
 #include <string>
 #include <iostream>
+#include <sstream>
+#include <vector>
 
 using namespace std;
 using namespace ant;
@@ -24,12 +33,18 @@ using namespace ant::analysis;
 using namespace ant::analysis::input;
 
 void dotest_read_unpacker();
+void dotest_reconstruct_cache();
 
 TEST_CASE("AntReader: Read from unpacker", "[analysis]") {
     test::EnsureSetup();
     dotest_read_unpacker();
 }
 
+TEST_CASE("AntReader: Reconstruct cache", "[analysis]") {
+    test::EnsureSetup();
+    dotest_reconstruct_cache();
+}
+
 
 void dotest_read_unpacker() {
     auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
@@ -58,3 +73,84 @@ void dotest_read_unpacker() {
     REQUIRE(nCandidates == 864);
 
 }
+
+struct cached_event_t {
+    string Serialized;
+    size_t nDetectorReadHits;
+    double CBEnergySum;
+};
+
+vector<cached_event_t> read_all(AntReader& reader) {
+    vector<cached_event_t> events;
+    utils::TriggerSimulation triggersimu;
+    auto& arena = std_ext::arena::Get();
+    // like physics classes, keep a particle across events
+    TParticlePtr kept;
+    while(true) {
+        event_t event;
+        if(!reader.ReadNextEvent(event))
+            break;
+        // candidates are either reconstructed or loaded by cereal from the cache
+        const auto& candidates = event.Reconstructed().Candidates;
+        if(!candidates.empty())
+            kept = std_ext::make_arena_shared<TParticle>(ParticleTypeDatabase::Photon, candidates.get_ptr_at(0));
+        stringstream ss;
+        {
+            cereal::BinaryOutputArchive ar(ss);
+            ar(event.Reconstructed());
+        }
+        triggersimu.ProcessEvent(event);
+        events.push_back({ss.str(), event.Reconstructed().DetectorReadHits.size(), triggersimu.GetCBEnergySum()});
+        arena.EndEvent();
+    }
+    REQUIRE(kept != nullptr);
+    REQUIRE(kept->Candidate != nullptr);
+    // the chunks of dropped events are reused, so their number does not grow with the number of events
+    REQUIRE(arena.Chunks() < 5);
+    return events;
+}
+
+void dotest_reconstruct_cache() {
+    tmpfolder_t cachedir;
+    const string rawfile = string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz";
+    auto& setup = ExpConfig::Setup::Get();
+
+    auto make_cache = [&cachedir, &rawfile, &setup] () {
+        return std_ext::make_unique<ReconstructCache>(cachedir.foldername, rawfile,
+                                                      setup.GetName(), vector<string>{},
+                                                      setup.GetCalibrationDataManager());
+    };
+
+    // first run reconstructs and writes the cache
+    vector<cached_event_t> events;
+    {
+        auto cache = make_cache();
+        REQUIRE_FALSE(cache->IsValid());
+        AntReader reader(nullptr, Unpacker::Get(rawfile), std_ext::make_unique<Reconstruct>(), move(cache));
+        events = read_all(reader);
+    }
+    REQUIRE(events.size() == 221);
+    REQUIRE(make_cache()->IsValid());
+
+    // second run reads the same events from the cache
+    vector<cached_event_t> cached_events;
+    {
+        AntReader reader(nullptr, Unpacker::Get(rawfile), std_ext::make_unique<Reconstruct>(), make_cache());
+        REQUIRE((reader.GetFlags() & reader_flag_t::IsSource));
+        cached_events = read_all(reader);
+    }
+    REQUIRE(cached_events.size() == events.size());
+
+    size_t nDetectorReadHits = 0;
+    double CBEnergySum = 0;
+    for(size_t i=0;i<events.size();i++) {
+        INFO("Event " << i);
+        REQUIRE(cached_events[i].Serialized == events[i].Serialized);
+        REQUIRE(cached_events[i].nDetectorReadHits == events[i].nDetectorReadHits);
+        REQUIRE(cached_events[i].CBEnergySum == events[i].CBEnergySum);
+        nDetectorReadHits += events[i].nDetectorReadHits;
+        CBEnergySum += events[i].CBEnergySum;
+    }
+    REQUIRE(nDetectorReadHits > 0);
+    REQUIRE(CBEnergySum > 0);
+}
@@ -15,6 +15,7 @@
 #include "analysis/utils/ParticleTools.h"
 
 #include <iostream>
+#include <algorithm>
 
 using namespace std;
 using namespace ant;
@@ -22,6 +23,8 @@ using namespace ant::analysis;
 using namespace ant::analysis::input;
 
 void dotest(bool, bool, bool);
+void dotest_prepared_event();
+void dotest_prepared_event_order();
 
 TEST_CASE("Fitter: Ideal KinFitter, z vertex fixed, proton measured", "[analysis]") {
     dotest(false, false, false);
@@ -39,6 +42,14 @@ TEST_CASE("Fitter: Ideal KinFitter, z vertex free, proton UNmeasured", "[analysi
     dotest(true, true, false);
 }
 
+TEST_CASE("Fitter: KinFitter with prepared event", "[analysis]") {
+    dotest_prepared_event();
+}
+
+TEST_CASE("Fitter: KinFitter with prepared event independent of order", "[analysis]") {
+    dotest_prepared_event_order();
+}
+
 //TEST_CASE("Fitter: Smeared KinFitter, z vertex fixed, proton measured", "[analysis]") {
 //    dotest(false, false, true);
 //}
@@ -376,3 +387,145 @@ void dotest(bool z_vertex, bool proton_unmeas, bool smeared) {
         CHECK(IM_2g_after.GetRMS() == Approx(0).epsilon(0.01).scale(100));
     }
 }
+
+void dotest_prepared_event() {
+    test::EnsureSetup();
+
+    auto rootfile = make_shared<WrapTFileInput>(string(TEST_BLOBS_DIRECTORY)+"/Pluto_Etap2g.root");
+    PlutoReader reader(rootfile);
+
+    auto model = make_shared<TestUncertaintyModel>(true);
+
+    // same fitter setup, but only one prepares the events
+    utils::KinFitter kinfitter(model, true);
+    kinfitter.SetZVertexSigma(0.0);
+    kinfitter.SetTarget(10.0);
+    utils::KinFitter kinfitter_prepared(model, true);
+    kinfitter_prepared.SetZVertexSigma(0.0);
+    kinfitter_prepared.SetTarget(10.0);
+
+    utils::MCFakeReconstructed mc_fake(true);
+
+    unsigned nEvents = 0;
+    while(nEvents<100) {
+        event_t event;
+        if(!reader.ReadNextEvent(event))
+            break;
+        nEvents++;
+
+        auto mctrue_particles = mc_fake.Get(event.MCTrue());
+        TParticlePtr beam = event.MCTrue().ParticleTree->Get();
+        TParticlePtr proton = mctrue_particles.Get(ParticleTypeDatabase::Proton).front();
+        TParticleList photons = mctrue_particles.Get(ParticleTypeDatabase::Photon);
+
+        kinfitter_prepared.PrepareEvent();
+
+        // several beam energies, as for several tagger hits
+        for(double ebeam : {beam->Ek()-20.0, beam->Ek()+20.0, beam->Ek()}) {
+            const auto res = kinfitter.DoFit(ebeam, proton, photons);
+            const auto res_prepared = kinfitter_prepared.DoFit(ebeam, proton, photons);
+
+            REQUIRE(res_prepared.Status == res.Status);
+            if(res.Status != APLCON::Result_Status_t::Success)
+                continue;
+
+            CHECK(res_prepared.ChiSquare == Approx(res.ChiSquare).epsilon(1e-3).scale(1));
+            CHECK(kinfitter_prepared.GetFittedZVertex() == Approx(kinfitter.GetFittedZVertex()).epsilon(1e-3).scale(1));
+            CHECK(kinfitter_prepared.GetFittedBeamE() == Approx(kinfitter.GetFittedBeamE()).epsilon(1e-3));
+            CHECK(kinfitter_prepared.GetFittedProton()->Ek() == Approx(kinfitter.GetFittedProton()->Ek()).epsilon(1e-3));
+
+            // the unchanged particles are set up the same
+            const auto& fitparticles = kinfitter.GetFitParticles();
+            const auto& fitparticles_prepared = kinfitter_prepared.GetFitParticles();
+            REQUIRE(fitparticles_prepared.size() == fitparticles.size());
+            for(size_t i=0;i<fitparticles.size();i++) {
+                CHECK(fitparticles_prepared[i].Particle == fitparticles[i].Particle);
+                CHECK(fitparticles_prepared[i].GetSigmas_before() == fitparticles[i].GetSigmas_before());
+            }
+        }
+    }
+
+    CHECK(nEvents==100);
+}
+
+void dotest_prepared_event_order() {
+    test::EnsureSetup();
+
+    auto rootfile = make_shared<WrapTFileInput>(string(TEST_BLOBS_DIRECTORY)+"/Pluto_Etap2g.root");
+    PlutoReader reader(rootfile);
+
+    auto model = make_shared<TestUncertaintyModel>(true);
+
+    // both fitters see the same combinations, but in different order
+    utils::KinFitter kinfitter_forward(model, true);
+    kinfitter_forward.SetZVertexSigma(0.0);
+    kinfitter_forward.SetTarget(10.0);
+    utils::KinFitter kinfitter_backward(model, true);
+    kinfitter_backward.SetZVertexSigma(0.0);
+    kinfitter_backward.SetTarget(10.0);
+
+    utils::MCFakeReconstructed mc_fake(true);
+
+    struct result_t {
+        APLCON::Result_Status_t Status;
+        double ChiSquare;
+        double ZVertex;
+        double BeamE;
+    };
+
+    auto fit = [] (utils::KinFitter& kinfitter, double ebeam,
+                   const TParticlePtr& proton, const TParticleList& photons) {
+        const auto res = kinfitter.DoFit(ebeam, proton, photons);
+        return result_t{res.Status, res.ChiSquare, kinfitter.GetFittedZVertex(), kinfitter.GetFittedBeamE()};
+    };
+
+    unsigned nEvents = 0;
+    while(nEvents<100) {
+        event_t event;
+        if(!reader.ReadNextEvent(event))
+            break;
+        nEvents++;
+
+        auto mctrue_particles = mc_fake.Get(event.MCTrue());
+        TParticlePtr beam = event.MCTrue().ParticleTree->Get();
+        TParticlePtr proton = mctrue_particles.Get(ParticleTypeDatabase::Proton).front();
+        TParticleList photons = mctrue_particles.Get(ParticleTypeDatabase::Photon);
+
+        // a second proton candidate, as another proton/photons combination of the event
+        auto proton2 = make_shared<TParticle>(ParticleTypeDatabase::Proton,
+                                              proton->Ek()*1.1, proton->Theta()+0.05, proton->Phi());
+        const TParticleList photons_swapped{photons.at(1), photons.at(0)};
+
+        const vector<pair<TParticlePtr, TParticleList>> combinations{
+            {proton, photons}, {proton2, photons}, {proton, photons_swapped}
+        };
+
+        kinfitter_forward.PrepareEvent();
+        kinfitter_backward.PrepareEvent();
+
+        // several beam energies, as for several tagger hits
+        for(double ebeam : {beam->Ek()-20.0, beam->Ek()+20.0, beam->Ek()}) {
+            vector<result_t> results_forward;
+            for(auto it = combinations.begin(); it != combinations.end(); ++it)
+                results_forward.emplace_back(fit(kinfitter_forward, ebeam, it->first, it->second));
+            vector<result_t> results_backward;
+            for(auto it = combinations.rbegin(); it != combinations.rend(); ++it)
+                results_backward.emplace_back(fit(kinfitter_backward, ebeam, it->first, it->second));
+            reverse(results_backward.begin(), results_backward.end());
+
+            for(size_t i=0;i<combinations.size();i++) {
+                const auto& f = results_forward[i];
+                const auto& b = results_backward[i];
+                REQUIRE(f.Status == b.Status);
+                if(f.Status != APLCON::Result_Status_t::Success)
+                    continue;
+                // same combinations fitted the same way, so exactly the same results
+                CHECK(f.ChiSquare == b.ChiSquare);
+                CHECK(f.ZVertex == b.ZVertex);
+                CHECK(f.BeamE == b.BeamE);
+            }
+        }
+    }
+
+    CHECK(nEvents==100);
+}
@@ -14,12 +14,18 @@ using namespace std;
 using namespace ant;
 using namespace ant::analysis::input;
 void dotest_read();
+void dotest_read_selected();
 
 TEST_CASE("GoatReader: Read some events", "[analysis]") {
     test::EnsureSetup();
     dotest_read();
 }
 
+TEST_CASE("GoatReader: Read selected collections", "[analysis]") {
+    test::EnsureSetup();
+    dotest_read_selected();
+}
+
 void dotest_read() {
     auto inputfiles = make_shared<WrapTFileInput>(string(TEST_BLOBS_DIRECTORY)+"/GoAT_5711_100events.root");
 
@@ -79,4 +85,38 @@ void dotest_read() {
     CHECK(readHitsByDetector[Detector_t::Type_t::TAPSVeto] == 136);
 }
 
+void dotest_read_selected() {
+    auto inputfiles = make_shared<WrapTFileInput>(string(TEST_BLOBS_DIRECTORY)+"/GoAT_5711_100events.root");
+
+    GoatReader reader(inputfiles, GoatReader::collections_t(GoatReader::collection_t::TaggerHits) | GoatReader::collection_t::Trigger);
+
+    REQUIRE((reader.GetFlags() & reader_flag_t::IsSource));
+
+    unsigned nEvents = 0;
+    unsigned nTaggerHits = 0;
+    double SumCBESum = 0;
+
+    while(true) {
+        event_t event;
 
+        if(!reader.ReadNextEvent(event))
+            break;
+
+        REQUIRE(event.HasReconstructed());
+        auto& recon = event.Reconstructed();
+
+        nEvents++;
+        nTaggerHits += recon.TaggerHits.size();
+        SumCBESum += recon.Trigger.CBEnergySum;
+
+        CHECK(recon.Trigger.DAQEventID != 0);
+        CHECK(recon.Candidates.empty());
+        CHECK(recon.Clusters.empty());
+        CHECK(recon.DetectorReadHits.empty());
+    }
+
+    // same as reading everything
+    CHECK(nEvents==100);
+    CHECK(nTaggerHits == 2831);
+    CHECK(SumCBESum/nEvents == Approx(720.344472).epsilon(0.0001));
+}
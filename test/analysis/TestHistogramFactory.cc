@@ -3,6 +3,7 @@
 #include "analysis/plot/HistogramFactory.h"
 #include "base/WrapTFile.h"
 #include "base/tmpfile_t.h"
+#include "base/std_ext/math.h"
 
 #include "TH1D.h"
 #include "TH2D.h"
@@ -17,6 +18,7 @@ using namespace ant::analysis;
 void dotest_make();
 void dotest_nameclash();
 void dotest_numdir();
+void dotest_fasthist();
 
 
 TEST_CASE("HistogramFactory: Make", "[analysis]") {
@@ -32,6 +34,10 @@ TEST_CASE("HistogramFactory: Numbered directories", "[analysis]") {
     dotest_numdir();
 }
 
+TEST_CASE("HistogramFactory: Fast histograms", "[analysis]") {
+    dotest_fasthist();
+}
+
 
 void dotest_make() {
     gDirectory->Clear();
@@ -100,3 +106,112 @@ void dotest_numdir() {
     // back in old dir
     REQUIRE(dynamic_cast<TDirectory*>(gDirectory->FindObject("Test_2")));
 }
+
+void check_same(const TH1& fast, const TH1& root) {
+    REQUIRE(fast.GetNcells() == root.GetNcells());
+    for(int bin=0;bin<root.GetNcells();bin++) {
+        CHECK(fast.GetBinContent(bin) == Approx(root.GetBinContent(bin)));
+        CHECK(fast.GetBinError(bin) == Approx(root.GetBinError(bin)));
+    }
+    CHECK(fast.GetEntries() == root.GetEntries());
+    CHECK(fast.GetSumw2N() == root.GetSumw2N());
+    double stats_fast[TH1::kNstat] = {};
+    double stats_root[TH1::kNstat] = {};
+    fast.GetStats(stats_fast);
+    root.GetStats(stats_root);
+    for(int i=0;i<TH1::kNstat;i++)
+        CHECK(stats_fast[i] == Approx(stats_root[i]));
+}
+
+void dotest_fasthist() {
+    gDirectory->Clear();
+
+    HistogramFactory h("Test");
+
+    auto fast1 = h.makeFastTH1D("fast1", {"x", {10, {-1, 1}}});
+    auto root1 = h.makeTH1D("root1", {"x", {10, {-1, 1}}});
+    auto fast1w = h.makeFastTH1D("fast1w", {"x", {10, {-1, 1}}});
+    auto root1w = h.makeTH1D("root1w", {"x", {10, {-1, 1}}});
+    auto fast2 = h.makeFastTH2D("fast2", {"x", {10, {-1, 1}}}, {"y", {5, {0, 5}}}, "", true);
+    auto root2 = h.makeTH2D("root2", {"x", {10, {-1, 1}}}, {"y", {5, {0, 5}}}, "", true);
+
+    // includes bin edges, under/overflow and NaN
+    const vector<double> xs{-1.5, -1.0, -0.95, -0.2, 0.0, 0.1, 0.33, 0.99, 1.0, 2.0, std_ext::NaN};
+    const vector<double> ys{-1.0, 0.0, 0.5, 1.0, 4.99, 5.0, 2.5, 3.5, 1.5, 0.5, 0.5};
+
+    fast1.Fill(xs);
+    for(auto x : xs)
+        root1->Fill(x);
+
+    // first unweighted, then weighted fills enable Sumw2
+    for(unsigned i=0;i<xs.size();i++) {
+        const double w = i<3 ? 1.0 : 0.5*i;
+        fast1w.Fill(xs[i], w);
+        root1w->Fill(xs[i], w);
+        fast2.Fill(xs[i], ys[i], w);
+        root2->Fill(xs[i], ys[i], w);
+    }
+
+    // nothing there before flush
+    CHECK(fast1.Get()->GetEntries() == 0);
+
+    FastHist::FlushAll();
+
+    check_same(*fast1.Get(), *root1);
+    check_same(*fast1w.Get(), *root1w);
+    check_same(*fast2.Get(), *root2);
+
+    // flushing again adds the new fills only
+    fast1.Fill(0.5);
+    root1->Fill(0.5);
+    fast1.Flush();
+    FastHist::FlushAll();
+    check_same(*fast1.Get(), *root1);
+
+    REQUIRE_THROWS_AS(FastTH1D(h.makeTH1D("var", "", "", VarBinSettings({0,1,3}))), FastHist::Exception);
+
+    // weighted fills after a flush of unit weight fills, flushed twice
+    {
+        auto fast = h.makeFastTH1D("fast_flushes", {"x", {10, {-1, 1}}});
+        auto root = h.makeTH1D("root_flushes", {"x", {10, {-1, 1}}});
+        for(auto x : xs) {
+            fast.Fill(x);
+            root->Fill(x);
+        }
+        fast.Flush();
+        check_same(*fast.Get(), *root);
+        for(unsigned i=0;i<xs.size();i++) {
+            fast.Fill(xs[i], 0.5*i);
+            root->Fill(xs[i], 0.5*i);
+        }
+        fast.Flush();
+        check_same(*fast.Get(), *root);
+        for(unsigned i=0;i<xs.size();i++) {
+            fast.Fill(xs[i], 2.0+i);
+            root->Fill(xs[i], 2.0+i);
+        }
+        fast.Flush();
+        check_same(*fast.Get(), *root);
+    }
+
+    // the last handle flushes
+    TH1D* root_handle = nullptr;
+    {
+        auto fast = h.makeFastTH1D("fast_handle", {"x", {10, {-1, 1}}});
+        root_handle = fast.Get();
+        auto copy = fast;
+        copy.Fill(0.5, 2.0);
+    }
+    CHECK(root_handle->GetEntries() == 1);
+    CHECK(root_handle->GetBinContent(root_handle->FindBin(0.5)) == 2.0);
+
+    // histograms deleted by ROOT are detached from the handle
+    {
+        auto fast = h.makeFastTH1D("fast_deleted", {"x", {10, {-1, 1}}});
+        fast.Fill(0.5);
+        delete fast.Get();
+        fast.Fill(0.5);
+        REQUIRE_NOTHROW(FastHist::FlushAll());
+        REQUIRE_NOTHROW(fast.Flush());
+    }
+}
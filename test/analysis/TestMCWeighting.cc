@@ -0,0 +1,220 @@
+#include "catch.hpp"
+
+#include "tmpfile_t.h"
+
+#include "analysis/utils/MCWeighting.h"
+
+#include "base/WrapTFile.h"
+#include "base/Tree.h"
+#include "tree/TParticle.h"
+
+#include "TTree.h"
+#include "TChain.h"
+#include "TH1D.h"
+
+// the previous implementation used ROOT's GSL wrapper
+#include "Math/SpecFuncMathMore.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+using namespace ant::analysis::utils;
+
+void dotest_getn(const MCWeighting::item_t& item);
+void dotest_normalization();
+
+TEST_CASE("MCWeighting: GetN EtaPrime", "[analysis]") {
+    dotest_getn(MCWeighting::EtaPrime);
+}
+
+TEST_CASE("MCWeighting: GetN Omega", "[analysis]") {
+    dotest_getn(MCWeighting::Omega);
+}
+
+TEST_CASE("MCWeighting: GetN Pi0", "[analysis]") {
+    dotest_getn(MCWeighting::Pi0);
+}
+
+TEST_CASE("MCWeighting: GetN Eta", "[analysis]") {
+    dotest_getn(MCWeighting::Eta);
+}
+
+TEST_CASE("MCWeighting: Normalization of chained files", "[analysis]") {
+    dotest_normalization();
+}
+
+// the GSL based implementation before the coefficients were tabulated
+double GetN_gsl(const MCWeighting::item_t& item, const double beamE, const double cosTheta)
+{
+    const auto& db = item.Database;
+    auto it_coeff_hi = db.begin();
+    while(it_coeff_hi != db.end() && it_coeff_hi->BeamE.Center() <= beamE)
+        ++it_coeff_hi;
+
+    if(it_coeff_hi == db.begin())
+        it_coeff_hi = std::next(db.begin());
+    else if(it_coeff_hi == db.end())
+        it_coeff_hi = std::prev(it_coeff_hi);
+
+    auto it_coeff_lo = std::prev(it_coeff_hi);
+
+    auto get_N = [cosTheta] (const vector<double>& coeffs) {
+        double sum = 0;
+        for(auto l=0u;l<coeffs.size();l++)
+            sum += coeffs[l]*ROOT::Math::legendre(l, cosTheta);
+        return sum;
+    };
+
+    const double beamE_lo = it_coeff_lo->BeamE.Center();
+    const double beamE_hi = it_coeff_hi->BeamE.Center();
+    const double N_lo = get_N(it_coeff_lo->LegendreCoefficients);
+    const double N_hi = get_N(it_coeff_hi->LegendreCoefficients);
+
+    const double m = (N_hi - N_lo)/(beamE_hi - beamE_lo);
+    return N_lo + m*(beamE - beamE_lo);
+}
+
+void dotest_getn(const MCWeighting::item_t& item)
+{
+    MCWeighting mcWeighting(HistogramFactory("MCWeighting"), item);
+
+    const auto& db = item.Database;
+    // include the extrapolation below and above the database
+    const double beamE_min = db.front().BeamE.Start() - 100;
+    const double beamE_max = db.back().BeamE.Stop() + 100;
+
+    unsigned n = 0;
+    for(double beamE = beamE_min; beamE <= beamE_max; beamE += 1.7) {
+        for(double cosTheta = -1.0; cosTheta <= 1.0; cosTheta += 0.05) {
+            const double expected = GetN_gsl(item, beamE, cosTheta);
+            INFO("beamE=" << beamE << " cosTheta=" << cosTheta);
+            REQUIRE(mcWeighting.GetN(beamE, cosTheta) == Approx(expected).epsilon(1e-10).margin(1e-12));
+            n++;
+        }
+    }
+    REQUIRE(n > 1000);
+
+    // exactly at the bin centers
+    for(auto& c : db)
+        REQUIRE(mcWeighting.GetN(c.BeamE.Center(), 0.3) == Approx(GetN_gsl(item, c.BeamE.Center(), 0.3)));
+}
+
+void dotest_normalization()
+{
+    tmpfolder_t tmpfolder;
+    tmpfile_t tmpfile1(tmpfolder, ".root");
+    tmpfile_t tmpfile2(tmpfolder, ".root");
+
+    // events with the meson produced at the given beam energies,
+    // or without the meson for NaN
+    auto make_tree = [] (double beamE) {
+        const auto& meson_type = std::isnan(beamE) ? ParticleTypeDatabase::Pi0 : ParticleTypeDatabase::EtaPrime;
+        if(std::isnan(beamE))
+            beamE = 1500;
+        auto beam = make_shared<TParticle>(ParticleTypeDatabase::BeamTarget,
+                                           LorentzVec({0, 0, beamE}, beamE + ParticleTypeDatabase::Proton.Mass()));
+        auto tree = Tree<TParticlePtr>::MakeNode(beam);
+        tree->CreateDaughter(make_shared<TParticle>(meson_type, 200.0, 0.5, 0.0));
+        tree->CreateDaughter(make_shared<TParticle>(ParticleTypeDatabase::Proton, 100.0, 0.3, 3.0));
+        return tree;
+    };
+
+    // written by MCWeighting::Finish(), the sums are next to the tree
+    auto write = [make_tree] (const string& filename, const vector<double>& beamEs) {
+        WrapTFileOutput outputfile(filename, true);
+        MCWeighting mcWeighting(HistogramFactory("Test"), MCWeighting::EtaPrime);
+        for(auto beamE : beamEs) {
+            mcWeighting.SetParticleTree(make_tree(beamE));
+            mcWeighting.Fill();
+        }
+        mcWeighting.Finish();
+    };
+
+    write(tmpfile1.filename, {1450.0, 1550.0, std_ext::NaN});
+    write(tmpfile2.filename, {1500.0, 1600.0});
+
+    // the raw weights as stored
+    auto read_raw = [] (const string& filename) {
+        WrapTFileInput inputfile(filename);
+        MCWeighting::tree_t t;
+        REQUIRE(inputfile.GetObject("Test/"+MCWeighting::treeName, t.Tree));
+        REQUIRE_NOTHROW(t.LinkBranches());
+        vector<double> raw;
+        for(Long64_t entry=0;entry<t.Tree->GetEntries();entry++) {
+            t.Tree->GetEntry(entry);
+            raw.push_back(t.MCWeightRaw);
+        }
+        return raw;
+    };
+    const auto raw1 = read_raw(tmpfile1.filename);
+    const auto raw2 = read_raw(tmpfile2.filename);
+    REQUIRE(raw1.size() == 3);
+    REQUIRE(raw2.size() == 2);
+    REQUIRE(std::isnan(raw1[2]));
+    for(auto N : {raw1[0], raw1[1], raw2[0], raw2[1]})
+        REQUIRE(N > 0);
+
+    // single file
+    {
+        WrapTFileInput inputfile(tmpfile2.filename);
+        MCWeighting::tree_t t;
+        REQUIRE(inputfile.GetObject("Test/"+MCWeighting::treeName, t.Tree));
+        REQUIRE_NOTHROW(t.LinkBranches());
+        REQUIRE_NOTHROW(t.ReadNormalization());
+        const double normalization = 2.0/(raw2[0]+raw2[1]);
+        REQUIRE(t.Normalization == Approx(normalization));
+        t.Tree->GetEntry(1);
+        REQUIRE(t.GetWeight() == Approx(raw2[1]*normalization));
+    }
+
+    // chained files, as after hadd
+    {
+        TChain chain(("Test/"+MCWeighting::treeName).c_str());
+        chain.Add(tmpfile1.filename.c_str());
+        chain.Add(tmpfile2.filename.c_str());
+
+        MCWeighting::tree_t t;
+        REQUIRE_NOTHROW(t.LinkBranches(&chain));
+        REQUIRE_NOTHROW(t.ReadNormalization());
+        const double normalization = 4.0/(raw1[0]+raw1[1]+raw2[0]+raw2[1]);
+        REQUIRE(t.Normalization == Approx(normalization));
+
+        REQUIRE(t.Tree->GetEntries() == 5);
+        double sum = 0;
+        for(Long64_t entry=0;entry<t.Tree->GetEntries();entry++) {
+            t.Tree->GetEntry(entry);
+            sum += t.GetWeight();
+        }
+        // normalized weights sum up to the number of weighted events,
+        // the event without meson has weight 1
+        REQUIRE(sum == Approx(4.0 + 1.0));
+
+        // the alias uses the same check for events without meson
+        TTree host("host", "");
+        host.AddFriend(t.Tree);
+        t.SetAlias(&host);
+        REQUIRE(string(host.GetAlias("MCWeight")).find("MCWeightRaw==MCWeightRaw") != string::npos);
+    }
+
+    // older files only provide the normalized weight
+    {
+        struct old_t : WrapTTree {
+            ADD_BRANCH_T(double, MCWeight)
+        };
+        tmpfile_t tmpfile3(tmpfolder, ".root");
+        {
+            WrapTFileOutput outputfile(tmpfile3.filename);
+            old_t t;
+            t.CreateBranches(outputfile.CreateInside<TTree>(MCWeighting::treeName.c_str(), ""));
+            t.MCWeight = 0.5;
+            t.Tree->Fill();
+        }
+        WrapTFileInput inputfile(tmpfile3.filename);
+        MCWeighting::tree_t t;
+        REQUIRE(inputfile.GetObject(MCWeighting::treeName, t.Tree));
+        REQUIRE_NOTHROW(t.LinkBranches());
+        REQUIRE_NOTHROW(t.ReadNormalization());
+        t.Tree->GetEntry(0);
+        REQUIRE(t.GetWeight() == 0.5);
+    }
+}
@@ -9,6 +9,9 @@
 #include <vector>
 #include <iostream>
 #include <cassert>
+#include <random>
+#include <chrono>
+#include <functional>
 #include "analysis/utils/Matcher.h"
 
 
@@ -75,3 +78,164 @@ TEST_CASE("Matcher2: va < vb", "[analysis]") {
 
     test_matcher2(va, vb, exp);
 }
+
+TEST_CASE("AssignmentMatcher: Greedy same as match1to1", "[analysis]") {
+    const vector<int> va = { 30, 40, 10, 20, 25 };
+    const vector<int> vb = { 11, 22, 34, 39, 28 };
+    auto f = [] (const int a, const int b) { return abs(a - b);};
+
+    const auto expected = utils::match1to1(va, vb, f, IntervalD(0, 6));
+
+    utils::AssignmentMatcher matcher(utils::AssignmentMatcher::mode_t::Greedy, IntervalD(0, 6));
+    const auto res = matcher.Match(va, vb, f);
+
+    REQUIRE(res.size() == expected.size());
+    auto it = expected.begin();
+    for(const auto& m : res) {
+        CHECK(m.a == it->a);
+        CHECK(m.b == it->b);
+        CHECK(m.score == it->score);
+        ++it;
+    }
+
+    CHECK(utils::FindMatched(res, 30) == 28);
+    CHECK(utils::FindUnmatched(res, vb) == utils::FindUnmatched(expected, vb));
+
+    // reused output keeps its storage
+    vector<utils::scored_match<int,int>> matches;
+    matcher.Match(va, vb, f, matches);
+    REQUIRE(matches.size() == res.size());
+    const auto data = matches.data();
+    matcher.Match(va, vb, f, matches);
+    CHECK(matches.data() == data);
+    for(size_t i=0;i<res.size();i++) {
+        CHECK(matches[i].a == res[i].a);
+        CHECK(matches[i].b == res[i].b);
+    }
+}
+
+TEST_CASE("AssignmentMatcher: Infinite scores", "[analysis]") {
+    const vector<double> va = { 1, 2 };
+    const vector<double> vb = { 1, 5 };
+    // the second element of va can only be matched with an infinite score
+    auto f = [] (const double a, const double b) {
+        return a == 2 ? std_ext::inf : std::abs(a - b);
+    };
+
+    // greedy accepts them like match1to1
+    const auto expected = utils::match1to1(va, vb, f);
+    REQUIRE(expected.size() == 2);
+    utils::AssignmentMatcher greedy(utils::AssignmentMatcher::mode_t::Greedy);
+    const auto res = greedy.Match(va, vb, f);
+    REQUIRE(res.size() == expected.size());
+    CHECK(res.back().a == 2);
+    CHECK(res.back().score == std_ext::inf);
+
+    // optimal never matches them
+    utils::AssignmentMatcher optimal(utils::AssignmentMatcher::mode_t::Optimal);
+    const auto& res_optimal = optimal.MatchIndices(va, vb, f);
+    REQUIRE(res_optimal.size() == 1);
+    CHECK(res_optimal.front().a == 0);
+}
+
+TEST_CASE("AssignmentMatcher: Optimal beats Greedy", "[analysis]") {
+    // greedy takes 10-11 first and leaves 0 unmatched,
+    // optimal matches 10-20 and 0-11 instead
+    const vector<int> va = { 10, 0 };
+    const vector<int> vb = { 11, 20 };
+    auto f = [] (const int a, const int b) { return abs(a - b);};
+    const IntervalD window(0, 12);
+
+    utils::AssignmentMatcher greedy(utils::AssignmentMatcher::mode_t::Greedy, window);
+    REQUIRE(greedy.MatchIndices(va, vb, f).size() == 1);
+
+    utils::AssignmentMatcher optimal(utils::AssignmentMatcher::mode_t::Optimal, window);
+    const auto& res = optimal.MatchIndices(va, vb, f);
+    REQUIRE(res.size() == 2);
+    CHECK(res.at(0).a == 0);
+    CHECK(res.at(0).b == 1);
+    CHECK(res.at(1).a == 1);
+    CHECK(res.at(1).b == 0);
+}
+
+TEST_CASE("AssignmentMatcher: Optimal minimal sum", "[analysis]") {
+    auto f = [] (const vector<double>& a, size_t j) { return a.at(j);};
+
+    // rows are the cost matrix, list2 the column indices
+    const vector<vector<double>> costs = {
+        {4, 1, 3},
+        {2, 0, 5},
+        {3, 2, 2}
+    };
+    const vector<size_t> cols = {0, 1, 2};
+
+    utils::AssignmentMatcher matcher;
+    const auto& res = matcher.MatchIndices(costs, cols, f);
+    REQUIRE(res.size() == 3);
+    double sum = 0;
+    for(const auto& m : res)
+        sum += m.score;
+    CHECK(sum == 5);
+
+    // transposed problem with more rows than columns
+    const vector<vector<double>> costs_t = {
+        {4, 2},
+        {1, 0},
+        {6, 5}
+    };
+    const vector<size_t> cols_t = {0, 1};
+    const auto& res_t = matcher.MatchIndices(costs_t, cols_t, f);
+    REQUIRE(res_t.size() == 2);
+    CHECK(res_t.at(0).a == 1);
+    CHECK(res_t.at(0).b == 0);
+    CHECK(res_t.at(1).a == 0);
+    CHECK(res_t.at(1).b == 1);
+}
+
+TEST_CASE("AssignmentMatcher: Benchmark", "[.][analysis][benchmark]") {
+    // realistic multiplicities: up to 10 true particles vs. up to 15 candidates
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> angle(0, 3.14);
+    const IntervalD window(0, std_ext::degree_to_radian(15.0));
+    auto f = [] (double a, double b) { return std::abs(a - b);};
+
+    std::vector<std::vector<double>> events_a, events_b;
+    for(int n=0;n<100000;n++) {
+        events_a.emplace_back(2 + n % 9);
+        events_b.emplace_back(3 + n % 13);
+        for(auto& a : events_a.back())
+            a = angle(rng);
+        for(auto& b : events_b.back())
+            b = angle(rng);
+    }
+
+    auto run = [&events_a, &events_b] (const string& name, std::function<size_t(size_t)> match) {
+        size_t n_matched = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for(size_t i=0;i<events_a.size();i++)
+            n_matched += match(i);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        cout << name << ": " << events_a.size()/elapsed.count() << " events/s, "
+             << n_matched << " matched" << endl;
+    };
+
+    run("match1to1", [&] (size_t i) {
+        return utils::match1to1(events_a[i], events_b[i], f, window).size();
+    });
+
+    utils::AssignmentMatcher greedy(utils::AssignmentMatcher::mode_t::Greedy, window);
+    run("AssignmentMatcher Greedy", [&] (size_t i) {
+        return greedy.MatchIndices(events_a[i], events_b[i], f).size();
+    });
+
+    utils::AssignmentMatcher optimal(utils::AssignmentMatcher::mode_t::Optimal, window);
+    run("AssignmentMatcher Optimal", [&] (size_t i) {
+        return optimal.MatchIndices(events_a[i], events_b[i], f).size();
+    });
+
+    std::vector<utils::scored_match<double,double>> matches;
+    run("AssignmentMatcher Optimal Match", [&] (size_t i) {
+        optimal.Match(events_a[i], events_b[i], f, matches);
+        return matches.size();
+    });
+}
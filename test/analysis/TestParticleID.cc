@@ -3,11 +3,14 @@
 #include "base/ParticleType.h"
 #include "analysis/utils/ParticleID.h"
 #include "analysis/utils/RootAddons.h"
+#include "base/std_ext/math.h"
 
 #include "TCutG.h"
 
 #include <cassert>
 #include <iostream>
+#include <random>
+#include <cmath>
 
 
 using namespace std;
@@ -35,6 +38,7 @@ void test_electoncut();
 void test_electonantprotoncut();
 void test_tof();
 void test_tofdee();
+void test_rasterized();
 
 
 struct testdata {
@@ -75,6 +79,10 @@ TEST_CASE("ParticleID: tof + dEE cut", "[analysis]") {
     test_tofdee();
 }
 
+TEST_CASE("ParticleID: rasterized cuts", "[analysis]") {
+    test_rasterized();
+}
+
 void test_makeTCutG() {
     auto cut = root::makeTCutG("a", {{1,1},{3,1},{3,3},{1,3}});
     REQUIRE(cut->IsInside(2,2));
@@ -155,6 +163,68 @@ void test_tofdee() {
 }
 
 
+void test_rasterized() {
+
+    // compare with exact test, also close to the polygon
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist_x(0, 400);
+    std::uniform_real_distribution<double> dist_y(0, 20);
+    for(auto cut : {data.dEE_electron, data.dEE_proton, data.tofcut}) {
+        for(unsigned resolution : {1u, 7u, 64u, 512u}) {
+            RasterizedCut raster(cut, resolution, resolution);
+            for(int i=0;i<10000;i++) {
+                const double x = dist_x(rng);
+                const double y = i % 2 ? dist_y(rng) : std::round(dist_y(rng)*2)/2;
+                REQUIRE(raster.IsInside(x, y) == static_cast<bool>(cut->IsInside(x, y)));
+            }
+            for(int i=0;i<cut->GetN();i++) {
+                const double x = cut->GetX()[i];
+                const double y = cut->GetY()[i];
+                REQUIRE(raster.IsInside(x, y) == static_cast<bool>(cut->IsInside(x, y)));
+            }
+            REQUIRE_FALSE(raster.IsInside(std_ext::NaN, 1.0));
+        }
+    }
+
+    BasicParticleID pid;
+    pid.dEE_electron = data.dEE_electron;
+    pid.dEE_proton = data.dEE_proton;
+    pid.tof = data.tofcut;
+    pid.Rasterize(128);
+    REQUIRE(pid.Identify(data.gamma)   == &ParticleTypeDatabase::Photon);
+    REQUIRE(pid.Identify(data.proton)  == &ParticleTypeDatabase::Proton);
+    REQUIRE(pid.Identify(data.neutron) == &ParticleTypeDatabase::Neutron);
+    REQUIRE(pid.Identify(data.electron)== &ParticleTypeDatabase::eCharged);
+
+    // cuts changed in place need to be rasterized again
+    {
+        BasicParticleID pid_changed;
+        pid_changed.dEE_proton = root::makeTCutG("proton3",{{50,4},{300,4},{51,16}});
+        pid_changed.Rasterize(128);
+        REQUIRE(pid_changed.Identify(data.proton) == &ParticleTypeDatabase::Proton);
+        pid_changed.dEE_proton->SetPoint(2, 300, 5);
+        pid_changed.Rasterize(128);
+        REQUIRE(pid_changed.Identify(data.proton) == nullptr);
+    }
+
+    // replaced cuts are tested exactly
+    pid.tof = nullptr;
+    pid.dEE_proton = root::makeTCutG("proton2",{{200,4},{300,4},{250,16}});
+    REQUIRE(pid.Identify(data.proton)  == nullptr);
+    REQUIRE(pid.Identify(data.neutron) == &ParticleTypeDatabase::Photon);
+
+    // identify whole list at once
+    TCandidateList cands;
+    cands.emplace_back(*data.gamma);
+    cands.emplace_back(*data.electron);
+    cands.emplace_back(*data.proton);
+    ParticleID::types_t types;
+    pid.Identify(cands, types);
+    REQUIRE(types.size() == 3);
+    CHECK(types[0] == &ParticleTypeDatabase::Photon);
+    CHECK(types[1] == &ParticleTypeDatabase::eCharged);
+    CHECK(types[2] == nullptr);
+}
 
 
 testdata::testdata()
@@ -0,0 +1,72 @@
+#include "catch.hpp"
+#include "catch_config.h"
+
+#include "analysis/utils/ParticlePairs.h"
+#include "base/ParticleType.h"
+#include "base/std_ext/math.h"
+
+#include <memory>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+
+TEST_CASE("ParticlePairs: Candidate direction", "[analysis]") {
+    auto candptr = make_shared<TCandidate>(Detector_t::Any_t::CB_Apparatus, 100.0, 1.2, -2.1, 0.0, 3, 0.0, 0.0, TClusterList{});
+    auto& cand = *candptr;
+    const vec3 expected = vec3::RThetaPhi(1.0, 1.2, -2.1);
+    CHECK(cand.Direction.x == Approx(expected.x));
+    CHECK(cand.Direction.y == Approx(expected.y));
+    CHECK(cand.Direction.z == Approx(expected.z));
+
+    cand.Theta = 0.3;
+    cand.UpdateDirection();
+    CHECK(cand.Direction.Theta() == Approx(0.3));
+    CHECK(cand.Direction.Phi() == Approx(-2.1));
+
+    const TParticle p(ParticleTypeDatabase::Proton, candptr);
+    const TParticle p_ref(ParticleTypeDatabase::Proton, cand.CaloEnergy, cand.Theta, cand.Phi);
+    CHECK(p.E == Approx(p_ref.E));
+    CHECK(p.Theta() == Approx(p_ref.Theta()));
+    CHECK(p.Phi() == Approx(p_ref.Phi()));
+    CHECK(p.P() == Approx(p_ref.P()));
+}
+
+TEST_CASE("ParticlePairs: Matrix", "[analysis]") {
+    TCandidateList cands;
+    cands.emplace_back(Detector_t::Any_t::CB_Apparatus, 150.0, 0.5, 0.2, 0.0, 3, 0.0, 0.0, TClusterList{});
+    cands.emplace_back(Detector_t::Any_t::CB_Apparatus,  80.0, 1.5, 2.9, 0.0, 3, 0.0, 0.0, TClusterList{});
+    cands.emplace_back(Detector_t::Any_t::TAPS_Apparatus, 300.0, 0.1, -1.0, 0.0, 3, 0.0, 0.0, TClusterList{});
+
+    utils::ParticlePairs pairs;
+    pairs.SetPhotons(cands);
+    REQUIRE(pairs.Size() == 3);
+
+    TParticleList photons;
+    for(auto c : cands.get_ptr_list())
+        photons.emplace_back(make_shared<TParticle>(ParticleTypeDatabase::Photon, c));
+
+    for(unsigned i=0;i<3;i++) {
+        CHECK(pairs.IM(i,i) == Approx(0.0));
+        CHECK(pairs.OpeningAngle(i,i) == 0.0);
+        for(unsigned j=0;j<3;j++) {
+            if(i==j)
+                continue;
+            CHECK(pairs.IM(i,j) == Approx((*photons[i] + *photons[j]).M()));
+            CHECK(pairs.OpeningAngle(i,j) == Approx(photons[i]->Angle(*photons[j])));
+            CHECK(pairs.IM(i,j) == pairs.IM(j,i));
+        }
+    }
+
+    // same from the particles
+    utils::ParticlePairs pairs_particles;
+    pairs_particles.Set(photons);
+    REQUIRE(pairs_particles.Size() == 3);
+    CHECK(pairs_particles.IM(0,2) == Approx(pairs.IM(0,2)));
+    CHECK(pairs_particles.OpeningAngle(1,2) == Approx(pairs.OpeningAngle(1,2)));
+
+    // buffers are reused
+    pairs.Set(vector<LorentzVec>{LorentzVec::AtRest(ParticleTypeDatabase::Pi0.Mass())});
+    REQUIRE(pairs.Size() == 1);
+    CHECK(pairs.IM(0,0) == Approx(ParticleTypeDatabase::Pi0.Mass()));
+}
@@ -0,0 +1,89 @@
+#include "catch.hpp"
+
+#include "analysis/plot/PromptRandomHist.h"
+#include "base/std_ext/math.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+
+void dotest_select(bool sorted, bool nan_inside = false);
+
+TEST_CASE("PromptRandom: Select sorted", "[analysis]") {
+    dotest_select(true);
+}
+
+TEST_CASE("PromptRandom: Select unsorted", "[analysis]") {
+    dotest_select(false);
+}
+
+TEST_CASE("PromptRandom: Select sorted with NaN inside", "[analysis]") {
+    dotest_select(true, true);
+}
+
+void dotest_select(bool sorted, bool nan_inside) {
+    PromptRandom::Switch promptrandom;
+    promptrandom.AddPromptRange({-2.5, 2.5});
+    promptrandom.AddRandomRange({-50, -10});
+    promptrandom.AddRandomRange({  10, 50});
+    // overlaps with prompt, random has precedence
+    promptrandom.AddRandomRange({ 2, 3});
+
+    const double offset = 4.0;
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist(-100, 100);
+    vector<TTaggerHit> taggerhits;
+    for(unsigned i=0;i<1000;i++)
+        taggerhits.emplace_back(i % 47, 1000.0, dist(rng) + offset);
+    // hits exactly at the window boundaries and without time
+    for(double t : {-50.0, -10.0, -2.5, 2.5, 3.0, 10.0, 50.0})
+        taggerhits.emplace_back(0, 1000.0, t + offset);
+    taggerhits.emplace_back(0, 1000.0, std_ext::NaN);
+
+    if(sorted) {
+        stable_sort(taggerhits.begin(), taggerhits.end(), [] (const TTaggerHit& a, const TTaggerHit& b) {
+            return a.Time < b.Time || (!std::isnan(a.Time) && std::isnan(b.Time));
+        });
+    }
+    if(nan_inside) {
+        // a hit without time before the prompt window must not hide the later hits
+        const auto it = find_if(taggerhits.begin(), taggerhits.end(), [offset] (const TTaggerHit& h) {
+            return h.Time - offset > -5.0;
+        });
+        REQUIRE(it != taggerhits.end());
+        taggerhits.emplace(it, 0, 1000.0, std_ext::NaN);
+    }
+
+    const auto corrected_time = [offset] (const TTaggerHit& h) { return h.Time - offset; };
+    const auto selected = promptrandom.Select(taggerhits, corrected_time);
+
+    // compare to searching the windows for each hit
+    unsigned n_selected = 0;
+    auto it_selected = selected.begin();
+    for(const auto& taggerhit : taggerhits) {
+        promptrandom.SetTaggerTime(taggerhit.Time - offset);
+        if(promptrandom.State() == PromptRandom::Case::Outside)
+            continue;
+        REQUIRE(it_selected != selected.end());
+        CHECK(it_selected->Hit == addressof(taggerhit));
+        CHECK(it_selected->CorrectedTime == Approx(taggerhit.Time - offset));
+        CHECK(it_selected->State == promptrandom.State());
+        CHECK(it_selected->FillWeight == Approx(promptrandom.FillWeight()));
+
+        const auto fillweight = promptrandom.FillWeight();
+        promptrandom.SetTaggerHit(*it_selected);
+        CHECK(promptrandom.FillWeight() == Approx(fillweight));
+        ++it_selected;
+        ++n_selected;
+    }
+    CHECK(it_selected == selected.end());
+    CHECK(n_selected > 0);
+
+    // the default switch has no windows at all
+    PromptRandom::Switch empty;
+    CHECK(empty.Select(taggerhits).empty());
+}
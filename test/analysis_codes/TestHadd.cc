@@ -4,8 +4,13 @@
 #include "base/WrapTFile.h"
 #include "base/tmpfile_t.h"
 #include "base/std_ext/memory.h"
+#include "base/std_ext/system.h"
 
 #include "TH1D.h"
+#include "TH2D.h"
+
+#include <cmath>
+#include <list>
 
 using namespace std;
 using namespace ant;
@@ -104,4 +109,66 @@ TEST_CASE("Hadd: Two simple hists", "[root-addons]") {
         }
     }
 
-}
\ No newline at end of file
+}
+TEST_CASE("Hadd: Merge files in groups", "[root-addons]") {
+
+    // each input file has the same hists, filled differently
+    const unsigned nFiles = 5;
+    vector<tmpfile_t> in_files(nFiles);
+    vector<string> filenames;
+    for(unsigned i=0;i<nFiles;i++) {
+        WrapTFileOutput out(in_files[i].filename);
+        {
+            auto h = out.CreateInside<TH1D>("h","",100,0,1);
+            h->Sumw2();
+            h->Fill(0.0, i+1.0);
+        }
+        {
+            auto h = out.CreateInside<TH2D>("h2","",10,0,1,20,0,2);
+            h->Fill(0.5, 1.5);
+            h->Fill(0.5, 1.5);
+        }
+        {
+            auto h = out.CreateInside<TH1D>("h_lbl","",1,0,1);
+            h->Fill("a", 1.0);
+        }
+        filenames.push_back(in_files[i].filename);
+    }
+
+    // at most two open files, three levels of merging
+    for(unsigned nWorkers : {1u, 2u}) {
+        // the intermediate files are placed next to the output and removed afterwards
+        tmpfolder_t tmp_outfolder;
+        tmpfile_t tmp_outfile(tmp_outfolder, ".root");
+        {
+            auto outputfile = std_ext::make_unique<TFile>(tmp_outfile.filename.c_str(), "RECREATE");
+            unsigned nPaths = 0;
+            hadd::MergeFiles(*outputfile, filenames, nPaths, 2, nWorkers);
+            outputfile->Write();
+            CHECK(nPaths == 1);
+            CHECK(std_ext::system::lsFiles(tmp_outfolder.foldername, "", true) == list<string>{tmp_outfile.filename});
+        }
+
+        WrapTFileInput input(tmp_outfile.filename);
+        {
+            auto h = input.GetSharedHist<TH1D>("h");
+            CHECK(h->GetBinContent(1) == Approx(15.0));
+            CHECK(h->GetBinError(1) == Approx(sqrt(55.0)));
+            CHECK(h->GetEntries() == Approx(nFiles));
+        }
+        {
+            auto h = input.GetSharedHist<TH2D>("h2");
+            CHECK(h->GetBinContent(h->FindBin(0.5, 1.5)) == Approx(2.0*nFiles));
+            CHECK(h->GetEntries() == Approx(2.0*nFiles));
+            CHECK(h->GetMean(2) == Approx(1.5));
+        }
+        {
+            auto h = input.GetSharedHist<TH1D>("h_lbl");
+            CHECK(h->GetBinContent(h->GetXaxis()->FindBin("a")) == Approx(nFiles));
+        }
+    }
+
+    TDirectory* dir = gDirectory;
+    unsigned nPaths = 0;
+    CHECK_THROWS_AS(hadd::MergeFiles(*dir, filenames, nPaths, 1), std::runtime_error);
+}
@@ -0,0 +1,86 @@
+#include "catch.hpp"
+
+#include "root-addons/analysis_codes/TreeTools.h"
+
+#include "TTree.h"
+#include "TCut.h"
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TH3D.h"
+#include "TDirectory.h"
+
+#include <vector>
+#include <memory>
+#include <random>
+
+using namespace std;
+using namespace ant;
+
+unique_ptr<TTree> makeTree() {
+    auto tree = unique_ptr<TTree>(new TTree("tree","tree"));
+    tree->SetDirectory(nullptr);
+    double E;
+    int Element;
+    vector<double> Theta;
+    tree->Branch("E", &E);
+    tree->Branch("Element", &Element);
+    tree->Branch("Theta", &Theta);
+
+    std::mt19937 rng(123);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    for(int i=0;i<5000;i++) {
+        E = 1000*uniform(rng);
+        Element = i % 20;
+        Theta.resize(i % 4);
+        for(auto& t : Theta)
+            t = 3.14*uniform(rng);
+        tree->Fill();
+    }
+    return tree;
+}
+
+void compare(TH1* a, TH1* b) {
+    REQUIRE(a->GetNcells() == b->GetNcells());
+    for(int i=0;i<a->GetNcells();i++)
+        CHECK(a->GetBinContent(i) == Approx(b->GetBinContent(i)));
+}
+
+TEST_CASE("TreeDrawer: SplitFormula", "[root-addons]") {
+    CHECK(TreeDrawer::SplitFormula("E") == vector<string>({"E"}));
+    CHECK(TreeDrawer::SplitFormula("E:Element") == vector<string>({"Element","E"}));
+    CHECK(TreeDrawer::SplitFormula("Theta*TMath::RadToDeg():tE:Element") ==
+          vector<string>({"Element","tE","Theta*TMath::RadToDeg()"}));
+}
+
+TEST_CASE("TreeDrawer: Same as TTree::Draw", "[root-addons]") {
+    auto tree = makeTree();
+
+    TreeDrawer drawer(tree.get());
+    auto h1 = drawer.Add("E", TCut("Element<10"), "E", "", BinSettings(100,0,1000), "treedrawer_h1");
+    auto h2 = drawer.Add("E:Element", TCut(""), "Element", "E", BinSettings(20,0,20), BinSettings(10,0,1000), "treedrawer_h2");
+    auto h3 = drawer.Add("Theta:E:Element", TCut("Theta>1"), BinSettings(20,0,20), BinSettings(10,0,1000), BinSettings(10,0,3.2), "treedrawer_h3");
+    auto h4 = drawer.Add("Theta", TCut("E/1000"), "", "", BinSettings(32,0,3.2), "treedrawer_h4");
+    CHECK_THROWS_AS(drawer.Add("E:Element", TCut(""), "", "", BinSettings(10), "treedrawer_wrong"), std::runtime_error);
+
+    REQUIRE(drawer.Run() == tree->GetEntries());
+
+    auto r1 = new TH1D("treedraw_h1","",100,0,1000);
+    tree->Draw("E>>treedraw_h1", TCut("Element<10"), "goff");
+    compare(h1, r1);
+
+    auto r2 = new TH2D("treedraw_h2","",20,0,20,10,0,1000);
+    tree->Draw("E:Element>>treedraw_h2", TCut(""), "goff");
+    compare(h2, r2);
+
+    auto r3 = new TH3D("treedraw_h3","",20,0,20,10,0,1000,10,0,3.2);
+    tree->Draw("Theta:E:Element>>treedraw_h3", TCut("Theta>1"), "goff");
+    compare(h3, r3);
+
+    auto r4 = new TH1D("treedraw_h4","",32,0,3.2);
+    tree->Draw("Theta>>treedraw_h4", TCut("E/1000"), "goff");
+    compare(h4, r4);
+
+    // running again fills again
+    drawer.Run();
+    CHECK(h1->Integral() == Approx(2*r1->Integral()));
+}
@@ -0,0 +1,116 @@
+#include "catch.hpp"
+#include "catch_config.h"
+
+#include "base/AliasTable.h"
+
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <iostream>
+
+using namespace std;
+using namespace ant;
+
+void dotest_distribution();
+void dotest_edgecases();
+
+TEST_CASE("AliasTable: Distribution", "[base]") {
+    dotest_distribution();
+}
+
+TEST_CASE("AliasTable: Edge cases", "[base]") {
+    dotest_edgecases();
+}
+
+void dotest_distribution() {
+    const vector<double> weights{1, 0, 3, 0.5, 5.5};
+    const AliasTable table(weights);
+    REQUIRE(table.size() == weights.size());
+    REQUIRE(table.Total() == Approx(10));
+
+    std::mt19937 rng(4711);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    vector<unsigned> counts(weights.size());
+    const unsigned n = 1000000;
+    for(unsigned i=0;i<n;i++)
+        counts.at(table.Sample(uniform(rng)))++;
+
+    CHECK(counts[1] == 0);
+    for(size_t i=0;i<weights.size();i++)
+        CHECK(double(counts[i])/n == Approx(weights[i]/table.Total()).epsilon(0.01));
+}
+
+void dotest_edgecases() {
+    CHECK_THROWS_AS(AliasTable(vector<double>{}), AliasTable::Exception);
+    CHECK_THROWS_AS(AliasTable({0, 0}), AliasTable::Exception);
+    CHECK_THROWS_AS(AliasTable({1, -1}), AliasTable::Exception);
+
+    const AliasTable single({2.0});
+    CHECK(single.Sample(0) == 0);
+    CHECK(single.Sample(0.999) == 0);
+
+    // u==1 must not go out of range
+    const AliasTable table({1, 1, 1});
+    CHECK(table.Sample(1.0) < 3);
+    CHECK(table.Sample(0.0) == 0);
+}
+
+TEST_CASE("AliasTable: Benchmark", "[.][base][benchmark]") {
+    // realistic cocktail size: 350 tagger bins with 40 channels each
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    const unsigned nBins = 350;
+    const unsigned nChannels = 40;
+    vector<vector<double>> accProbs(nBins);
+    vector<AliasTable> tables;
+    vector<double> binAccProb;
+    vector<double> binWeights;
+    double acc_E = 0;
+    for(auto& accProb : accProbs) {
+        vector<double> weights;
+        double acc = 0;
+        for(unsigned ch=0;ch<nChannels;ch++) {
+            weights.push_back(uniform(rng));
+            acc += weights.back();
+            accProb.push_back(acc);
+        }
+        tables.emplace_back(weights);
+        binWeights.push_back(1.0+uniform(rng));
+        acc_E += binWeights.back();
+        binAccProb.push_back(acc_E);
+    }
+    const AliasTable binTable(binWeights);
+
+    const unsigned n = 1000000;
+
+    auto run = [n] (const string& name, std::function<size_t()> sample) {
+        size_t sum = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for(unsigned i=0;i<n;i++)
+            sum += sample();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        cout << name << ": " << n/elapsed.count() << " events/s, checksum " << sum << endl;
+    };
+
+    // the linear walk Cocktail used before
+    run("linear", [&] () -> size_t {
+        const double rndE = uniform(rng) * binAccProb.back();
+        for(unsigned bin=0;bin<nBins;bin++) {
+            if(rndE <= binAccProb[bin]) {
+                const auto& accProb = accProbs[bin];
+                const double rndCh = uniform(rng) * accProb.back();
+                for(unsigned ch=0;ch<nChannels;ch++)
+                    if(rndCh <= accProb[ch])
+                        return ch;
+            }
+        }
+        return 0;
+    });
+
+    run("alias", [&] () -> size_t {
+        const auto bin = binTable.Sample(uniform(rng));
+        return tables[bin].Sample(uniform(rng));
+    });
+}
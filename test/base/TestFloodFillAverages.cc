@@ -33,6 +33,7 @@ void dotest_simple();
 void dotest_edge1();
 void dotest_edge2();
 void dotest_cyclic();
+void dotest_grid();
 
 
 TEST_CASE("FloodFillAverages: Simple", "[base]") {
@@ -51,6 +52,10 @@ TEST_CASE("FloodFillAverages: Cyclic", "[base]") {
     dotest_cyclic();
 }
 
+TEST_CASE("FloodFillAverages: Grid", "[base]") {
+    dotest_grid();
+}
+
 void dotest_simple() {
     vector<double> numbers{
         0.5, NaN, 0.5,  // 0,1,2
@@ -122,3 +127,47 @@ void dotest_cyclic() {
         CHECK(ring[i] == Approx(i<5 ? 0.1 : 0.2));
 
 }
+
+void dotest_grid() {
+    // same as the explicit neighbours of the 3x3 grid above
+    const auto grid2D = FloodFill::Grid({3, 3});
+    REQUIRE(grid2D.Size() == 9);
+    vector<double> numbers{
+        0.1, NaN, NaN,  // 0,1,2
+        NaN, NaN, NaN,  // 3,4,5
+        NaN, NaN, 0.5   // 6,7,8
+    };
+    auto expected = numbers;
+    doFloodFill(expected);
+    grid2D.Fill(numbers);
+    for(unsigned i=0;i<numbers.size();i++)
+        CHECK(numbers[i] == Approx(expected[i]));
+
+    // a hole in the center of a 3x3x3 cube sees its six direct neighbours only
+    const auto grid3D = FloodFill::Grid({3, 3, 3});
+    REQUIRE(grid3D.Size() == 27);
+    vector<double> cube(27, 0.0);
+    for(int i : {4, 10, 12, 14, 16, 22}) // direct neighbours of 13
+        cube[i] = i;
+    cube[13] = NaN;
+    grid3D.Fill(cube);
+    CHECK(cube[13] == Approx((4+10+12+14+16+22)/6.0));
+
+    // unsigned neighbour lists as provided by detector elements
+    const auto ring = FloodFill::FromNeighbours(4, [] (int i) {
+        return vector<unsigned>{unsigned((i+1) % 4), unsigned((i+3) % 4)};
+    });
+    vector<double> values{1.0, NaN, 3.0, NaN};
+    ring.Fill(values);
+    CHECK(values[1] == Approx(2.0));
+    CHECK(values[3] == Approx(2.0));
+
+    // holes without any valid neighbour stay NaN
+    vector<double> allnan(9, NaN);
+    grid2D.Fill(allnan);
+    for(auto v : allnan)
+        CHECK(std::isnan(v));
+
+    CHECK_THROWS_AS(grid2D.Fill(values), std::invalid_argument);
+    CHECK_THROWS_AS(FloodFill::FromNeighbours(2, [] (int) { return vector<int>{2}; }), std::out_of_range);
+}
@@ -4,8 +4,12 @@
 #include "base/Interpolator.h"
 #include "base/std_ext/memory.h"
 
-#include "interp2d/interp2d.h" // for INDEX_2D
+extern "C" {
+#include "interp2d/interp2d_spline.h" // reference implementation, also for INDEX_2D
+}
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 using namespace std;
@@ -13,6 +17,7 @@ using namespace ant;
 
 void dotest_symmetric(Interpolator2D::Type type);
 void dotest_weird();
+void dotest_reference(Interpolator2D::Type type, bool equidistant);
 
 TEST_CASE("Interpolator2D: Bicubic", "[base]") {
     dotest_symmetric(Interpolator2D::Type::Bicubic);
@@ -27,6 +32,13 @@ TEST_CASE("Interpolator2D: Weird stuff", "[base]") {
     dotest_weird();
 }
 
+TEST_CASE("Interpolator2D: Compare to interp2d", "[base]") {
+    dotest_reference(Interpolator2D::Type::Bicubic, true);
+    dotest_reference(Interpolator2D::Type::Bicubic, false);
+    dotest_reference(Interpolator2D::Type::Bilinear, true);
+    dotest_reference(Interpolator2D::Type::Bilinear, false);
+}
+
 void dotest_symmetric(Interpolator2D::Type type) {
     const vector<double> x{0.0, 1.0, 2.0, 3.0};
     const vector<double> y{0.0, 1.0, 2.0, 3.0};
@@ -60,7 +72,74 @@ void dotest_weird() {
     const vector<double> z{1,2,3};
 
     REQUIRE_THROWS_AS(std_ext::make_unique<Interpolator2D>(x,y,z), Interpolator2D::Exception);
+
+    // bicubic needs at least four nodes per axis
+    const vector<double> x3{1,2,3};
+    const vector<double> z12(12, 1.0);
+    REQUIRE_THROWS_AS(Interpolator2D(x3,y,z12), Interpolator2D::Exception);
+    REQUIRE_NOTHROW(Interpolator2D(x3,y,z12,Interpolator2D::Type::Bilinear));
+
+    // nodes must be increasing
+    const vector<double> x_unsorted{1,3,2,4};
+    const vector<double> z16(16, 1.0);
+    REQUIRE_THROWS_AS(Interpolator2D(x_unsorted,y,z16), Interpolator2D::Exception);
+
+    // outside of the grid is NaN
+    Interpolator2D inter(x,y,z16);
+    CHECK(std::isnan(inter.GetPoint(0.5, 2.0)));
+    CHECK(std::isnan(inter.GetPoint(2.0, 4.5)));
+    CHECK(inter.GetPoint(4.0, 4.0) == Approx(1.0));
 }
 
+void dotest_reference(Interpolator2D::Type type, bool equidistant) {
+    vector<double> x, y;
+    for(int i=0;i<9;i++)
+        x.push_back(equidistant ? -1.0 + 0.5*i : -1.0 + 0.5*i + 0.1*std::sin(i*i));
+    for(int j=0;j<7;j++)
+        y.push_back(equidistant ? 0.3*j : 0.3*j*j);
+    vector<double> z;
+    for(size_t j=0;j<y.size();j++)
+        for(size_t i=0;i<x.size();i++)
+            z.push_back(std::cos(x[i])*std::exp(-y[j]) + 0.1*x[i]*y[j]);
+
+    Interpolator2D inter(x, y, z, type);
+
+    auto ref = interp2d_alloc(type == Interpolator2D::Type::Bicubic ? interp2d_bicubic : interp2d_bilinear,
+                              x.size(), y.size());
+    interp2d_init(ref, x.data(), y.data(), z.data(), x.size(), y.size());
+    auto xa = gsl_interp_accel_alloc();
+    auto ya = gsl_interp_accel_alloc();
+
+    vector<double> xval, yval;
+    const int n = 53;
+    for(int k=0;k<=n;k++) {
+        for(int l=0;l<=n;l++) {
+            // clip rounding beyond the last node
+            xval.push_back(std::min(x.back(), x.front() + (x.back()-x.front())*k/n));
+            yval.push_back(std::min(y.back(), y.front() + (y.back()-y.front())*l/n));
+        }
+    }
+    // the nodes themselves
+    for(auto xv : x) {
+        for(auto yv : y) {
+            xval.push_back(xv);
+            yval.push_back(yv);
+        }
+    }
+
+    vector<double> zval;
+    inter.GetPoints(xval, yval, zval);
+    REQUIRE(zval.size() == xval.size());
 
+    for(size_t k=0;k<xval.size();k++) {
+        const double expected = interp2d_eval(ref, x.data(), y.data(), z.data(), xval[k], yval[k], xa, ya);
+        CHECK(inter.GetPoint(xval[k], yval[k]) == Approx(expected).epsilon(1e-10));
+        CHECK(zval[k] == inter.GetPoint(xval[k], yval[k]));
+    }
+
+    gsl_interp_accel_free(xa);
+    gsl_interp_accel_free(ya);
+    interp2d_free(ref);
 
+    REQUIRE_THROWS_AS(inter.GetPoints({0.0}, {}, zval), Interpolator2D::Exception);
+}
@@ -1,6 +1,11 @@
 #include "catch.hpp"
 
 #include "base/SavitzkyGolay.h"
+#include "base/std_ext/math.h"
+
+#include <cmath>
+#include <vector>
+#include <utility>
 
 using namespace std;
 using namespace ant;
@@ -16,3 +21,141 @@ TEST_CASE("SavitzkyGolay: Constant values", "[base/std_ext]") {
         REQUIRE(smoothed[i] == Approx(expected[i]));
     }
 }
+
+TEST_CASE("SavitzkyGolay: Known coefficients", "[base/std_ext]") {
+    // the classic tables for quadratic polynomials
+    const vector<pair<int, vector<double>>> tables = {
+        {5, {-3.0/35, 12.0/35, 17.0/35, 12.0/35, -3.0/35}},
+        {7, {-2.0/21, 3.0/21, 6.0/21, 7.0/21, 6.0/21, 3.0/21, -2.0/21}},
+    };
+    for(const auto& table : tables) {
+        const auto window = table.first;
+        const auto& coefficients = table.second;
+        SavitzkyGolay sg(window, 2);
+        // the response to an impulse far from the edges
+        vector<double> y(30, 0.0);
+        y[15] = 1.0;
+        const auto smoothed = sg.Smooth(y);
+        const int n_l = window/2;
+        for(int k=0;k<window;k++) {
+            INFO("window=" << window << " k=" << k);
+            REQUIRE(smoothed[15+n_l-k] == Approx(coefficients[k]));
+        }
+    }
+}
+
+// value at the central point of the polynomial fitted to each window of the mirrored input,
+// by solving the normal equations directly
+vector<double> smooth_reference(int n_l, int n_r, int m, const vector<double>& y) {
+    // ... y[2] y[1] y[0] y[1] .... y[n-2] y[n-1] y[n-2] y[n-3] ...
+    const int n = y.size();
+    auto get_y = [&y, n] (int i) {
+        if(n == 1)
+            return y[0];
+        while(i < 0 || i >= n) {
+            if(i < 0)
+                i = -i;
+            if(i >= n)
+                i = 2*(n-1) - i;
+        }
+        return y[i];
+    };
+
+    vector<double> result(n);
+    for(int i=0;i<n;i++) {
+        // A = sum x^(j+l), b = sum x^j y with x relative to the central point
+        const int dim = m+1;
+        vector<vector<double>> A(dim, vector<double>(dim+1, 0.0));
+        for(int x=-n_l;x<=n_r;x++) {
+            const double y_x = get_y(i+x);
+            for(int j=0;j<dim;j++) {
+                for(int l=0;l<dim;l++)
+                    A[j][l] += std::pow(x, j+l);
+                A[j][dim] += std::pow(x, j)*y_x;
+            }
+        }
+        // Gaussian elimination with partial pivoting
+        for(int col=0;col<dim;col++) {
+            int pivot = col;
+            for(int row=col+1;row<dim;row++)
+                if(std::abs(A[row][col]) > std::abs(A[pivot][col]))
+                    pivot = row;
+            swap(A[col], A[pivot]);
+            for(int row=col+1;row<dim;row++) {
+                const double f = A[row][col]/A[col][col];
+                for(int k=col;k<=dim;k++)
+                    A[row][k] -= f*A[col][k];
+            }
+        }
+        vector<double> a(dim);
+        for(int row=dim-1;row>=0;row--) {
+            double sum = A[row][dim];
+            for(int k=row+1;k<dim;k++)
+                sum -= A[row][k]*a[k];
+            a[row] = sum/A[row][row];
+        }
+        // the polynomial at x=0
+        result[i] = a[0];
+    }
+    return result;
+}
+
+TEST_CASE("SavitzkyGolay: Smooth matches least-squares fit", "[base/std_ext]") {
+    for(auto n : {1, 2, 3, 5, 8, 50}) {
+        vector<double> y;
+        for(int i=0;i<n;i++)
+            y.push_back(std::sin(0.3*i) + 0.1*(i % 3));
+        for(auto window : {3, 6, 7}) {
+            for(auto m : {1, 2}) {
+                SavitzkyGolay sg(window, m);
+                const int n_l = (window-1)/2 + (window % 2 == 0);
+                const int n_r = (window-1)/2;
+                const auto expected = smooth_reference(n_l, n_r, m, y);
+                const auto smoothed = sg.Smooth(y);
+                REQUIRE(smoothed.size() == expected.size());
+                const interval<int> range(0, n-1);
+                for(auto i=0;i<n;i++) {
+                    INFO("n=" << n << " window=" << window << " m=" << m << " i=" << i);
+                    REQUIRE(smoothed[i] == Approx(expected[i]));
+                    // the same with the accessors
+                    double convoluted = std_ext::NaN;
+                    sg.Convolute([&y,i] (int i_) { return y.at(i+i_); },
+                                 [&convoluted] (double v) { convoluted = v; },
+                                 interval<int>(range.Start()-i, range.Stop()-i));
+                    REQUIRE(convoluted == Approx(expected[i]));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("SavitzkyGolay: Convolute arrays", "[base/std_ext]") {
+    // each array is one item of the sequence,
+    // each column must be smoothed like a single sequence
+    const unsigned nItems = 9;
+    const unsigned nBins = 13;
+    vector<vector<double>> items(nItems, vector<double>(nBins));
+    for(auto i=0u;i<nItems;i++)
+        for(auto bin=0u;bin<nBins;bin++)
+            items[i][bin] = std::cos(0.7*i+bin) + bin;
+
+    vector<const double*> ys;
+    for(auto& item : items)
+        ys.push_back(item.data());
+
+    SavitzkyGolay sg(2,3,3);
+    for(auto bin=0u;bin<nBins;bin++) {
+        vector<double> column;
+        for(auto& item : items)
+            column.push_back(item[bin]);
+        const auto expected = sg.Smooth(column);
+        for(auto i=0u;i<nItems;i++) {
+            vector<double> result(nBins);
+            sg.Convolute(ys, i, nBins, result.data());
+            INFO("bin=" << bin << " i=" << i);
+            REQUIRE(result[bin] == Approx(expected[i]));
+        }
+    }
+
+    REQUIRE_THROWS_AS(sg.Convolute({}, 0, nBins, nullptr), SavitzkyGolay::Exception);
+}
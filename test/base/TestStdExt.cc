@@ -6,10 +6,14 @@
 #include "base/std_ext/container.h"
 #include "base/std_ext/system.h"
 #include "base/std_ext/shared_ptr_container.h"
+#include "base/std_ext/arena.h"
+#include "base/std_ext/array_map.h"
 #include "base/std_ext/math.h"
 #include "base/std_ext/misc.h"
 #include "base/std_ext/vector.h"
 #include "base/std_ext/map.h"
+#include "base/std_ext/hash.h"
+#include "base/std_ext/small_vector.h"
 
 #include "base/tmpfile_t.h"
 
@@ -18,6 +22,9 @@
 #include <iostream>
 #include <random>
 #include <map>
+#include <cstring>
+#include <algorithm>
+#include <thread>
 
 using namespace std;
 using namespace ant;
@@ -38,6 +45,10 @@ void TestLsFiles();
 void TestSharedPtrContainer();
 void TestRMSIQR();
 void TestDereference();
+void TestArena();
+void TestArrayMap();
+void TestHash();
+void TestSmallVector();
 
 TEST_CASE("make_unique", "[base/std_ext]") {
     TestMakeUnique();
@@ -71,6 +82,22 @@ TEST_CASE("Dereference", "[base/std_ext]") {
     TestDereference();
 }
 
+TEST_CASE("arena", "[base/std_ext]") {
+    TestArena();
+}
+
+TEST_CASE("array_map", "[base/std_ext]") {
+    TestArrayMap();
+}
+
+TEST_CASE("small_vector", "[base/std_ext]") {
+    TestSmallVector();
+}
+
+TEST_CASE("fnv1a hash", "[base/std_ext]") {
+    TestHash();
+}
+
 void TestMakeUnique() {
     std::unique_ptr<MemtestDummy> d;
 
@@ -364,3 +391,214 @@ void TestDereference() {
     REQUIRE(std_ext::dereference(a_shared).check());
     REQUIRE(std_ext::dereference(a_unique).check());
 }
+
+void TestArena() {
+    std_ext::arena a(1024);
+
+    // chunk is rewound at the end of the event once everything is released
+    for(int i=0;i<100;i++) {
+        auto p1 = a.allocate(100);
+        auto p2 = a.allocate(100);
+        REQUIRE(p1 != p2);
+        std_ext::arena::deallocate(p2);
+        std_ext::arena::deallocate(p1);
+        a.EndEvent();
+    }
+    REQUIRE(a.Chunks() == 1);
+
+    // an object kept alive pins its chunk, all others are recycled
+    auto keep = static_cast<char*>(a.allocate(100));
+    std::fill(keep, keep+100, 'x');
+    std::vector<void*> ptrs;
+    for(int i=0;i<20;i++)
+        ptrs.push_back(a.allocate(100));
+    for(auto p : ptrs)
+        std_ext::arena::deallocate(p);
+    ptrs.clear();
+    for(int i=0;i<20;i++)
+        ptrs.push_back(std::memset(a.allocate(100), 0, 100));
+    REQUIRE(std::count(keep, keep+100, 'x') == 100);
+    std_ext::arena::deallocate(keep);
+    for(auto p : ptrs)
+        std_ext::arena::deallocate(p);
+    ptrs.clear();
+    const auto nChunks = a.Chunks();
+    for(int i=0;i<21;i++)
+        ptrs.push_back(a.allocate(100));
+    REQUIRE(a.Chunks() == nChunks);
+    for(auto p : ptrs)
+        std_ext::arena::deallocate(p);
+
+    // large objects bypass the chunks
+    auto large = a.allocate(1000);
+    REQUIRE(a.Chunks() == nChunks);
+    std_ext::arena::deallocate(large);
+
+    // only few released chunks are kept for reuse
+    {
+        std_ext::arena b(1024, 2);
+        for(int i=0;i<80;i++)
+            ptrs.push_back(b.allocate(100));
+        REQUIRE(b.Chunks() == 10);
+        for(auto p : ptrs)
+            std_ext::arena::deallocate(p);
+        ptrs.clear();
+        // the current one and two unused
+        REQUIRE(b.Chunks() == 3);
+        b.Orphan();
+        REQUIRE(b.Chunks() == 0);
+    }
+
+    // objects from the arenas of several threads, released by another thread,
+    // also after their thread has finished
+    {
+        std::vector<std::vector<std::shared_ptr<unsigned>>> objects(4);
+        std::vector<std::thread> threads;
+        for(unsigned t=0;t<objects.size();t++) {
+            threads.emplace_back([t, &objects] () {
+                for(unsigned i=0;i<10000;i++) {
+                    objects[t].emplace_back(std_ext::make_arena_shared<unsigned>(t*10000+i));
+                    // some released right away
+                    if(i % 3 == 0)
+                        objects[t].pop_back();
+                }
+            });
+        }
+        for(auto& thread : threads)
+            thread.join();
+        for(unsigned t=0;t<objects.size();t++) {
+            REQUIRE(objects[t].size() == 6666);
+            for(auto& o : objects[t]) {
+                REQUIRE(*o / 10000 == t);
+                REQUIRE(*o % 10000 % 3 != 0);
+            }
+        }
+        // released by the main thread, concurrently to the other arenas
+        std::thread releaser([&objects] () { objects[0].clear(); objects[1].clear(); });
+        objects[2].clear();
+        objects[3].clear();
+        releaser.join();
+    }
+
+    // objects created by containers survive the container
+    std_ext::cc_shared_ptr<MemtestDummy> ptr;
+    {
+        std_ext::shared_ptr_container<MemtestDummy> c;
+        c.emplace_back();
+        c.emplace_back();
+        REQUIRE(MemtestDummy::n == 2);
+        ptr = c.get_ptr_at(1);
+    }
+    REQUIRE(MemtestDummy::n == 1);
+    ptr = nullptr;
+    REQUIRE(MemtestDummy::n == 0);
+}
+
+void TestArrayMap() {
+    enum class key_t : std::uint8_t { A, B, C, D };
+    using m_t = std_ext::array_map<key_t, vector<int>, 4>;
+    m_t m;
+
+    REQUIRE(m.empty());
+    REQUIRE(m.begin() == m.end());
+    REQUIRE(m.find(key_t::B) == m.end());
+
+    // inserted in any order, but iterated sorted by key
+    m[key_t::C].push_back(3);
+    REQUIRE(m.insert(m.cbegin(), make_pair(key_t::A, vector<int>{1,1}))->second.size() == 2);
+    REQUIRE_FALSE(m.insert(make_pair(key_t::A, vector<int>{2})).second);
+    REQUIRE(m.size() == 2);
+    REQUIRE(m.count(key_t::D) == 0);
+
+    vector<key_t> keys;
+    for(const auto& item : m)
+        keys.push_back(item.first);
+    REQUIRE(keys == vector<key_t>({key_t::A, key_t::C}));
+
+    const m_t& cm = m;
+    auto it = cm.find(key_t::C);
+    REQUIRE(it != cm.end());
+    REQUIRE(it->second == vector<int>{3});
+
+    // cleared values keep their capacity
+    const auto capacity = m[key_t::A].capacity();
+    m.clear();
+    REQUIRE(m.empty());
+    REQUIRE(m[key_t::A].empty());
+    REQUIRE(m[key_t::A].capacity() == capacity);
+    REQUIRE(m.erase(key_t::A) == 1);
+    REQUIRE(m.erase(key_t::A) == 0);
+
+    REQUIRE_THROWS_AS(m[static_cast<key_t>(4)], std::out_of_range);
+
+    // moving transfers the present items
+    m[key_t::D].push_back(4);
+    m_t m2(move(m));
+    REQUIRE(m2.size() == 1);
+    REQUIRE(m2.find(key_t::D)->second == vector<int>{4});
+}
+
+void TestHash() {
+    // reference values of the FNV-1a 64bit hash
+    REQUIRE(std_ext::fnv1a_t().Value == 0xcbf29ce484222325ull);
+    const string a("a");
+    REQUIRE(std_ext::fnv1a_t().Add(a.data(), a.size()).Value == 0xaf63dc4c8601ec8cull);
+    const string foobar("foobar");
+    REQUIRE(std_ext::fnv1a_t().Add(foobar.data(), foobar.size()).Value == 0x85944171f73967e8ull);
+    REQUIRE(std_ext::fnv1a_t().Add(foobar.data(), foobar.size()).AsHex() == "85944171f73967e8");
+
+    // strings are added with their size
+    REQUIRE(std_ext::fnv1a_t().Add(string("ab")).Add(string("c")).Value !=
+            std_ext::fnv1a_t().Add(string("a")).Add(string("bc")).Value);
+
+    REQUIRE(std_ext::fnv1a_t().Add(1.0).Value == std_ext::fnv1a_t().Add(1.0).Value);
+    REQUIRE(std_ext::fnv1a_t().Add(1.0).Value != std_ext::fnv1a_t().Add(2.0).Value);
+    REQUIRE(std_ext::fnv1a_t().AsHex().size() == 16);
+}
+
+void TestSmallVector() {
+    using v_t = std_ext::small_vector<uint16_t, 2>;
+
+    v_t v{1, 2};
+    REQUIRE(v.size() == 2);
+    REQUIRE(v.capacity() == 2);
+    const auto inline_data = v.data();
+
+    // exceeding the inline storage moves to the heap
+    v.push_back(v.front());
+    REQUIRE(v.size() == 3);
+    REQUIRE(v.capacity() > 2);
+    REQUIRE(v.data() != inline_data);
+    REQUIRE(v == v_t({1, 2, 1}));
+
+    // moving takes over the heap storage
+    const auto heap_data = v.data();
+    v_t moved(std::move(v));
+    REQUIRE(moved.data() == heap_data);
+    REQUIRE(v.empty());
+    REQUIRE(v.capacity() == 2);
+
+    // inline storage is copied
+    v_t small{7};
+    v = std::move(small);
+    REQUIRE(v == v_t({7}));
+    REQUIRE(v.capacity() == 2);
+
+    v_t copy(moved);
+    REQUIRE(copy == moved);
+    REQUIRE(copy.data() != moved.data());
+    copy = v;
+    REQUIRE(copy == v);
+    REQUIRE(copy != moved);
+
+    // new elements are zero
+    copy.resize(5);
+    REQUIRE(copy == v_t({7, 0, 0, 0, 0}));
+    copy.clear();
+    REQUIRE(copy.empty());
+    REQUIRE(copy.capacity() >= 5);
+
+    const vector<uint16_t> values{3, 4, 5};
+    const v_t from_range(values.begin(), values.end());
+    REQUIRE(vector<uint16_t>(from_range.begin(), from_range.end()) == values);
+}
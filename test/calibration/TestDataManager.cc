@@ -19,6 +19,7 @@ using namespace ant::calibration;
 unsigned dotest_store(const string& foldername);
 void dotest_load(const string& foldername, unsigned ndata);
 void dotest_changes(const string& foldername);
+void dotest_accesslog(const string& foldername);
 
 TEST_CASE("CalibrationDataManager: Save/Load","[calibration]")
 {
@@ -28,6 +29,13 @@ TEST_CASE("CalibrationDataManager: Save/Load","[calibration]")
     dotest_changes(tmp.foldername);
 }
 
+TEST_CASE("CalibrationDataManager: Access log","[calibration]")
+{
+    tmpfolder_t tmp;
+    dotest_store(tmp.foldername);
+    dotest_accesslog(tmp.foldername);
+}
+
 unsigned dotest_store(const string& foldername)
 {
     DataManager calibman(foldername);
@@ -435,3 +443,59 @@ void dotest_changes(const string& foldername)
 
 
 }
+
+void dotest_accesslog(const string& foldername)
+{
+    DataManager::AccessLog_t log;
+    {
+        DataManager calibman(foldername);
+        TCalibrationData cdata;
+        TID nextChangePoint;
+
+        // not recorded by default
+        REQUIRE(calibman.GetData("1", TID(0,5u), cdata));
+        REQUIRE(calibman.GetAccessLog().empty());
+
+        calibman.RecordAccesses(true);
+        REQUIRE(calibman.GetData("1", TID(0,5u), cdata));
+        REQUIRE(calibman.GetData("2", TID(0,7u), cdata, nextChangePoint));
+        REQUIRE_FALSE(calibman.GetData("2", TID(0,10u), cdata, nextChangePoint));
+        // repeated requests are recorded once
+        REQUIRE(calibman.GetData("1", TID(0,5u), cdata));
+        REQUIRE(calibman.GetData("2", TID(0,7u), cdata, nextChangePoint));
+        log = calibman.GetAccessLog();
+    }
+    REQUIRE(log.size() == 3);
+    CHECK(log.at(0).Found);
+    CHECK(log.at(0).TimeStamp == 4);
+    CHECK(log.at(1).NextChangePoint == TID(0,8u));
+    CHECK_FALSE(log.at(2).Found);
+    CHECK(log.at(1).DataHash != 0);
+
+    // a later run sees the same data
+    {
+        DataManager calibman(foldername);
+        calibman.RecordAccesses(true);
+        REQUIRE(calibman.ReproducesAccessLog(log));
+        // replaying does not count as access
+        REQUIRE(calibman.GetAccessLog().empty());
+    }
+
+    // new data for one of the requested IDs
+    {
+        DataManager calibman(foldername);
+        TCalibrationData cdata("2", TID(0,7u), TID(0,7u));
+        cdata.TimeStamp = 10;
+        cdata.Data.emplace_back(0,3);
+        calibman.Add(cdata, Calibration::AddMode_t::StrictRange);
+        REQUIRE_FALSE(calibman.ReproducesAccessLog(log));
+    }
+
+    // data outside the requests does not matter
+    log.pop_back();
+    log.erase(log.begin()+1);
+    {
+        DataManager calibman(foldername);
+        REQUIRE(calibman.ReproducesAccessLog(log));
+    }
+}
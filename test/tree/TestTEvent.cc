@@ -2,6 +2,7 @@
 
 #include "tree/TEvent.h"
 #include "tree/TEventData.h"
+#include "tree/stream_TBuffer.h"
 
 #include "base/tmpfile_t.h"
 #include "base/std_ext/memory.h"
@@ -10,18 +11,31 @@
 
 #include "TFile.h"
 #include "TTree.h"
+#include "TBufferFile.h"
 
 #include <iostream>
+#include <sstream>
+#include <cstring>
 
 using namespace std;
 using namespace ant;
 
 void dotest();
+void dotest_bulk();
+void dotest_version5();
 
 TEST_CASE("TEvent: Write/Read TTree", "[tree]") {
     dotest();
 }
 
+TEST_CASE("TEvent: Bulk binary archive", "[tree]") {
+    dotest_bulk();
+}
+
+TEST_CASE("TEvent: Read version 5", "[tree]") {
+    dotest_version5();
+}
+
 void dotest() {
     tmpfile_t tmpfile;
 
@@ -170,3 +184,136 @@ void dotest() {
     }
 
 }
+
+struct bulk_data_t {
+    vector<TDetectorReadHit> DetectorReadHits;
+    vector<TTaggerHit>       TaggerHits;
+    TClusterList             Clusters;
+    TCandidateList           Candidates;
+
+    template<class Archive>
+    void serialize(Archive& archive) {
+        archive(DetectorReadHits, TaggerHits, Clusters, Candidates);
+    }
+};
+
+void dotest_bulk() {
+    bulk_data_t eventdata;
+
+    eventdata.DetectorReadHits.emplace_back(LogicalChannel_t{Detector_t::Type_t::CB, Channel_t::Type_t::Integral, 5},
+                                            TDetectorReadHit::Value_t(1.5));
+    eventdata.DetectorReadHits.back().Values.emplace_back(2.5);
+    eventdata.DetectorReadHits.back().ValueBits = {true, false};
+    eventdata.DetectorReadHits.emplace_back(LogicalChannel_t{Detector_t::Type_t::PID, Channel_t::Type_t::Timing, 3},
+                                            TDetectorReadHit::RawData_t{0x1234, 0xabcd});
+
+    eventdata.TaggerHits.emplace_back(12, 1400.0, 3.0, 0.5);
+    eventdata.TaggerHits.back().Electrons.emplace_back(13, 4.0);
+
+    TClusterHit hit(7, 10.0, 1.0);
+    hit.Data.emplace_back(Channel_t::Type_t::Integral, TDetectorReadHit::Value_t(9.0));
+    hit.Data.emplace_back(Channel_t::Type_t::Timing, TDetectorReadHit::Value_t(-3.0));
+    eventdata.Clusters.emplace_back(vec3(1,2,3), 100, 0.5, Detector_t::Type_t::CB, 7,
+                                    vector<TClusterHit>{hit, TClusterHit(8, 5.0, 2.0)});
+    eventdata.Clusters.emplace_back(vec3(4,5,6), 50, 0.7, Detector_t::Type_t::PID, 3);
+
+    eventdata.Candidates.emplace_back(Detector_t::Any_t::CB_Apparatus, 100, 1.0, 2.0, 0.5, 2, 1.0, 0.0,
+                                      TClusterList{std::next(eventdata.Clusters.begin(), 0),
+                                                   std::next(eventdata.Clusters.begin(), 1)});
+
+    // same bytes as cereal's binary archive
+    stringstream ss_cereal;
+    {
+        cereal::BinaryOutputArchive ar(ss_cereal);
+        ar(eventdata);
+    }
+    stringstream ss_bulk;
+    {
+        BulkBinaryOutputArchive ar(ss_bulk);
+        ar(eventdata);
+    }
+    REQUIRE(ss_cereal.str() == ss_bulk.str());
+
+    // read it back
+    bulk_data_t readback;
+    {
+        BulkBinaryInputArchive ar(ss_cereal);
+        ar(readback);
+    }
+    REQUIRE(readback.DetectorReadHits.size() == 2);
+    REQUIRE(readback.DetectorReadHits.front().Values.size() == 2);
+    CHECK(readback.DetectorReadHits.front().Values.back().Calibrated == 2.5);
+    CHECK(readback.DetectorReadHits.front().ValueBits == vector<bool>({true, false}));
+    CHECK(readback.DetectorReadHits.back().RawData == TDetectorReadHit::RawData_t({0x1234, 0xabcd}));
+
+    REQUIRE(readback.TaggerHits.size() == 1);
+    REQUIRE(readback.TaggerHits.front().Electrons.size() == 2);
+    CHECK(readback.TaggerHits.front().Electrons.front().QDCEnergy == 0.5);
+    CHECK(readback.TaggerHits.front().Electrons.back().Channel == 13);
+    CHECK(std::isnan(readback.TaggerHits.front().Electrons.back().QDCEnergy));
+
+    REQUIRE(readback.Clusters.size() == 2);
+    const auto& hits = readback.Clusters.front().Hits;
+    REQUIRE(hits.size() == 2);
+    REQUIRE(hits.front().Data.size() == 2);
+    CHECK(hits.front().Data.back().Type == Channel_t::Type_t::Timing);
+    CHECK(hits.front().Data.back().Value.Uncalibrated == -3.0);
+    CHECK(hits.back().Data.empty());
+
+    REQUIRE(readback.Candidates.size() == 1);
+    CHECK(readback.Candidates.front().Clusters.get_ptr_at(1) == readback.Clusters.get_ptr_at(1));
+    CHECK(readback.Candidates.front().Direction == vec3::RThetaPhi(1.0, 1.0, 2.0));
+}
+
+void dotest_version5() {
+    TEvent event(TID(10));
+    event.Reconstructed().DetectorReadHits.emplace_back(LogicalChannel_t{Detector_t::Type_t::PID, Channel_t::Type_t::Timing, 3},
+                                                        TDetectorReadHit::RawData_t{0x1234, 0xabcd});
+
+    TBufferFile buffer(TBuffer::kWrite);
+    event.Streamer(buffer);
+    string bytes(buffer.Buffer(), buffer.Length());
+
+    // version 5 only differs in the raw data, which was stored as bytes,
+    // and the DetectorReadHits had no class version yet,
+    // so patch the class version at the very beginning, drop the hit version and patch the size of the raw data
+    const uint32_t version = 5;
+    REQUIRE(bytes.size() > sizeof(version));
+    std::memcpy(&bytes[0], &version, sizeof(version));
+
+    stringstream ss_id;
+    {
+        cereal::BinaryOutputArchive ar(ss_id);
+        ar(TID(10));
+    }
+    // after the TEvent version, the valid flag of the unique_ptr, the TID and the number of hits
+    const auto pos_hitversion = sizeof(version) + sizeof(uint8_t) + ss_id.str().size() + sizeof(uint64_t);
+    uint32_t hitversion = 0;
+    REQUIRE(bytes.size() > pos_hitversion + sizeof(hitversion));
+    std::memcpy(&hitversion, &bytes[pos_hitversion], sizeof(hitversion));
+    REQUIRE(hitversion == 1);
+    bytes.erase(pos_hitversion, sizeof(hitversion));
+
+    const uint16_t rawdata[] = {0x1234, 0xabcd};
+    uint64_t size = 2;
+    string pattern(reinterpret_cast<const char*>(&size), sizeof(size));
+    pattern.append(reinterpret_cast<const char*>(rawdata), sizeof(rawdata));
+    const auto pos = bytes.find(pattern);
+    REQUIRE(pos != string::npos);
+    size = sizeof(rawdata);
+    std::memcpy(&bytes[pos], &size, sizeof(size));
+
+    TBufferFile readbuffer(TBuffer::kRead, bytes.size(), &bytes[0], kFALSE);
+    TEvent readback;
+    REQUIRE_NOTHROW(readback.Streamer(readbuffer));
+
+    REQUIRE(readback.Reconstructed().ID == TID(10));
+    REQUIRE(readback.Reconstructed().DetectorReadHits.size() == 1);
+    CHECK(readback.Reconstructed().DetectorReadHits.front().RawData == TDetectorReadHit::RawData_t({0x1234, 0xabcd}));
+
+    // the current version is read as before
+    TBufferFile readbuffer6(TBuffer::kRead, buffer.Length(), buffer.Buffer(), kFALSE);
+    TEvent readback6;
+    REQUIRE_NOTHROW(readback6.Streamer(readbuffer6));
+    CHECK(readback6.Reconstructed().DetectorReadHits.front().RawData == TDetectorReadHit::RawData_t({0x1234, 0xabcd}));
+}
@@ -0,0 +1,100 @@
+#include "catch.hpp"
+#include "catch_config.h"
+
+#include "detail/UnpackerAcqu_detail.h"
+#include "tree/TDetectorReadHit.h"
+
+#include <vector>
+
+using namespace std;
+using namespace ant;
+using namespace ant::unpacker;
+
+using hit_mapping_t = UnpackerAcquConfig::hit_mapping_t;
+
+void dotest_simple();
+void dotest_mask_multi();
+
+TEST_CASE("Test UnpackerAcqu: hit lookup, simple mappings", "[unpacker]") {
+    dotest_simple();
+}
+
+TEST_CASE("Test UnpackerAcqu: hit lookup, masks and multiple raw channels", "[unpacker]") {
+    dotest_mask_multi();
+}
+
+void dotest_simple() {
+    const vector<hit_mapping_t> mappings{
+        {Detector_t::Type_t::CB, Channel_t::Type_t::Integral, 0, 10},
+        {Detector_t::Type_t::CB, Channel_t::Type_t::Timing,   0, 20},
+        {Detector_t::Type_t::CB, Channel_t::Type_t::Integral, 1, 5},
+        // raw channel 10 can be used twice
+        {Detector_t::Type_t::Trigger, Channel_t::Type_t::Integral, 0, 10},
+    };
+
+    acqu::hit_lookup_t lookup;
+    lookup.Build(mappings);
+    REQUIRE(lookup.Offsets.size() == 22);
+    REQUIRE(lookup.Entries.size() == 4);
+
+    acqu::hit_storage_t storage;
+    storage.add_item(20, 3);
+    storage.add_item(10, 7);
+    storage.add_item(20, 4);
+    storage.add_item(30, 1); // unmapped, and beyond table
+
+    vector<TDetectorReadHit> hits;
+    lookup.Fill(storage, hits);
+
+    // order of raw channels as they appeared in the storage
+    REQUIRE(hits.size() == 3);
+    CHECK(hits[0].ChannelType == Channel_t::Type_t::Timing);
+    CHECK(hits[0].RawData == TDetectorReadHit::RawData_t({3, 4}));
+    CHECK(hits[1].DetectorType == Detector_t::Type_t::CB);
+    CHECK(hits[1].RawData == TDetectorReadHit::RawData_t({7}));
+    CHECK(hits[2].DetectorType == Detector_t::Type_t::Trigger);
+    CHECK(hits[2].RawData == TDetectorReadHit::RawData_t({7}));
+}
+
+void dotest_mask_multi() {
+    vector<hit_mapping_t> mappings{
+        {Detector_t::Type_t::Trigger, Channel_t::Type_t::BitPattern, 0, 1},
+        {Detector_t::Type_t::Trigger, Channel_t::Type_t::BitPattern, 1, 1},
+    };
+    // pattern 0 is the lower byte of raw channel 1
+    mappings[0].RawChannels.front().Mask = 0x00ff;
+    // pattern 1 combines raw channels 1 and 2
+    mappings[1].RawChannels.emplace_back(2);
+
+    acqu::hit_lookup_t lookup;
+    lookup.Build(mappings);
+
+    {
+        acqu::hit_storage_t storage;
+        storage.add_item(2, 0xabcd);
+        storage.add_item(1, 0x1234);
+
+        vector<TDetectorReadHit> hits;
+        lookup.Fill(storage, hits);
+
+        // hit of pattern 1 created once, when raw channel 1 is encountered
+        REQUIRE(hits.size() == 2);
+        CHECK(hits[0].Channel == 0);
+        CHECK(hits[0].RawData == TDetectorReadHit::RawData_t({0x34}));
+        CHECK(hits[1].Channel == 1);
+        CHECK(hits[1].RawData == TDetectorReadHit::RawData_t({0x1234, 0xabcd}));
+    }
+
+    {
+        // only the second raw channel present
+        acqu::hit_storage_t storage;
+        storage.add_item(2, 0xabcd);
+
+        vector<TDetectorReadHit> hits;
+        lookup.Fill(storage, hits);
+
+        REQUIRE(hits.size() == 1);
+        CHECK(hits[0].Channel == 1);
+        CHECK(hits[0].RawData == TDetectorReadHit::RawData_t({0xabcd}));
+    }
+}
@@ -0,0 +1,98 @@
+#include "catch.hpp"
+#include "catch_config.h"
+#include "expconfig_helpers.h"
+
+#include "Unpacker.h"
+#include "UnpackerAcqu.h"
+#include "RawFileReader.h"
+
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
+
+#include "base/tmpfile_t.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace ant;
+
+void dotest(unsigned nParts);
+
+TEST_CASE("Test UnpackerAcqu: Split into 2 parts", "[unpacker]") {
+    dotest(2);
+}
+
+TEST_CASE("Test UnpackerAcqu: Split into 5 parts", "[unpacker]") {
+    dotest(5);
+}
+
+struct event_info_t {
+    TID ID;
+    size_t nDetectorReadHits;
+    size_t nSlowControls;
+    bool operator==(const event_info_t& o) const {
+        return ID == o.ID && nDetectorReadHits == o.nDetectorReadHits && nSlowControls == o.nSlowControls;
+    }
+};
+
+vector<event_info_t> GetEvents(const string& filename, bool inrange_only, size_t& nOutside) {
+    auto unpacker = Unpacker::Get(filename);
+    vector<event_info_t> events;
+    nOutside = 0;
+    while(auto event = unpacker->NextEvent()) {
+        if(!unpacker->InSplitRange()) {
+            nOutside++;
+            if(inrange_only)
+                continue;
+        }
+        const auto& recon = event.Reconstructed();
+        events.push_back({recon.ID, recon.DetectorReadHits.size(), recon.SlowControls.size()});
+    }
+    return events;
+}
+
+void dotest(unsigned nParts) {
+    ant::test::EnsureSetup();
+
+    // splitting needs an uncompressed file
+    tmpfile_t tmpfile;
+    {
+        RawFileReader reader;
+        reader.open(string(TEST_BLOBS_DIRECTORY)+"/Acqu_scalerblock.dat.xz");
+        ofstream outfile(tmpfile.filename, ios::binary);
+        vector<char> buffer(BUFSIZ);
+        while(!reader.eof()) {
+            reader.read(buffer.data(), buffer.size());
+            outfile.write(buffer.data(), reader.gcount());
+        }
+    }
+
+    size_t nOutside = 0;
+    const auto all_events = GetEvents(tmpfile.filename, false, nOutside);
+    REQUIRE(all_events.size() == 211);
+    REQUIRE(nOutside == 0);
+
+    // the parts together must give the same events, in the same order and with the same IDs
+    vector<event_info_t> split_events;
+    size_t nOutsideTotal = 0;
+    for(unsigned part=0;part<nParts;part++) {
+        UnpackerAcqu::Split.Part = part;
+        UnpackerAcqu::Split.NParts = nParts;
+        const auto events = GetEvents(tmpfile.filename, true, nOutside);
+        REQUIRE(nOutside <= all_events.size() - events.size());
+        nOutsideTotal += nOutside;
+        split_events.insert(split_events.end(), events.begin(), events.end());
+    }
+    UnpackerAcqu::Split = UnpackerAcqu::Split_t();
+
+    REQUIRE(split_events == all_events);
+    // events outside the ranges are skipped, except the ones needed for the slowcontrol
+    REQUIRE(nOutsideTotal < (nParts-1)*all_events.size());
+
+    // compressed files cannot be split
+    UnpackerAcqu::Split.NParts = nParts;
+    REQUIRE_THROWS_AS(Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_scalerblock.dat.xz"), UnpackerAcqu::Exception);
+    UnpackerAcqu::Split = UnpackerAcqu::Split_t();
+}